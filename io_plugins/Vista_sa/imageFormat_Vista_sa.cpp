@@ -34,23 +34,23 @@ namespace image_io
 namespace _internal
 {
 	
-	template<typename DURATION> bool fixDateTime(util::PropertyValue &prop, std::initializer_list<std::string> formats){
-		std::tm t = {0,0,0,1,0,70,0,0,-1,0,nullptr};
-		std::istringstream date_time(prop.as<std::string>());
-		for(std::string format:formats){
-// 			date_time.imbue(std::locale("de_DE.utf-8"));
-			date_time >> std::get_time(&t, format.c_str());
-			if(!date_time.fail()){
-				time_t tt = mktime(&t);
-				prop=std::chrono::time_point_cast<DURATION>(std::chrono::system_clock::from_time_t(tt));
-				return true;
-			}
-		}
-		return prop.transform<std::chrono::time_point<std::chrono::system_clock,DURATION>>();
+	// vista stores the birth date as DDMMYY
+	std::optional<util::date> parseBirthDate(std::string_view src){
+		if(src.size()==6) // reorder to YYMMDD which parseDate knows
+			return util::parseDate(std::string(src.substr(4,2))+std::string(src.substr(2,2))+std::string(src.substr(0,2)));
+		else
+			return util::parseDate(src);
+	}
+	template<typename T> bool fixDateTime(util::PropertyValue &prop, std::optional<T> (*parse)(std::string_view)){
+		if(const auto parsed=parse(prop.as<std::string>())){
+			prop=*parsed;
+			return true;
+		} else
+			return false;
 	}
-	template<typename DURATION> bool fixDateTime(util::PropertyMap &map, util::PropertyMap::PropPath path, std::initializer_list<std::string> formats){
+	template<typename T> bool fixDateTime(util::PropertyMap &map, util::PropertyMap::PropPath path, std::optional<T> (*parse)(std::string_view)){
 		auto query=map.queryProperty(path);
-		if(query && fixDateTime<DURATION>(*query,formats)){
+		if(query && fixDateTime(*query,parse)){
 			LOG(Debug,info) << "Parsed " << path << " as " << *query;
 			return true;
 		} else
@@ -181,7 +181,7 @@ void ImageFormat_VistaSa::sanitize( util::PropertyMap &obj )
 			obj.remove("vista/date");
 			obj.remove("vista/time");
 			LOG(Debug,info) << "Parsed sequenceStart from date/time as " << *obj.queryProperty("sequenceStart");
-		} else if(dateQuery && _internal::fixDateTime<util::timestamp::duration>(*dateQuery,{"%H:%M:%S %d %b %Y"})){ //old format (is date actually a weird timestamp) -- eg: 15:09:18 25 Sep 2001
+		} else if(dateQuery && _internal::fixDateTime(*dateQuery,util::parseTimestamp)){ //old format (is date actually a weird timestamp) -- eg: 15:09:18 25 Sep 2001
 			obj.transform<util::timestamp>("vista/date","sequenceStart");
 			LOG(Debug,info) << "Parsed sequenceStart from vista/date as " << *obj.queryProperty("sequenceStart");
 		}else {
@@ -194,7 +194,7 @@ void ImageFormat_VistaSa::sanitize( util::PropertyMap &obj )
 	if ( obj.hasProperty( "vista/age" ) ) {
 		obj.setValueAs( "subjectAge",obj.getValueAs<uint16_t>("vista/age")*365.2425 );
 		obj.remove( "vista/age" );
-	} else if(obj.hasProperty("vista/birth") && _internal::fixDateTime<util::date::duration>(obj,"vista/birth",{"%d%m%y"}) && obj.hasProperty("sequenceStart")){
+	} else if(obj.hasProperty("vista/birth") && _internal::fixDateTime(obj,"vista/birth",_internal::parseBirthDate) && obj.hasProperty("sequenceStart")){
 		const util::date birthdate=obj.getValueAs<util::date>("vista/birth");
 		const util::date measuredate= obj.getValueAs<util::date>("sequenceStart");
 			
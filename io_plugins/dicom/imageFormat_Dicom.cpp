@@ -193,19 +193,22 @@ class DicomChunk : public data::Chunk
 		return ret;
 	}
 public:
-	DicomChunk(data::ValueArray &data, const std::string &transferSyntax, const util::PropertyMap &props)
+	DicomChunk(std::list<data::ValueArray> &img_data, const std::string &transferSyntax, const util::PropertyMap &props)
 	{
 #ifdef HAVE_OPENJPEG
 		if(transferSyntax=="1.2.840.10008.1.2.4.90"){ //JPEG 2K
-			assert(data.getTypeID()==util::typeID<uint8_t>());
-			static_cast<data::Chunk&>(*this)=_internal::getj2k(data::ByteArray(data.castTo<uint8_t>(),data.getLength()));
+			static_cast<data::Chunk&>(*this)=_internal::getj2k(img_data);
 
 			LOG(Runtime,info)
 			    << "Created " << this->getSizeAsString() << "-Image of type " << this->typeName()
-			    << " from a " << data.getLength() << " bytes j2k stream";
+			    << " from " << img_data.size() << " j2k data items";
+			LOG_IF(this->getDimSize(data::sliceDim)!=props.getValueAsOr<size_t>("NumberOfFrames",1),Runtime,warning)
+			    << "Got " << this->getDimSize(data::sliceDim) << " j2k frames, but NumberOfFrames is " << props.getValueAsOr<size_t>("NumberOfFrames",1);
 		} else
 #endif //HAVE_OPENJPEG
 		{
+			LOG_IF(img_data.size()>1,Runtime,error) << "There is more than one image in the source, will only use the first";
+			data::ValueArray &data=img_data.front();
 			static_cast<data::Chunk&>(*this)=getUncompressedPixel(data,props);
 			LOG(Runtime,info)
 			    << "Created " << this->getSizeAsString() << "-Image of type " << this->typeName()
@@ -631,10 +634,14 @@ data::Chunk ImageFormat_Dicom::readMosaic( data::Chunk source )
 		haveAcqTimeList = false;
 	}
 
-	data::Chunk dest = source.cloneToNew( size[0], size[1], size[2] ); //create new 3D chunk of the same type
-	static_cast<util::PropertyMap &>( dest ) = static_cast<const util::PropertyMap &>( source ); //copy _only_ the Properties of source
-	// update origin
-	dest.setValueAs( "indexOrigin", origin );
+	// the frames of a multi-frame mosaic become volumes
+	const size_t frames = tSize[2] * tSize[3];
+	// every voxel is written below, so there is no need to zero the memory
+	data::ValueArray voxels = source.visit( [&]( auto ptr ) {
+		return data::ValueArray::makeUninitialized<typename decltype( ptr )::element_type>( size.product() * frames );
+	} );
+	data::Chunk dest( voxels, size[0], size[1], size[2], frames );
+	static_cast<util::PropertyMap &>( dest ) = std::move( static_cast<util::PropertyMap &>( source ) ); //take _only_ the Properties of source (including the corrected origin), we own it anyway
 
 	// update fov
 	if ( dest.hasProperty( "fov" ) ) {
@@ -644,30 +651,55 @@ data::Chunk ImageFormat_Dicom::readMosaic( data::Chunk source )
 		ref[2] = voxelSize[2] * float(images) + voxelGap[2] * float( images - 1 );
 	}
 
-	// for every slice add acqTime to Multivalue
+	// one pass over the rows of each mosaic, scattering the lines of the tiles into their slices (frames are done in parallel)
+	const size_t bytes = source.bytesPerElem(), line_bytes = size[0] * bytes, mosaic_line_bytes = tSize[0] * bytes;
+	const size_t tile_rows = ( images + matrixSize - 1 ) / matrixSize;
+	const std::shared_ptr<const void> src_ptr = source.getRawAddress();
+	const std::shared_ptr<void> dst_ptr = voxels.getRawAddress();
 
+	util::parallelFor( frames, [&]( size_t begin, size_t end ) {
+		for( size_t frame = begin; frame < end; frame++ ) {
+			const uint8_t *const mosaic = static_cast<const uint8_t *>( src_ptr.get() ) + frame * tSize[0] * tSize[1] * bytes;
+			uint8_t *const volume = static_cast<uint8_t *>( dst_ptr.get() ) + frame * size.product() * bytes;
+
+			for( size_t mosaic_line = 0; mosaic_line < tile_rows * size[1]; mosaic_line++ ) {
+				const size_t row = mosaic_line / size[1], line = mosaic_line % size[1]; //row of the mosaic, and line in that row
+				const uint8_t *src = mosaic + mosaic_line * mosaic_line_bytes;
+
+				for( size_t slice = row * matrixSize; slice < std::min<size_t>( ( row + 1 ) * matrixSize, images ); slice++, src += line_bytes )
+					memcpy( volume + ( slice * size[1] + line ) * line_bytes, src, line_bytes );
+			}
+		}
+	} );
+
+	// for every slice (of every frame) add acqTime to Multivalue
 	auto acqTimeQuery= dest.queryProperty( "acquisitionTime");
-	if(acqTimeQuery && haveAcqTimeList)
+	if(acqTimeQuery && haveAcqTimeList){
 		*acqTimeQuery=util::PropertyValue(); //reset the selected ordering property to empty
 
-	for ( size_t slice = 0; slice < images; slice++ ) {
-		// copy the lines into the corresponding slice in the chunk
-		for ( size_t line = 0; line < size[1]; line++ ) {
-			const std::array<size_t,4> dpos = {0, line, slice, 0}; //begin of the target line
-			const size_t column = slice % matrixSize; //column of the mosaic
-			const size_t row = slice / matrixSize; //row of the mosaic
-			const std::array<size_t,4> sstart{column *size[0], row *size[1] + line, 0, 0}; //begin of the source line
-			const std::array<size_t,4> send{sstart[0] + size[0] - 1, row *size[1] + line, 0, 0}; //end of the source line
-			source.copyRange( sstart, send, dest, dpos );
+		// the frames are consecutive volumes, so they are one frame time (or repetition time) apart
+		util::duration frameTime(0);
+		if(frames>1){
+			for(const char *name:{"FrameTime","SharedFunctionalGroupsSequence/MRTimingAndRelatedParametersSequence/RepetitionTime","RepetitionTime"}){
+				if(dest.hasProperty(prefix+name)){
+					frameTime=std::chrono::duration_cast<util::duration>(std::chrono::duration<double,std::milli>(dest.getValueAs<double>(prefix+name)));
+					break;
+				}
+			}
+			LOG_IF(frameTime==util::duration(0),Runtime,warning)
+				<< "Neither the frame time nor the repetition time of the multi-frame mosaic is known, its " << frames << " frames get the same acquisition times";
 		}
 
-		if(acqTimeQuery && haveAcqTimeList){
-			auto newtime=acqTime +  std::chrono::milliseconds((std::chrono::milliseconds::rep)* ( acqTimeIt ) );
-			acqTimeQuery->push_back(newtime);
-			LOG(Debug,verbose_info)
-			    << "Computed acquisitionTime for slice " << slice << " as " << newtime
-			    << "(" << acqTime << "+" <<  std::chrono::milliseconds((std::chrono::milliseconds::rep)* ( acqTimeIt ) );
-			++acqTimeIt;
+		for ( size_t frame = 0; frame < frames; frame++ ) {
+			acqTimeIt = acqTimeList.begin();
+			for ( size_t slice = 0; slice < images; slice++ ) {
+				auto newtime=acqTime + frameTime*util::duration::rep( frame ) + std::chrono::milliseconds((std::chrono::milliseconds::rep)* ( acqTimeIt ) );
+				acqTimeQuery->push_back(newtime);
+				LOG(Debug,verbose_info)
+				    << "Computed acquisitionTime for slice " << slice << " of frame " << frame << " as " << newtime
+				    << "(" << acqTime << "+" << frameTime*util::duration::rep( frame ) << "+" <<  std::chrono::milliseconds((std::chrono::milliseconds::rep)* ( acqTimeIt ) );
+				++acqTimeIt;
+			}
 		}
 	}
 
@@ -760,9 +792,8 @@ std::list< data::Chunk > ImageFormat_Dicom::load(data::ByteArray source, std::li
 	if(img_data.empty()){
 		throwGenericError("No image data found");
 	} else {
-		LOG_IF(img_data.size()>1,Runtime,error) << "There is more than one image in the source, will only use the first";
 		//we got a chunk from the file
-		std::list<data::Chunk> chunks = {data::Chunk(_internal::DicomChunk(img_data.front(),transferSyntax,props))};
+		std::list<data::Chunk> chunks = {data::Chunk(_internal::DicomChunk(img_data,transferSyntax,props))};
 
 		//handle philips scaling
 		data::scaling_pair philps_scale(1,0);
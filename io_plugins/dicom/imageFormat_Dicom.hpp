@@ -31,7 +31,12 @@ util::istring id2Name( const uint16_t group, const uint16_t element );
 util::istring id2Name( const uint32_t id32 );
 
 #ifdef HAVE_OPENJPEG
-data::Chunk getj2k(data::ByteArray bytes);
+/**
+ * Decode the j2k frames of encapsulated pixel data into one chunk (with one slice per frame).
+ * The frames are decoded in parallel (with openjpeg using the threads that are left over for each of them).
+ * \param items the data items of the pixel data (an offset table in front and frames split into fragments are handled)
+ */
+data::Chunk getj2k(const std::list<data::ValueArray> &items);
 #endif //HAVE_OPENJPEG
 
 template <boost::endian::order Order> struct Tag{
@@ -115,7 +120,6 @@ class ImageFormat_Dicom: public FileFormat
 	static size_t parseCSAEntry( const uint8_t *at, size_t data_len, isis::util::PropertyMap &map, std::list<util::istring> dialects );
 	static bool parseCSAValue( const std::string &val, const util::PropertyMap::PropPath &name, const util::istring &vr, isis::util::PropertyMap &map );
 	static bool parseCSAValueList( const isis::util::slist &val, const util::PropertyMap::PropPath &name, const util::istring &vr, isis::util::PropertyMap &map );
-	static data::Chunk readMosaic( data::Chunk source );
 protected:
 	[[nodiscard]] std::list<util::istring> suffixes(io_modes modes )const override;
 public:
@@ -123,6 +127,12 @@ public:
 	static const char dicomTagTreeName[];
 	static const char unknownTagName[];
 	static void parseCSA(const data::ByteArray &data, isis::util::PropertyMap &map, std::list<util::istring> dialects );
+	/**
+	 * Decompose a siemens mosaic into a volume (or into volumes if there are multiple frames).
+	 * The slices in the tiles of the mosaic are put into one 3D (or 4D) chunk which gets the properties of the source with
+	 * geometry, image type and acquisition times adapted accordingly.
+	 */
+	static data::Chunk readMosaic( data::Chunk source );
 	static void sanitise( util::PropertyMap &object, const std::list<util::istring>& dialect );
 	static void santitse_geometry( util::PropertyMap &object );
 	[[nodiscard]] std::string getName()const override;
@@ -1,4 +1,5 @@
 #include "imageFormat_Dicom.hpp"
+#include <isis/core/common.hpp>
 #include <openjpeg.h>
 #include <thread>
 
@@ -61,20 +62,21 @@ OPJ_BOOL opj_stream_seek_mem(OPJ_OFF_T p_nb_bytes, void * p_user_data){
 	return reinterpret_cast<ByteStream*>(p_user_data)->seek(p_nb_bytes);
 }
 
-data::Chunk getj2k(data::ByteArray bytes){
+struct stream_delete{
+	void operator()(opj_stream_t *p){opj_stream_destroy(p);}
+};
+struct codec_delete{
+	void operator()(opj_codec_t *p){opj_destroy_codec(p);}
+};
+struct image_delete{
+	void operator()(opj_image_t *p){opj_image_destroy(p);}
+};
+typedef std::unique_ptr<opj_image_t,image_delete> image_ptr;
+
+image_ptr decode(const data::ByteArray &bytes, int threads){
 	// set up stream
 	_internal::ByteStream stream(bytes);
 
-	struct stream_delete{
-		void operator()(opj_stream_t *p){opj_stream_destroy(p);}
-	};
-	struct codec_delete{
-		void operator()(opj_codec_t *p){opj_destroy_codec(p);}
-	};
-	struct image_delete{
-		void operator()(opj_image_t *p){opj_image_destroy(p);}
-	};
-
 	std::unique_ptr<opj_stream_t,stream_delete> l_stream(opj_stream_default_create(true));
 	opj_stream_set_user_data(l_stream.get(),&stream,nullptr);
 	opj_stream_set_user_data_length(l_stream.get(),bytes.getLength());
@@ -85,9 +87,8 @@ data::Chunk getj2k(data::ByteArray bytes){
 	opj_set_warning_handler(l_codec.get(), jp2_warn, 00);
 	opj_set_error_handler(l_codec.get(), jp2_err, 00);
 	
-	const int threads=std::thread::hardware_concurrency();
-	if(threads)
-		opj_codec_set_threads(l_codec.get(), std::min(threads,4));
+	if(threads>1)
+		opj_codec_set_threads(l_codec.get(), threads);
 
 	opj_stream_set_read_function(l_stream.get(), opj_stream_read_mem);
 	opj_stream_set_skip_function(l_stream.get(), opj_stream_skip_mem);
@@ -104,7 +105,7 @@ data::Chunk getj2k(data::ByteArray bytes){
 	}
 
 	opj_image_t* pimage = NULL;
-	std::unique_ptr<opj_image_t> image;
+	image_ptr image;
 	/* Read the main header of the codestream and if necessary the JP2 boxes*/
 	if (! opj_read_header(l_stream.get(), l_codec.get(), &pimage)) {
 		opj_image_destroy(pimage);
@@ -115,25 +116,80 @@ data::Chunk getj2k(data::ByteArray bytes){
 	if (!(opj_decode(l_codec.get(), l_stream.get(), image.get()) && opj_end_decompress(l_codec.get(),   l_stream.get()))) {
 		FileFormat::throwGenericError("failed to decode the j2k image!\n");
 	}
+	if(image->numcomps!=1)
+		FileFormat::throwGenericError("Only grayscale j2k data supportet");
 	if (image->comps[0].data == NULL) {
 		FileFormat::throwGenericError("no j2k image data!");
 	}
-	if (image->color_space != OPJ_CLRSPC_SYCC
-			&& image->numcomps == 3 && image->comps[0].dx == image->comps[0].dy
-			&& image->comps[1].dx != 1) {
-		image->color_space = OPJ_CLRSPC_SYCC;
-	} else if (image->numcomps <= 2) {
-		image->color_space = OPJ_CLRSPC_GRAY;
+	return image;
+}
+
+// the items of encapsulated pixel data are an (optional) basic offset table followed by the frames, which may be split into fragments
+std::vector<data::ByteArray> getFrames(const std::list<data::ValueArray> &items){
+	std::vector<data::ByteArray> ret;
+	for(const data::ValueArray &item:items){
+		const data::ByteArray bytes(std::const_pointer_cast<uint8_t>(std::static_pointer_cast<const uint8_t>(item.getRawAddress())),item.getLength()*item.bytesPerElem());
+		const bool codestream = bytes.getLength()>=4 && bytes[0]==0xFF && bytes[1]==0x4F && bytes[2]==0xFF && bytes[3]==0x51; // SOC and SIZ marker
+
+		if(codestream){
+			ret.push_back(bytes);
+		} else if(!ret.empty()){ // continuation of the current frame
+			data::ByteArray joined(ret.back().getLength()+bytes.getLength());
+			memcpy(joined.begin(),ret.back().begin(),ret.back().getLength());
+			memcpy(joined.begin()+ret.back().getLength(),bytes.begin(),bytes.getLength());
+			ret.back()=joined;
+		} else
+			LOG(Debug,info) << "Ignoring " << bytes.getLength() << " bytes of data (probably the offset table) in front of the first j2k frame";
 	}
-	
-	if(image->numcomps!=1)
-		FileFormat::throwGenericError("Only grayscale j2k data supportet");
+	return ret;
+}
 
-	
-	if(image->comps[0].prec>8){
-		return data::MemChunk<uint16_t>(image->comps[0].data, image->comps[0].w,image->comps[0].h);
-	} else {
-		return data::MemChunk<uint8_t>(image->comps[0].data, image->comps[0].w,image->comps[0].h);
-	} 
+// there is no way to make openjpeg decode into our memory, so this converts the decoded plane into its place in the destination
+template<typename T> void store(const opj_image_t &image, data::ValueArray &voxels, size_t frame){
+	const opj_image_comp_t &comp = image.comps[0];
+	const size_t pixels=size_t(comp.w)*comp.h;
+	std::copy(comp.data,comp.data+pixels,voxels.beginTyped<T>()+frame*pixels);
+}
+// every voxel gets written, so the destination does not need to be zeroed
+template<typename T> void storeAs(data::ValueArray &voxels, size_t length, void (*&op)(const opj_image_t &, data::ValueArray &, size_t)){
+	voxels=data::ValueArray::makeUninitialized<T>(length);
+	op=store<T>;
+}
+
+data::Chunk getj2k(const std::list<data::ValueArray> &items){
+	const std::vector<data::ByteArray> frames=getFrames(items);
+	if(frames.empty())
+		FileFormat::throwGenericError("no j2k frames found");
+
+	// the frames are decoded in parallel, the threads left over go to openjpeg (which decodes the code blocks of a frame in parallel)
+	const size_t threads=std::max(1u,std::thread::hardware_concurrency());
+	const int codec_threads=frames.size()>1 ? threads/std::min(frames.size()-1,threads) : threads;
+
+	// the first frame tells us size and type of the data, so the others can go straight into their place
+	const image_ptr first=decode(frames.front(),threads);
+	const opj_image_comp_t comp=first->comps[0];
+	const size_t length=size_t(comp.w)*comp.h*frames.size();
+
+	data::ValueArray voxels;
+	void (*store_frame)(const opj_image_t &, data::ValueArray &, size_t);
+	if(comp.prec>16)
+		comp.sgnd ? storeAs<int32_t>(voxels,length,store_frame):storeAs<uint32_t>(voxels,length,store_frame);
+	else if(comp.prec>8)
+		comp.sgnd ? storeAs<int16_t>(voxels,length,store_frame):storeAs<uint16_t>(voxels,length,store_frame);
+	else
+		comp.sgnd ? storeAs<int8_t>(voxels,length,store_frame):storeAs<uint8_t>(voxels,length,store_frame);
+	store_frame(*first,voxels,0);
+
+	util::parallelFor(frames.size()-1,[&](size_t begin, size_t end){
+		for(size_t frame=begin+1;frame<end+1;frame++){
+			const image_ptr image=decode(frames[frame],codec_threads);
+			const opj_image_comp_t &c=image->comps[0];
+			if(c.w!=comp.w || c.h!=comp.h || c.prec!=comp.prec || c.sgnd!=comp.sgnd)
+				FileFormat::throwGenericError("j2k frame "+std::to_string(frame)+" differs in size or type from the first frame");
+			store_frame(*image,voxels,frame);
+		}
+	});
+
+	return data::Chunk(voxels,comp.w,comp.h,frames.size());
 }
 }}}
@@ -372,6 +372,19 @@ namespace _internal{
 		}
 		return std::optional<util::Value>();
 	}
+	std::optional<util::Value> parse_TM(const _internal::DicomElement *e){
+		auto tm=string_generate(e);
+		if(!tm)
+			return tm;
+
+		// parseTimestamp doesn't take the short forms "HH" and "HHMM" on their own (they might as well be years), in a TM they are times
+		if(tm->typeID()==util::typeID<std::string>()){
+			std::string &buff=std::get<std::string>(*tm);
+			if((buff.size()==2 || buff.size()==4) && std::all_of(buff.begin(),buff.end(),[](char c){return std::isdigit(static_cast<unsigned char>(c));}))
+				buff.append(6-buff.size(),'0');
+		}
+		return tm->copyByID(util::typeID<util::timestamp>());
+	}
 	std::optional<util::Value> parse_AS(const _internal::DicomElement *e){
 		std::optional<util::Value> ret;
 		uint16_t duration = 0;
@@ -446,7 +459,7 @@ namespace _internal{
 			string_generate,
 			8}
 		},
-	    {"TM",{[](const _internal::DicomElement *e){auto prop=string_generate(e); return prop?std::make_optional(prop->copyByID(util::typeID<util::timestamp>())):prop;},nullptr,0}},
+	    {"TM",{parse_TM,nullptr,0}},
 	    {"DT",{[](const _internal::DicomElement *e){auto prop=string_generate(e); return prop?std::make_optional(prop->copyByID(util::typeID<util::timestamp>())):prop;},nullptr,0}},
 	    {"AS",{parse_AS,nullptr,0}},
 		{"AT",{tag_generate, nullptr,2*sizeof(uint16_t)}},
@@ -80,6 +80,7 @@ public:
 		return "Null";
 	}
 
+	bool readsFiles()const override {return true;} // there is no actual file, the data is generated
 	std::list<data::Chunk>
 	load( const std::filesystem::path &filename, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback ) override  {
 
@@ -177,6 +177,10 @@ data::Chunk ImageFormat_ZISRAW::SubBlock::jxrRead(size_t xsize,size_t ysize,isis
 	return data::Chunk(buffer.atByID(isis_type,0,xsize*ysize),xsize,ysize,1,1,true);
 }
 
+void ImageFormat_ZISRAW::SubBlock::prefetch()const{
+	image_data.prefetch();
+}
+
 std::function<data::Chunk()> ImageFormat_ZISRAW::SubBlock::getChunkGenerator()const{
 	unsigned short isis_type,pixel_size;
 
@@ -258,7 +262,12 @@ data::Chunk ImageFormat_ZISRAW::transferFromMosaic(std::list<SubBlock> segments,
 	int32_t zoffset=-boundaries["Z"].min;
 
 	std::list<std::thread> jobs;
-	for(SubBlock &s:segments){
+	segments.front().prefetch();
+	for(auto s_it=segments.begin();s_it!=segments.end();s_it++){
+		SubBlock &s=*s_it;
+		if(std::next(s_it)!=segments.end()) // the blocks are scattered over the file, start reading the next one while this one is decoded
+			std::next(s_it)->prefetch();
+
 		auto dims = s.getDimsInfo();
 		const auto &X = dims['X'], &Y = dims['Y'], &Z=dims['Z'];;
 		const int xscale = X.StoredSize ? X.size / X.StoredSize : 1;
@@ -379,6 +388,8 @@ std::list<data::Chunk> ImageFormat_ZISRAW::load(
 	//generate planes
 	if(header.DirectoryPosition){
 		Directory directory(source,header.DirectoryPosition);
+		// the sub blocks are scattered over the file, so readahead is useless (transferFromMosaic prefetches what it needs)
+		source.advise(data::ByteArray::Access::random);
 
 		struct bounds{
 			int32_t min=std::numeric_limits<int32_t>::max(),max=std::numeric_limits<int32_t>::min();
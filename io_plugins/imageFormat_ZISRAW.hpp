@@ -106,6 +106,8 @@ class ImageFormat_ZISRAW : public FileFormat{
 		[[nodiscard]] std::string getPlaneID()const;
 		[[nodiscard]] std::map< char, _internal::DimensionEntry > getDimsInfo()const;
 		[[nodiscard]] std::array<int32_t,4> getSize()const;
+		/// start reading the image data in the background (see data::ByteArray::prefetch)
+		void prefetch()const;
 	};
 	class Directory:public Segment{
 	public:
@@ -89,15 +89,26 @@ public:
 	[[nodiscard]] std::string getName()const override {return "(de)compression proxy for other formats";}
 
 	std::list<data::Chunk> load ( std::streambuf *source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> progress ) override {
+		std::list<data::Chunk> ret;
+		loadInto( source, std::move( formatstack ), std::move( dialects ), std::move( progress ), [&ret]( data::Chunk &&ch ) {ret.push_back( std::move( ch ) );} );
+		return ret;
+	}
+	std::list<data::Chunk> load( const std::filesystem::path &filename, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback ) override{
+		std::list<data::Chunk> ret;
+		loadInto( filename, std::move( formatstack ), std::move( dialects ), std::move( feedback ), [&ret]( data::Chunk &&ch ) {ret.push_back( std::move( ch ) );} );
+		return ret;
+	}
+	using FileFormat::loadInto;
+	void loadInto( std::streambuf *source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> /*progress*/, const chunk_sink &sink ) override {
 		
 		auto in=makeIStream(formatstack);
 
 		//ok, we have a filter, use that with the source stream on top
 		in->push( *source );
 
-		return data::IOFactory::loadChunks( in->rdbuf(), formatstack, dialects );
+		data::IOFactory::loadChunksInto( in->rdbuf(), sink, formatstack, dialects );
 	}
-	std::list<data::Chunk> load( const std::filesystem::path &filename, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback ) override{
+	void loadInto( const std::filesystem::path &filename, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback, const chunk_sink &sink ) override{
 		//try open file
 		std::ifstream file(filename);
 		file.exceptions(std::ios_base::badbit);
@@ -114,11 +125,10 @@ public:
 			in->push( _internal::progress_filter( *feedback ) );
 
 		in->push(file);
-		std::list<data::Chunk> ret=data::IOFactory::loadChunks( in->rdbuf(), formatstack, dialects );
+		data::IOFactory::loadChunksInto( in->rdbuf(), sink, formatstack, dialects );
 		
 		if(set_up) // close progress bar
 			feedback->close();
-		return ret;
 	}
 
 	void write( const data::Image &image, const std::string &filename, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> progress ) override {
@@ -1,4 +1,5 @@
 #include <isis/core/fileptr.hpp>
+#include <isis/core/bitarray.hpp>
 #include "imageFormat_nifti_sa.hpp"
 #include "imageFormat_nifti_dcmstack.hpp"
 #include <isis/math/transform.hpp>
@@ -171,30 +172,26 @@ public:
 	BitWriteOp( const data::Image &image ): WriteOp( image, 1 ) {}
 
 	bool doCopy(const data::Chunk &src, util::vector4<size_t> posInImage )override {
-		auto in_data = src.as<bool>();
 		const size_t offset = m_voxelstart + getLinearIndex( posInImage ) * m_bpv / 8;
 
-		//the length parameter actually expets elements and then computes the bytes internally
-		//but that computing will fail for bool so we ask for 8bit / 1byte type and give the needed bytes instead of elements
-		//also the writing below works with uint8 anyway
-		auto out_data = m_out.at<uint8_t>( offset, in_data.getLength() / 8 );
-		memset( &out_data[0], 0, out_data.getLength() );
-
-		for( size_t i = 0; i < in_data.getLength(); i++ ) {
-			const size_t byte = i / 8;
-			const uint8_t mask = 128 >> ( i % 8 );
-
-			if( in_data.at<bool>(i) ) {
-				out_data[byte] |= mask;
-			}
-		}
-
+		// pack the voxels directly into the output
+		data::BitArray out_data( m_out.at<uint8_t>( offset, ( src.getVolume() + 7 ) / 8 ), src.getVolume() );
+		out_data.pack( src );
 		return true;
 	}
 
 	short unsigned int getTypeId()override {return util::typeID<bool>();}
 };
 
+/// the scaling given by scl_slope and scl_inter (not relevant if there is none)
+data::scaling_pair headerScaling( const nifti_1_header &head )
+{
+	if( ( head.scl_slope != 0 && head.scl_slope != 1 ) || head.scl_inter != 0 )
+		return data::scaling_pair( head.scl_slope, head.scl_inter );
+	else
+		return data::scaling_pair();
+}
+
 }
 
 ImageFormat_NiftiSa::ImageFormat_NiftiSa()
@@ -408,20 +405,13 @@ bool ImageFormat_NiftiSa::parseDescripForSPM( isis::util::PropertyMap &props, co
 		props.setValueAs( "echoTime", std::stoi( results.str( 2 ) ) );
 		props.setValueAs( "flipAngle", std::stoi( results.str( 3 ) ) );
 
-		tm t={
-			std::stoi(results.str( 9 )), //tm_sec
-			std::stoi(results.str( 8 )), //tm_min
-			std::stoi(results.str( 7 )), //tm_hour
-			std::stoi(results.str( 4 )), // tm_mday
-			std::stoi(results.str( 5 ))-1, // tm_mon [0, 11] 
-			std::stoi(results.str( 6 ))-1900, // tm_year years since 1900
-			0,0,-1,0,                           // tm_wday, tm_yday, tm_isdst
-			nullptr
-		};
-
-		util::timestamp sequenceStart = std::chrono::time_point_cast<util::timestamp::duration>(std::chrono::system_clock::from_time_t(mktime(&t)));
+		// the month is a name, so let parseTimestamp do the work (rearranged to "HH:MM:SS DD Mon YYYY")
+		const std::optional<util::timestamp> sequenceStart = util::parseTimestamp(
+			results.str( 7 ) + ":" + results.str( 8 ) + ":" + results.str( 9 ) + " " + results.str( 4 ) + " " + results.str( 5 ) + " " + results.str( 6 )
+		);
 
-		props.setValueAs<util::timestamp>( "sequenceStart", sequenceStart );
+		if( sequenceStart )
+			props.setValueAs<util::timestamp>( "sequenceStart", *sequenceStart );
 
 		LOG( Runtime, info ) << "Using Tr=" << props.queryProperty( "repetitionTime" ) << ", Te=" << props.queryProperty( "echoTime" )
 							 << ", flipAngle=" << props.queryProperty( "flipAngle" ) << " and sequenceStart=" << props.queryProperty( "sequenceStart" )
@@ -620,8 +610,7 @@ void ImageFormat_NiftiSa::parseHeader( const std::shared_ptr< isis::image_io::_i
 	}
 
 	// TODO: at the moment scaling is not supported due to data type changes
-	if( ( head->scl_slope !=0 && head->scl_slope != 1) || head->scl_inter != 0)
-		scl=data::scaling_pair(head->scl_slope,head->scl_inter);
+	scl = _internal::headerScaling( *head );
 
 	if( head->intent_code && head->intent_code!= 1007) {
 		props.setValueAs( "nifti/intent_code", head->intent_code ); // use it the usual way
@@ -648,15 +637,7 @@ isis::data::TypedArray< bool > ImageFormat_NiftiSa::bitRead( data::TypedArray<ui
 		throwGenericError( err );
 	}
 
-	isis::data::TypedArray< bool > ret( size );
-
-	for( size_t i = 0; i < size; i++ ) {
-		const size_t byte = i / 8;
-		const uint8_t mask = 128 >> ( i % 8 );
-		ret[i] = mask & src[byte];
-	}
-
-	return ret;
+	return data::BitArray( src, size ).unpack<bool>();
 }
 
 bool ImageFormat_NiftiSa::checkSwapEndian ( std::shared_ptr< isis::image_io::_internal::nifti_1_header > header )
@@ -721,6 +702,9 @@ std::list< data::Chunk > ImageFormat_NiftiSa::load(
 	std::shared_ptr<util::ProgressFeedback> /*feedback*/ 
 ) {
 
+	if( source.getLength() < sizeof( _internal::nifti_1_header ) )
+		throwGenericError( "file is too short for a nifti header (" + std::to_string( source.getLength() ) + " bytes)" );
+
 	//get the header - we use it directly from the file
 	std::shared_ptr< _internal::nifti_1_header > header = std::static_pointer_cast<_internal::nifti_1_header>( source.getRawAddress() );
 	const bool swap_endian = checkSwapEndian( header );
@@ -740,6 +724,9 @@ std::list< data::Chunk > ImageFormat_NiftiSa::load(
 		header->slice_duration = 0;
 	}
 
+	// the voxel data is going to be read front to back (here if it has to be copied, otherwise by whoever uses the image)
+	source.advise( data::ByteArray::Access::sequential, header->vox_offset );
+
 
 	//set up the size - copy dim[0] values from dim[1]..dim[5]
 	util::vector4<size_t> size;
@@ -759,6 +746,7 @@ std::list< data::Chunk > ImageFormat_NiftiSa::load(
 
 	std::copy(header->dim + 1, header->dim + 1 + 4, std::begin(size) );
 	data::ValueArray data_src;
+	bool scaled = false; // the scaling of the header was applied while reading
 
 	if( header->datatype == NIFTI_TYPE_BINARY ) { // image is binary encoded - needs special decoding
 		data_src = bitRead( source.at<uint8_t>( header->vox_offset ), size.product() );
@@ -808,19 +796,26 @@ std::list< data::Chunk > ImageFormat_NiftiSa::load(
 		}
 
 			if( type ) {
-			data_src = source.atByID( type, header->vox_offset, size.product(), swap_endian );
+			const data::scaling_pair scl = _internal::headerScaling( *header );
+			data_src = source.atByID( type, header->vox_offset, size.product() ); // a view of the stored data
 
-			if( swap_endian ) {
+			LOG_IF( ( size_t )header->bitpix != data_src.bytesPerElem() * 8 / bitpix_scale, Runtime, warning )
+					<< "nifti field bitpix does not fit the bytesize of the given datatype (" << data_src.typeName() + "/" + std::to_string(header->bitpix) <<  ")";
+
+			if( scl.isRelevant() && ( data_src.isFloat() || data_src.isInteger() ) ) {
+				// the result will be a new array of doubles anyway, so swap, scale and convert in one pass
+				LOG( Runtime, info ) << "Reading nifti image of " << data_src.typeName() << ( swap_endian ? " (endianess swapped)" : "" )
+									 << " as double applying the scaling " << scl << " from the header";
+				data_src = source.convertByID( type, util::typeID<double>(), header->vox_offset, size.product(), swap_endian, scl );
+				scaled = true;
+			} else if( swap_endian ) {
+				data_src = source.atByID( type, header->vox_offset, size.product(), swap_endian );
 				LOG( Runtime, info ) << "Opened nifti image as endianess swapped " << data_src.typeName() << " of " << data_src.getLength()
 									 << " elements (" << std::to_string(data_src.bytesPerElem()*data_src.getLength()*( 1. / 0x100000 ))+"M" <<")";
 			} else {
 				LOG( Runtime, info ) << "Mapped nifti image natively as " << data_src.typeName() << " of " << data_src.getLength()
 				                     << " elements (" << std::to_string(data_src.bytesPerElem()*data_src.getLength()*( 1. / 0x100000 ))+"M" <<")";
 			}
-
-			LOG_IF( ( size_t )header->bitpix != data_src.bytesPerElem() * 8 / bitpix_scale, Runtime, warning )
-					<< "nifti field bitpix does not fit the bytesize of the given datatype (" << data_src.typeName() + "/" + std::to_string(header->bitpix) <<  ")";
-
 		} else {
 			LOG( Runtime, error ) << "Sorry, the nifti datatype " << header->datatype << " is not (yet) supported";
 			throwGenericError( "unsupported datatype" );
@@ -868,7 +863,7 @@ std::list< data::Chunk > ImageFormat_NiftiSa::load(
 	data::scaling_pair scl;
 	parseHeader( header, orig, scl );
 	
-	if(scl.isRelevant()){
+	if(scl.isRelevant() && !scaled){
 		LOG(Runtime,info) << "Applying scaling " << scl << " from the nifti header, result will be in double";
 		orig.convertToType(util::typeID<double>(),scl);
 	}
@@ -220,6 +220,7 @@ public:
 		fclose( fp );
 		return ret;
 	}
+	bool readsFiles()const override {return true;} // libpng reads the file
 	std::list<data::Chunk> load(const std::filesystem::path &filename, std::list<util::istring> /*formatstack*/, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> /*feedback*/) override
 	{
 		data::Chunk ch = read_png( filename );
@@ -3,6 +3,9 @@
 #include <isis/core/io_factory.hpp>
 
 #include <filesystem>
+#include <future>
+#include <thread>
+#include <cstring>
 
 #include <boost/iostreams/read.hpp>
 
@@ -12,7 +15,7 @@ namespace isis::image_io
 {
 
 class ImageFormat_Tar: public FileFormat{
-	struct {
+	struct Header{
 		char name[100];
 		char mode[8];
 		char uid[8];
@@ -31,28 +34,82 @@ class ImageFormat_Tar: public FileFormat{
 		char prefix[155];
 		char padding[12];
 	} tar_header;
-	
-	bool read_header( const std::basic_istream<char> &src, size_t &size, size_t &next_header_in ) {
-		if( boost::iostreams::read( src, reinterpret_cast<char *>( &tar_header ), 512 ) == 512 ) {
-			if( tar_header.size[0] & 0x80 ) { // its base-256
-				size = 0;
+	static_assert(sizeof(Header)==512);
 
-				for( uint_fast8_t i = 4; i < 11; i++ ) {
-					size |= reinterpret_cast<uint8_t *>( tar_header.size )[i];
-					size = size << 8;
-				}
+	/// member of a tar archive which is available in memory
+	struct Member{
+		std::filesystem::path name;
+		size_t offset,size;
+	};
+
+	/// get the size of the member described by the header, \returns false if the header is empty (end of archive)
+	static bool parse_size( const Header &header, size_t &size ){
+		if( header.size[0] & 0x80 ) { // its base-256
+			size = 0;
+
+			for( uint_fast8_t i = 4; i < 11; i++ ) {
+				size |= reinterpret_cast<const uint8_t *>( header.size )[i];
+				size = size << 8;
+			}
+
+			size |= reinterpret_cast<const uint8_t *>( header.size )[11];
+		} else if( header.size[10] != 0 ) { //normal octal
+			size = std::strtoull( std::string( header.size, 12 ).c_str(), nullptr, 8 );
+		} else
+			return false;
+		return true;
+	}
+	/// size of the member data including the padding up to the next header
+	static size_t padded( size_t size ){
+		return ( size / 512 ) * 512 + ( size % 512 ? 512 : 0 );
+	}
+	/// get the original filename (these fields are not \0-terminated)
+	static std::filesystem::path member_name( const Header &header ){
+		return std::filesystem::path( 
+			std::string( header.prefix, strnlen( header.prefix, sizeof( header.prefix ) ) ) + 
+			std::string( header.name, strnlen( header.name, sizeof( header.name ) ) ) 
+		);
+	}
 
-				size |= reinterpret_cast<uint8_t *>( tar_header.size )[11];
-			} else if( tar_header.size[10] != 0 ) { //normal octal
-				//get the size @todo use strtoll
-				std::stringstream buff( tar_header.size );
-				size = 0, next_header_in = 0;
+	/// collect all regular files of a tar archive in memory
+	static std::vector<Member> index( const data::ByteArray &source ){
+		std::vector<Member> ret;
+		const uint8_t *const start=source.begin();
+		const size_t length=source.getLength();
+		std::filesystem::path long_name;
 
-				buff >> std::oct >> size;
-			} else
-				return false;
+		for(size_t pos=0;pos+512<=length;){
+			const Header &header=*reinterpret_cast<const Header*>(start+pos);
+			size_t size;
+			if(!parse_size(header,size))
+				break;
+			pos+=512;
 
-			next_header_in = ( size / 512 ) * 512 + ( size % 512 ? 512 : 0 );
+			if(pos+size>length){
+				LOG( Runtime, warning ) << "The tar archive is truncated, " << member_name( header ) << " is missing " << pos+size-length << " bytes";
+				size=length-pos;
+			}
+
+			if( header.typeflag == 'L' ) { // the filename of the next file is to long - so its stored in the next block (following this header)
+				const char *name=reinterpret_cast<const char*>(start+pos);
+				long_name = std::string( name, strnlen( name, size ) );
+				LOG( Debug, verbose_info ) << "Got overlong name " << util::MSubject( long_name ) << " for next file.";
+			} else {
+				std::filesystem::path name=long_name.empty() ? member_name( header ) : long_name;
+				long_name.clear();
+				if( size && ( header.typeflag == '\0' || header.typeflag == '0' ) )//only do non-empty regulars files
+					ret.push_back({name,pos,size});
+				else
+					LOG( Debug, verbose_info ) << "Skipping " << name << " inside the tar file because its empty or no regular file (type is " << header.typeflag << ")" ;
+			}
+			pos+=padded(size);
+		}
+		return ret;
+	}
+
+	bool read_header( const std::basic_istream<char> &src, size_t &size, size_t &next_header_in ) {
+		if( boost::iostreams::read( src, reinterpret_cast<char *>( &tar_header ), 512 ) == 512 && parse_size( tar_header, size ) ) {
+			next_header_in = padded( size );
 			return true;
 		} else
 			return false;
@@ -73,8 +130,82 @@ public:
 	void write( const data::Image &image, const std::string &filename, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback )override {
 		throwGenericError( "Not implemented (yet)" );
 	}
-	std::list<data::Chunk> load ( std::streambuf *source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> /*progress*/ ) override {
+	std::list<data::Chunk> load ( data::ByteArray source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> progress ) override {
+		std::list<data::Chunk> ret;
+		loadInto( std::move( source ), std::move( formatstack ), std::move( dialects ), std::move( progress ), [&ret]( data::Chunk &&ch ) {ret.push_back( std::move( ch ) );} );
+		return ret;
+	}
+	std::list<data::Chunk> load ( std::streambuf *source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> progress ) override {
 		std::list<data::Chunk> ret;
+		loadInto( source, std::move( formatstack ), std::move( dialects ), std::move( progress ), [&ret]( data::Chunk &&ch ) {ret.push_back( std::move( ch ) );} );
+		return ret;
+	}
+
+	void loadInto( const std::filesystem::path &filename, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> progress, const chunk_sink &sink ) override {
+		if( std::filesystem::file_size( filename ) == 0 ) {
+			LOG( Runtime, warning ) << "Ignoring empty file " << filename;
+			return;
+		}
+		data::FilePtr ptr( filename );
+		if( !ptr.good() )
+			throwSystemError( errno, filename.native() + " could not be opened" );
+		loadInto( static_cast<data::ByteArray &>( ptr ), std::move( formatstack ), std::move( dialects ), std::move( progress ), sink );
+	}
+	/**
+	 * Load the members of an uncompressed tar archive in memory (usually a mapped file).
+	 * The members are handed to the reading plugins as views into the archive, so there is no copying.
+	 * Up to hardware_concurrency members are parsed in parallel, their chunks are handed to sink in the order of the archive.
+	 */
+	void loadInto ( data::ByteArray source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> /*progress*/, const chunk_sink &sink ) override {
+		formatstack.pop_back(); //remove the "tar"
+		const std::vector<Member> members=index(source);
+		LOG( Debug, info ) << "Found " << members.size() << " files in the tar archive";
+
+		const size_t max_jobs=std::max(std::thread::hardware_concurrency(),1u);
+		std::list<std::future<std::list<data::Chunk>>> jobs;
+		auto collect=[&](){
+			for(data::Chunk &ch:jobs.front().get())
+				sink(std::move(ch));
+			jobs.pop_front();
+		};
+
+		for(const Member &member:members){
+			std::list<util::istring> member_formatstack=formatstack;
+			data::IOFactory::FileFormatList formats = data::IOFactory::getFileFormatList( member_formatstack ); // try to get the reading plugin from the formatstack
+
+			if(formats.empty()){ // if that fails try again with a formatstack from the filename
+				member_formatstack=data::IOFactory::getFormatStack(member.name.native());
+				formats= data::IOFactory::getFileFormatList( member_formatstack );
+			}
+
+			if( formats.empty() ) {
+				LOG( Runtime, notice ) << "Skipping " << member.name << " inside the tar file because no plugin was found to read it"; // skip if we found none
+				LOG( Runtime, notice ) << R"(You might want to define it with the "-rf" option (e.g. "-rf dcm tar gz" for dcm files inside a tar.gz))";
+				continue;
+			}
+
+			// view into the archive (keeps the archive alive as long as its needed)
+			const data::ByteArray buffer(std::static_pointer_cast<uint8_t>(source.getRawAddress(member.offset)),member.size);
+
+			if(jobs.size()>=max_jobs)
+				collect();
+			jobs.push_back(std::async(std::launch::async,[buffer,member,member_formatstack,dialects](){
+				try {
+					std::list<data::Chunk> loaded=data::IOFactory::loadChunks( buffer, member_formatstack, dialects );
+					for(data::Chunk &ref : loaded ) { // set the source property of the red chunks to something more usefull
+						ref.setValueAs( "source", member.name.native() ); //@todo  add tar filename
+					}
+					return loaded;
+				} catch(data::IOFactory::io_error &e){
+					LOG( Runtime, warning ) << "Failed to load " << member.name << " inside the tar file with " << e.which()->getName() << " (" << e.what() <<  " )";
+					return std::list<data::Chunk>();
+				}
+			}));
+		}
+		while(!jobs.empty())
+			collect();
+	}
+	void loadInto ( std::streambuf *source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> /*progress*/, const chunk_sink &sink ) override {
 		size_t size, next_header_in;
 		std::basic_istream<char> in(source);
 		formatstack.pop_back(); //remove the "tar"
@@ -92,8 +223,7 @@ public:
 
 				read_header( in, size, next_header_in ); //continue with the next header
 			} else {
-				//get the original filename (use substr, because these fields are not \0-terminated)
-				org_file = std::filesystem::path( std::string( tar_header.prefix ).substr( 0, 155 ) + std::string( tar_header.name ).substr( 0, 100 ) );
+				org_file = member_name( tar_header );
 			}
 
 			if( size == 0 ) //if there is no content skip this entry (there are always two "empty" blocks at the end of a tar)
@@ -101,12 +231,12 @@ public:
 
 			if( tar_header.typeflag == '\0' || tar_header.typeflag == '0' ) { //only do regulars files
 
-				
-				data::IOFactory::FileFormatList formats = data::IOFactory::getFileFormatList( formatstack ); // try to get the reading plugin from the formatstack
+				std::list<util::istring> member_formatstack=formatstack; // don't let the suffix of one member stick to the next
+				data::IOFactory::FileFormatList formats = data::IOFactory::getFileFormatList( member_formatstack ); // try to get the reading plugin from the formatstack
 				
 				if(formats.empty()){ // if that fails try again with a formatstack from the filename
-					formatstack=data::IOFactory::getFormatStack(org_file.native());
-					formats= data::IOFactory::getFileFormatList( formatstack );
+					member_formatstack=data::IOFactory::getFormatStack(org_file.native());
+					formats= data::IOFactory::getFileFormatList( member_formatstack );
 				}
 
 				if( formats.empty() ) {
@@ -123,11 +253,10 @@ public:
 
 					// read the temporary file
 					try {
-						std::list<data::Chunk> loaded=data::IOFactory::loadChunks( buffer, formatstack, dialects );
-						for(data::Chunk &ref : loaded ) { // set the source property of the red chunks to something more usefull
-							ref.setValueAs( "source", org_file.native() ); //@todo  add tar filename
-						}
-						ret.splice(ret.end(),loaded);
+						data::IOFactory::loadChunksInto( buffer, [&](data::Chunk &&ch){
+							ch.setValueAs( "source", org_file.native() ); // set the source property of the red chunks to something more usefull //@todo  add tar filename
+							sink(std::move(ch));
+						}, member_formatstack, dialects );
 					} catch(data::IOFactory::io_error &e){
 						LOG( Runtime, warning ) << "Failed to load " << org_file << " inside the tar file with " << e.which()->getName() << " (" << e.what() <<  " )"; // skip if we found none
 					}
@@ -138,8 +267,6 @@ public:
 
 			in.ignore( next_header_in ); // skip the remaining input until the next header
 		}
-
-		return ret;
 	}
 };
 
@@ -7,44 +7,83 @@
 
 #include "sftpclient.hpp"
 #include <isis/core/fileptr.hpp>
+#include <isis/core/batch_reader.hpp>
 
 
 namespace isis::image_io
 {
 
 class ImageFormat_Sftp: public FileFormat{
+	/**
+	 * Download the given files over up to connections separate connections and parse them as they arrive.
+	 * Downloads are done in worker threads (see data::BatchReader::fetch), while the calling thread parses the downloaded data.
+	 * A worker which can't open its connection leaves its files to the others.
+	 */
+	static std::list<data::Chunk> load_files(
+		const std::string &host, uint16_t port, const std::string &user, const std::string &keyfile,
+		const std::vector<std::string> &files, const std::list<util::istring> &formatstack, size_t connections
+	){
+		const auto connect=[&]()->data::BatchReader::fetcher{
+			std::shared_ptr<SftpClient> client;
+			try{
+				client=std::make_shared<SftpClient>(host,port,user,keyfile);
+			} catch(std::exception &e){
+				LOG(Runtime,warning) << "Failed to open additional connection to " << host << " (" << e.what() << ")";
+				throw;
+			}
+			return [client,&files](size_t i){return client->download(files[i]).value_or(data::ByteArray());};
+		};
+
+		std::list<data::Chunk> ret;
+		data::BatchReader::fetch(files.size(),connections,connect,[&](size_t index,data::ByteArray &&data){
+			if(!data.isValid() || data.getLength()==0)
+				return;
+			std::list<util::istring> file_formatstack = formatstack.empty() ?
+				util::stringToList<util::istring>(files[index], '.'):
+				formatstack;
+			try{
+				ret.splice(ret.end(),data::IOFactory::loadChunks( data, file_formatstack ));
+			} catch(data::IOFactory::io_error &e){
+				LOG(Runtime, warning) << e.what() << " while reading " << files[index] << " from sftp.";
+			}
+		});
+		return ret;
+	}
 protected:
 	std::list<util::istring> suffixes( io_modes modes )const override {return {"sftp"};}
 public:
 	std::string getName()const override {return "sftp reading proxy";};
+	std::list<util::istring> dialects()const override {return {"serial"};}
 	void write( const data::Image &image, const std::string &filename, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback )override {
 		throwGenericError( "Not implemented (yet)" );
 	}
+	bool readsFiles()const override {return true;} // the "filename" is an url
 	std::list<data::Chunk>	load( const std::filesystem::path &filename, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback )override{
-		static const std::regex accepted_url("sftp:\\/\\/(\\w+)@(\\w+)(\\/.*)",std::regex::ECMAScript|std::regex::optimize);
+		static const std::regex accepted_url("sftp:\\/\\/(\\w+)@(\\w+)(?::(\\d+))?(\\/.*)",std::regex::ECMAScript|std::regex::optimize);
 		std::list<data::Chunk> ret;
 
 		std::cmatch match;
 		if(std::regex_match(filename.c_str(),match,accepted_url)){
 			std::string host = match[2];
 			std::string user = match[1];
-			std::string remote_path = match[3];
+			const uint16_t port = match[3].matched ? std::stoul(match[3]) : 22;
+			std::string remote_path = match[4];
 			std::string keyfile = std::string(std::getenv("HOME"))+"/.ssh/id_rsa";//@todo actually look for the keyfile
-			SftpClient client(host,user,keyfile);
+			const _internal::Libssh2Init libssh2; // once for all connections, as that is not thread safe
+			SftpClient client(host,port,user,keyfile);
 
 			if(formatstack.back()=="sftp")
 				formatstack.pop_back(); //remove the "sftp"
 
 			if(client.is_dir(remote_path)) {
-				for(auto file:client.get_listing(remote_path)){
-					ret.splice(ret.end(),client.load_file(remote_path, formatstack));
-				}
-
+				const std::list<std::string> listing=client.get_listing(remote_path);
+				const size_t connections=checkDialect(dialects,"serial") ? 1:4;
+				ret=load_files(host,port,user,keyfile,std::vector<std::string>(listing.begin(),listing.end()),formatstack,connections);
 			} else
 				ret= client.load_file(remote_path, formatstack);
 
 		} else
-			throwGenericError("Filename must an url like sftp://<username>@<host>/<path on the server>");
+			throwGenericError("Filename must an url like sftp://<username>@<host>[:<port>]/<path on the server>");
 
 		return ret;
 	}
@@ -59,18 +59,36 @@ std::streambuf::int_type SftpClient::streambuf::underflow()
 	return traits_type::to_int_type(*gptr());
 }
 
-SftpClient::SftpClient(const std::string& host, const std::string& username, const std::string& keyfile)	: session(init())
+_internal::Libssh2Init::Libssh2Init()
 {
-	if (session) {
+	if (const int err = libssh2_init(0))
+		FileFormat::throwGenericError("libssh2 initialization failed (" + std::to_string(err) + ")");
+}
+_internal::Libssh2Init::~Libssh2Init()
+{
+	libssh2_exit();
+}
+
+SftpClient::SftpClient(const std::string& host, uint16_t port, const std::string& username, const std::string& keyfile)	: session(init())
+{
+	try {
+		if (!session)
+			FileFormat::throwGenericError("Failed to create ssh session");
 		libssh2_session_set_blocking(session.get(), 1);
-		open(host,username, keyfile);
+		if (!open(host, port, username, keyfile))
+			FileFormat::throwGenericError("Failed to start sftp on " + host);
+	} catch (...) { // the destructor won't do it
+		close_socket();
+		throw;
 	}
-	else LOG(Runtime, error) << "Failed to create ssh session";
 }
 
 SftpClient::~SftpClient()
 {
-	libssh2_exit();
+	close_socket();
+}
+void SftpClient::close_socket()
+{
 #ifdef WIN32
 	closesocket(_sock);
 #else
@@ -81,33 +99,66 @@ SftpClient::~SftpClient()
 std::list<isis::data::Chunk> SftpClient::load_file(std::string remotePath, std::list<util::istring> formatstack) const
 {
 	std::list<isis::data::Chunk> ret;
-	if (session && sftp) {
-		auto file = libssh2_sftp_open_ex(sftp.get(),
-										 remotePath.c_str(),
-										 remotePath.length(),
-										 LIBSSH2_FXF_READ,
-										 0,
-										 LIBSSH2_SFTP_OPENFILE);
-		if (file) {
-			streambuf buff(file);
-			if (formatstack.empty()) formatstack = util::stringToList<util::istring>(remotePath, '.');
-			try {
-				ret = isis::data::IOFactory::loadChunks(&buff, formatstack);
-			}
-			catch (isis::data::IOFactory::io_error &e) {
-				LOG(Runtime, error) << e.what() << " while reading " << remotePath << " from sftp.";
-				libssh2_sftp_close(file);
-				throw;
-			}
-			libssh2_sftp_close(file);
+	std::optional<data::ByteArray> data = download(remotePath);
+	if (data) {
+		if (data->getLength() == 0) {
+			LOG(Runtime, warning) << "Ignoring empty remote file " << remotePath;
+			return ret;
+		}
+		if (formatstack.empty()) formatstack = util::stringToList<util::istring>(remotePath, '.');
+		try {
+			ret = isis::data::IOFactory::loadChunks(*data, formatstack);
 		}
-		else {
-			LOG(Runtime, warning) << "Failed to open remote file " << remotePath;
+		catch (isis::data::IOFactory::io_error &e) {
+			LOG(Runtime, error) << e.what() << " while reading " << remotePath << " from sftp.";
+			throw;
 		}
 	}
-	else {
-		LOG(Runtime, error) << "sftp connection was not established, will return empty list";
+	return ret;
+}
+std::optional<data::ByteArray> SftpClient::download(const std::string &remotePath) const
+{
+	static const size_t request_size = 1024 * 1024 * 4;
+	if (!session || !sftp) {
+		LOG(Runtime, error) << "sftp connection was not established, cannot download " << remotePath;
+		return {};
+	}
+	auto file = libssh2_sftp_open_ex(sftp.get(),
+									 remotePath.c_str(),
+									 remotePath.length(),
+									 LIBSSH2_FXF_READ,
+									 0,
+									 LIBSSH2_SFTP_OPENFILE);
+	if (!file) {
+		LOG(Runtime, warning) << "Failed to open remote file " << remotePath;
+		return {};
+	}
+
+	std::optional<data::ByteArray> ret;
+	LIBSSH2_SFTP_ATTRIBUTES attr;
+	if (libssh2_sftp_fstat_ex(file, &attr, 0) == 0 && (attr.flags & LIBSSH2_SFTP_ATTR_SIZE)) {
+		data::ByteArray buffer(attr.filesize);
+		char *dst = std::static_pointer_cast<char>(buffer.getRawAddress()).get();
+		size_t red = 0;
+		while (red < attr.filesize) {
+			const ssize_t n = libssh2_sftp_read(file, dst + red, std::min<size_t>(attr.filesize - red, request_size));
+			if (n <= 0) {
+				LOG_IF(n < 0, Runtime, warning) << "Reading " << remotePath << " failed with error " << n;
+				break;
+			}
+			red += n;
+		}
+		if (red == attr.filesize)
+			ret = buffer;
+		else
+			LOG(Runtime, warning) << "Could only read " << red << " of " << attr.filesize << " bytes from " << remotePath;
+	} else { // size is unknown, read through the stream buffer
+		LOG(Debug, info) << "Size of " << remotePath << " is unknown, reading it as stream";
+		streambuf buff(file);
+		auto buffer = std::make_shared<std::vector<uint8_t>>(std::istreambuf_iterator<char>(&buff), std::istreambuf_iterator<char>());
+		ret = data::ByteArray(std::shared_ptr<uint8_t>(buffer, buffer->data()), buffer->size());
 	}
+	libssh2_sftp_close(file);
 	return ret;
 }
 std::list<std::string> SftpClient::get_listing(const std::string &remotePath)
@@ -148,25 +199,18 @@ LIBSSH2_SESSION *SftpClient::init()
 			return 1;
 		}
 #endif
-	// Initialize libssh2 on a thread safe manner, count the session instances.
-	auto err = libssh2_init(0);
-	if (err) {
-		LOG(Runtime, error) << "libssh2 initialization failed (" << err << ")";
-		return nullptr;
-	}
-
 	_sock = socket(AF_INET, SOCK_STREAM, 0);
 	return libssh2_session_init();
 }
 
-bool SftpClient::open(std::string host, std::string username, std::string keyfile_name)
+bool SftpClient::open(std::string host, uint16_t port, std::string username, std::string keyfile_name)
 {
 	auto hst = gethostbyname(host.c_str());
 	auto addr= inet_ntoa(**(in_addr**)hst->h_addr_list);
 
 	sockaddr_in sin;
 	sin.sin_family = AF_INET;
-	sin.sin_port = htons(22);
+	sin.sin_port = htons(port);
 	sin.sin_addr.s_addr = inet_addr(addr);
 	if (connect(_sock, (struct sockaddr *) (&sin), sizeof(struct sockaddr_in)) != 0)
 		image_io::FileFormat::throwSystemError(errno);
@@ -23,7 +23,9 @@
 #include <libssh2.h>
 #include <libssh2_sftp.h>
 #include <isis/core/chunk.hpp>
+#include <isis/core/bytearray.hpp>
 #include <streambuf>
+#include <optional>
 
 extern "C"
 {
@@ -58,6 +60,19 @@ namespace isis::image_io
 namespace _internal{
 struct ssh_session_deleter{void operator()(LIBSSH2_SESSION *p){libssh2_session_free(p);}};
 struct sftp_session_deleter{void operator()(LIBSSH2_SFTP *p){libssh2_sftp_shutdown(p);}};
+/**
+ * Keeps libssh2 initialized while it exists.
+ * libssh2_init and libssh2_exit are not thread safe, so this must be done once, before any SftpClient is created
+ * (they may be created in different threads afterwards).
+ */
+class Libssh2Init
+{
+public:
+	Libssh2Init();
+	~Libssh2Init();
+	Libssh2Init(const Libssh2Init &)=delete;
+	Libssh2Init &operator=(const Libssh2Init &)=delete;
+};
 }
 class SftpClient
 {
@@ -84,11 +99,20 @@ public:
 		LIBSSH2_SFTP_HANDLE* p_file;
 		std::vector<char> buffer_;
 	};
-	SftpClient(const std::string& host, const std::string& username, const std::string& keyfile);
+	/// connect to the server, throws if that fails (libssh2 must be initialized, see _internal::Libssh2Init)
+	SftpClient(const std::string& host, uint16_t port, const std::string& username, const std::string& keyfile);
 	~SftpClient();
 	[[nodiscard]] std::list<isis::data::Chunk> load_file(std::string remotePath, std::list<util::istring> list) const;
+	/**
+	 * Download a remote file into memory.
+	 * If the size of the file is known, it is read directly into a ByteArray of that size using large read requests,
+	 * which makes libssh2 keep multiple sftp read requests in flight.
+	 * \returns the content of the file or an empty optional if reading failed
+	 */
+	[[nodiscard]] std::optional<data::ByteArray> download(const std::string &remotePath) const;
 protected:
-	bool open(std::string host, std::string username, std::string keyfile_name);
+	bool open(std::string host, uint16_t port, std::string username, std::string keyfile_name);
+	void close_socket();
 	LIBSSH2_SESSION *init();
 	bool ok_or_throw(int err);
 };
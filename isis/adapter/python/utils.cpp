@@ -50,13 +50,12 @@ bool, int, double
 		// Lazy initialise the PyDateTime import
 		if (!PyDateTimeAPI) { PyDateTime_IMPORT; }
 
-		time_t tme(std::chrono::duration_cast<std::chrono::seconds>(v.time_since_epoch()).count());
-		std::tm localtime = *std::localtime(&tme);
+		const std::chrono::year_month_day ymd(v);
 
 		py::handle handle(PyDate_FromDate(
-			localtime.tm_year + 1900,
-			localtime.tm_mon + 1,
-			localtime.tm_mday));
+			int(ymd.year()),
+			unsigned(ymd.month()),
+			unsigned(ymd.day())));
 		return py::reinterpret_steal<py::object>(handle);
 	}
 
@@ -24,6 +24,7 @@
 #include <memory>
 #include "application.hpp"
 #include "fileptr.hpp"
+#include "batch_reader.hpp"
 #include "console_progress_bar.hpp"
 
 #define STR(s) _xstr_(s)
@@ -61,6 +62,15 @@ Application::Application( std::string_view name, std::string_view cfg): m_name(
 	parameters["np"].setNeeded(false);
 	parameters["np"].setDescription( "suppress progress bar" );
 	parameters["np"].hidden() = true;
+
+	parameters["membudget"] = uint32_t( 0 );
+	parameters["membudget"].setNeeded(false);
+	parameters["membudget"].setDescription( "memory budget in MB, data beyond that is kept in scratch files (0 to keep the default from ISIS_MEMORY_BUDGET)" );
+	parameters["membudget"].hidden() = true;
+	parameters["readdepth"] = uint32_t( 0 );
+	parameters["readdepth"].setNeeded(false);
+	parameters["readdepth"].setDescription( "amount of files read at once when loading directories (0 to keep the default from ISIS_READ_DEPTH)" );
+	parameters["readdepth"].hidden() = true;
 }
 
 void Application::addLoggingParameter( const std::string& name )
@@ -160,6 +170,11 @@ bool Application::initBase( int argc, char **argv )
 		feedback() = std::make_shared<util::ConsoleProgressBar>();
 
 
+	if(const uint32_t budget = parameters["membudget"])
+		data::MemoryPool::setBudget( size_t( budget ) * 1024 * 1024 );
+	if(const uint32_t depth = parameters["readdepth"])
+		data::BatchReader::setDepth( depth );
+
 	const std::string loc=parameters["locale"];
 	if(!loc.empty())
 		std::setlocale(LC_ALL,loc.c_str());
@@ -64,6 +64,7 @@ protected:
 	 * - returns false if that fails
 	 * - (re)sets logging according to parameters
 	 * - sets util::ConsoleProgressBar as logging sink unless "np" is found in parameters
+	 * - sets the memory budget of data::MemoryPool according to parameter "membudget" if given and not 0
 	 * - sets locale according to parameter "locale" if given ("C" is isis default)
 	 * @return false if parameter parsing fails (from cfg or command line), true otherwise
 	 */
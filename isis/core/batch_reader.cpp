@@ -0,0 +1,481 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2020  <copyright holder> <email>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "batch_reader.hpp"
+#include "common.hpp"
+#include "memorypool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#if __has_include(<linux/io_uring.h>)
+#define ISIS_HAVE_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace isis::data
+{
+namespace
+{
+std::atomic<size_t> &loadDepth()
+{
+	static std::atomic<size_t> depth = []() -> size_t {
+		const char *env = getenv( "ISIS_READ_DEPTH" );
+		return env ? strtoull( env, nullptr, 10 ) : 0;
+	}();
+	return depth;
+}
+
+// what we know about a file while it's being read
+struct Job {
+	int fd = -1;
+	size_t size = 0, done = 0;
+	bool failed = false;
+	ByteArray data;
+};
+
+void finish( Job &job )
+{
+	if( job.fd >= 0 )
+		close( job.fd );
+
+	job.fd = -1;
+
+	if( job.failed )
+		job.data = ByteArray();
+}
+
+// the plain way, used by the threads
+void readFile( const std::filesystem::path &file, Job &job, size_t max_size )
+{
+	struct stat st;
+	job.fd = open( file.c_str(), O_RDONLY | O_CLOEXEC );
+
+	if( job.fd < 0 || fstat( job.fd, &st ) != 0 ) {
+		LOG( Debug, info ) << "Failed to open " << file << ": " << util::getLastSystemError();
+		job.failed = true;
+	} else if( st.st_size == 0 || size_t( st.st_size ) > max_size ) {
+		job.failed = true;
+	} else {
+		job.size = st.st_size;
+		job.data = ByteArray( std::static_pointer_cast<uint8_t>( MemoryPool::acquire( job.size, false ) ), job.size );
+
+		while( job.done < job.size && !job.failed ) {
+			const ssize_t red = pread( job.fd, &job.data[job.done], job.size - job.done, job.done );
+
+			if( red > 0 )
+				job.done += red;
+			else {
+				LOG( Debug, info ) << "Failed to read " << file << ": " << ( red ? util::getLastSystemError() : "unexpected end of file" );
+				job.failed = true;
+			}
+		}
+	}
+
+	finish( job );
+}
+
+size_t readWithThreads( const std::vector<std::filesystem::path> &files, const BatchReader::file_sink &sink, size_t max_size, size_t depth )
+{
+	std::vector<Job> jobs( files.size() );
+	std::mutex lock;
+	std::condition_variable has_ready, has_space;
+	std::deque<size_t> ready;
+	std::atomic<size_t> next = 0;
+	size_t read = 0;
+
+	const auto worker = [&]() {
+		for( size_t index; ( index = next++ ) < files.size(); ) {
+			readFile( files[index], jobs[index], max_size );
+			std::unique_lock<std::mutex> guard( lock );
+			has_space.wait( guard, [&] {return ready.size() < depth || next >= files.size();} ); // don't read too far ahead
+			ready.push_back( index );
+			has_ready.notify_one();
+		}
+	};
+	std::vector<std::thread> workers;
+
+	for( size_t i = 0; i < std::min<size_t>( { depth, files.size(), 16 } ); i++ )
+		workers.emplace_back( worker );
+
+	// make sure the workers are gone, even if the sink throws
+	const std::shared_ptr<void> join( nullptr, [&]( void * ) {
+		{
+			const std::lock_guard<std::mutex> guard( lock );
+			next = files.size();
+		}
+		has_space.notify_all();
+
+		for( std::thread &t : workers )
+			t.join();
+	} );
+
+	for( size_t handed = 0; handed < files.size(); handed++ ) {
+		size_t index;
+		{
+			std::unique_lock<std::mutex> guard( lock );
+			has_ready.wait( guard, [&] {return !ready.empty();} );
+			index = ready.front();
+			ready.pop_front();
+		}
+		has_space.notify_one();
+
+		if( jobs[index].data.isValid() )
+			read++;
+
+		sink( files[index], std::move( jobs[index].data ) );
+	}
+
+	return read;
+}
+
+#ifdef ISIS_HAVE_URING
+// the bare minimum of an io_uring (there is no liburing needed for that)
+class Ring
+{
+	int fd = -1;
+	io_uring_params params{};
+	void *sq_ring = MAP_FAILED, *cq_ring = MAP_FAILED;
+	size_t sq_ring_size = 0, cq_ring_size = 0;
+	io_uring_sqe *sqes = static_cast<io_uring_sqe *>( MAP_FAILED );
+	unsigned *sq_head, *sq_tail, *sq_mask, *sq_entries, *sq_array, *cq_head, *cq_tail, *cq_mask;
+	io_uring_cqe *cqes;
+	unsigned to_submit = 0;
+
+	template<typename T> T *at( void *ring, unsigned offset ) {return reinterpret_cast<T *>( static_cast<uint8_t *>( ring ) + offset );}
+public:
+	explicit Ring( unsigned entries ) {
+		// only we submit and reap, so the kernel may leave finishing requests to us instead of interrupting us for each (linux 6.1+)
+		params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+		fd = syscall( __NR_io_uring_setup, entries, &params );
+
+		if( fd < 0 && errno == EINVAL ) {
+			params = {};
+			fd = syscall( __NR_io_uring_setup, entries, &params );
+		}
+
+		if( fd < 0 )
+			return;
+
+		sq_ring_size = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+		cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof( io_uring_cqe );
+
+		if( params.features & IORING_FEAT_SINGLE_MMAP )
+			sq_ring_size = cq_ring_size = std::max( sq_ring_size, cq_ring_size );
+
+		sq_ring = mmap( nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING );
+		cq_ring = ( params.features & IORING_FEAT_SINGLE_MMAP ) ?
+				  sq_ring : mmap( nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING );
+		sqes = static_cast<io_uring_sqe *>( mmap( nullptr, params.sq_entries * sizeof( io_uring_sqe ), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES ) );
+
+		if( !good() )
+			return;
+
+		sq_head = at<unsigned>( sq_ring, params.sq_off.head );
+		sq_tail = at<unsigned>( sq_ring, params.sq_off.tail );
+		sq_mask = at<unsigned>( sq_ring, params.sq_off.ring_mask );
+		sq_entries = at<unsigned>( sq_ring, params.sq_off.ring_entries );
+		sq_array = at<unsigned>( sq_ring, params.sq_off.array );
+		cq_head = at<unsigned>( cq_ring, params.cq_off.head );
+		cq_tail = at<unsigned>( cq_ring, params.cq_off.tail );
+		cq_mask = at<unsigned>( cq_ring, params.cq_off.ring_mask );
+		cqes = at<io_uring_cqe>( cq_ring, params.cq_off.cqes );
+	}
+	~Ring() {
+		if( sqes != MAP_FAILED )
+			munmap( sqes, params.sq_entries * sizeof( io_uring_sqe ) );
+
+		if( cq_ring != MAP_FAILED && cq_ring != sq_ring )
+			munmap( cq_ring, cq_ring_size );
+
+		if( sq_ring != MAP_FAILED )
+			munmap( sq_ring, sq_ring_size );
+
+		if( fd >= 0 )
+			close( fd );
+	}
+	Ring( const Ring & ) = delete;
+	Ring &operator=( const Ring & ) = delete;
+
+	[[nodiscard]] bool good()const {return fd >= 0 && sq_ring != MAP_FAILED && cq_ring != MAP_FAILED && sqes != MAP_FAILED;}
+
+	/// get an empty submission entry, the caller must make sure there is space for it
+	io_uring_sqe &next( uint64_t user_data ) {
+		const unsigned tail = *sq_tail; // we are the only ones writing that
+		assert( tail - std::atomic_ref<unsigned>( *sq_head ).load( std::memory_order_acquire ) < *sq_entries );
+		const unsigned index = tail & *sq_mask;
+		io_uring_sqe &sqe = sqes[index];
+		memset( &sqe, 0, sizeof( sqe ) );
+		sqe.user_data = user_data;
+		sq_array[index] = index;
+		std::atomic_ref<unsigned>( *sq_tail ).store( tail + 1, std::memory_order_release ); // the kernel only looks at it on submit, so the caller can still fill it
+		to_submit++;
+		return sqe;
+	}
+	/// submit all new entries and wait for at least wait_for completions
+	bool submit( unsigned wait_for ) {
+		while( true ) {
+			const int ret = syscall( __NR_io_uring_enter, fd, to_submit, wait_for, IORING_ENTER_GETEVENTS, nullptr, 0 ); // also lets the kernel post deferred completions
+
+			if( ret >= 0 ) {
+				to_submit -= ret;
+
+				if( to_submit == 0 )
+					return true;
+			} else if( errno != EINTR && errno != EAGAIN && errno != EBUSY ) {
+				LOG( Runtime, error ) << "io_uring_enter failed: " << util::getLastSystemError();
+				return false;
+			}
+		}
+	}
+	/// call op(user_data, result) for all completions there are
+	template<typename OP> void reap( OP op ) {
+		unsigned head = *cq_head; // we are the only ones writing that
+
+		for( const unsigned tail = std::atomic_ref<unsigned>( *cq_tail ).load( std::memory_order_acquire ); head != tail; head++ ) {
+			const io_uring_cqe &cqe = cqes[head & *cq_mask];
+			op( cqe.user_data, cqe.res );
+		}
+
+		std::atomic_ref<unsigned>( *cq_head ).store( head, std::memory_order_release );
+	}
+};
+
+size_t readWithUring( Ring &ring, const std::vector<std::filesystem::path> &files, const BatchReader::file_sink &sink, size_t max_size, size_t depth )
+{
+	enum op_type {op_open, op_read};
+	std::vector<Job> jobs( files.size() );
+	std::deque<size_t> ready;
+	size_t next = 0, in_flight = 0, read = 0, pending = 0;
+
+	const auto submit_read = [&]( size_t index ) {
+		Job &job = jobs[index];
+		io_uring_sqe &sqe = ring.next( index << 2 | op_read );
+		sqe.opcode = IORING_OP_READ;
+		sqe.fd = job.fd;
+		sqe.addr = reinterpret_cast<uintptr_t>( &job.data[job.done] );
+		sqe.len = std::min<size_t>( job.size - job.done, 1 << 30 );
+		sqe.off = job.done;
+		pending++;
+	};
+	const auto completed = [&]( uint64_t user_data, int result ) {
+		const size_t index = user_data >> 2;
+		Job &job = jobs[index];
+		pending--;
+
+		if( ( user_data & 3 ) == op_open ) {
+			// IORING_OP_STATX would always be punted to a kernel worker, asking the open file is much cheaper
+			struct stat st;
+
+			if( result < 0 || ( job.fd = result, fstat( job.fd, &st ) ) != 0 || st.st_size == 0 || size_t( st.st_size ) > max_size )
+				job.failed = true;
+			else
+				job.size = st.st_size;
+		} else if( result <= 0 )
+			job.failed = true;
+		else
+			job.done += result;
+
+		LOG_IF( result < 0, Debug, info ) << "Failed to read " << files[index] << ": " << strerror( -result );
+
+		if( !job.failed && job.done < job.size ) {
+			if( !job.data.isValid() )
+				job.data = ByteArray( std::static_pointer_cast<uint8_t>( MemoryPool::acquire( job.size, false ) ), job.size );
+
+			submit_read( index );
+		} else {
+			finish( job );
+			ready.push_back( index );
+		}
+	};
+	// wait for everything that's still running, the kernel might still write into our buffers
+	const std::shared_ptr<void> drain( nullptr, [&]( void * ) {
+		while( pending && ring.submit( 1 ) )
+			ring.reap( completed );
+	} );
+
+	for( size_t handed = 0; handed < files.size(); ) {
+		// start opening as many files as we may
+		for( ; next < files.size() && in_flight < depth; next++, in_flight++ ) {
+			io_uring_sqe &open = ring.next( next << 2 | op_open );
+			open.opcode = IORING_OP_OPENAT;
+			open.fd = AT_FDCWD;
+			open.addr = reinterpret_cast<uintptr_t>( files[next].c_str() );
+			open.open_flags = O_RDONLY | O_CLOEXEC;
+			pending++;
+		}
+
+		// submit, and if there is nothing to hand on wait for something to complete
+		if( !ring.submit( ready.empty() ? 1 : 0 ) )
+			throw std::runtime_error( "io_uring failed" );
+
+		ring.reap( completed );
+
+		if( !ready.empty() ) { // hand on one file, then keep the ring busy again
+			const size_t index = ready.front();
+			ready.pop_front();
+			in_flight--;
+			handed++;
+
+			if( jobs[index].data.isValid() )
+				read++;
+
+			sink( files[index], std::move( jobs[index].data ) );
+		}
+	}
+
+	return read;
+}
+#endif
+}
+
+bool BatchReader::hasUring()
+{
+#ifdef ISIS_HAVE_URING
+	static const bool ret = Ring( 2 ).good();
+	return ret;
+#else
+	return false;
+#endif
+}
+
+void BatchReader::setDepth( size_t files ) {loadDepth() = files;}
+size_t BatchReader::getDepth() {return loadDepth();}
+
+size_t BatchReader::fetch( size_t count, size_t workers, const std::function<fetcher()> &connect, const item_sink &sink )
+{
+	workers = std::min( std::max<size_t>( workers, 1 ), count );
+
+	if( workers == 0 )
+		return 0;
+
+	const size_t max_ready = workers * 2;
+	std::mutex lock;
+	std::condition_variable has_ready, has_space;
+	std::deque<std::pair<size_t, ByteArray>> ready;
+	std::atomic<size_t> next = 0;
+	size_t running = workers, fetched = 0;
+	std::exception_ptr connect_error;
+
+	const auto worker = [&]() {
+		fetcher get;
+
+		try {
+			get = connect();
+		} catch( ... ) { // leave the items to the workers which could connect
+			const std::lock_guard<std::mutex> guard( lock );
+
+			if( !connect_error )
+				connect_error = std::current_exception();
+
+			running--;
+			has_ready.notify_one();
+			return;
+		}
+
+		for( size_t index; ( index = next++ ) < count; ) {
+			ByteArray got;
+
+			try {
+				got = get( index );
+			} catch( const std::exception &e ) {
+				LOG( Runtime, warning ) << "Failed to fetch item " << index << " (" << e.what() << ")";
+			}
+
+			std::unique_lock<std::mutex> guard( lock );
+			has_space.wait( guard, [&] {return ready.size() < max_ready || next >= count;} ); // don't fetch too far ahead
+			ready.emplace_back( index, std::move( got ) );
+			has_ready.notify_one();
+		}
+
+		const std::lock_guard<std::mutex> guard( lock );
+		running--;
+		has_ready.notify_one();
+	};
+	std::vector<std::thread> threads;
+
+	for( size_t i = 0; i < workers; i++ )
+		threads.emplace_back( worker );
+
+	// make sure the workers are gone, even if the sink throws
+	const std::shared_ptr<void> join( nullptr, [&]( void * ) {
+		{
+			const std::lock_guard<std::mutex> guard( lock );
+			next = count;
+		}
+		has_space.notify_all();
+
+		for( std::thread &t : threads )
+			t.join();
+	} );
+
+	for( size_t handed = 0; handed < count; handed++ ) {
+		std::pair<size_t, ByteArray> item;
+		{
+			std::unique_lock<std::mutex> guard( lock );
+			has_ready.wait( guard, [&] {return !ready.empty() || running == 0;} );
+
+			if( ready.empty() ) // the workers are gone before fetching everything, so none of them could connect
+				std::rethrow_exception( connect_error );
+
+			item = std::move( ready.front() );
+			ready.pop_front();
+		}
+		has_space.notify_one();
+
+		if( item.second.isValid() )
+			fetched++;
+
+		sink( item.first, std::move( item.second ) );
+	}
+
+	return fetched;
+}
+
+size_t BatchReader::read( const std::vector<std::filesystem::path> &files, const file_sink &sink, size_t max_size, size_t depth, backend use )
+{
+	if( files.empty() )
+		return 0;
+
+	depth = std::max<size_t>( depth, 1 );
+#ifdef ISIS_HAVE_URING
+
+	if( use != threads ) {
+		Ring ring( depth ); // an open or a read for each file in flight
+
+		if( ring.good() )
+			return readWithUring( ring, files, sink, max_size, depth );
+
+		LOG_IF( use == uring, Runtime, warning ) << "Can't set up an io_uring (" << util::getLastSystemError() << "), falling back to threads";
+	}
+
+#else
+	LOG_IF( use == uring, Runtime, warning ) << "No io_uring support, falling back to threads";
+#endif
+	return readWithThreads( files, sink, max_size, depth );
+}
+}
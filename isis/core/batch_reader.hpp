@@ -0,0 +1,89 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2020  <copyright holder> <email>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "bytearray.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+namespace isis::data
+{
+/**
+ * Reads many (small) files into memory, with a lot of them in flight at once.
+ * Opening and reading a file one after another means waiting for each of them in turn. This keeps up to depth files
+ * being opened and read while the ones already done are handed on. So the caller can work on (e.g. decode) a file
+ * while the next ones are being read.
+ *
+ * On Linux io_uring is used if the kernel supports it (opens and reads are all submitted to the kernel at once).
+ * Otherwise a pool of threads does the opens and reads.
+ */
+class BatchReader
+{
+public:
+	enum backend {automatic, uring, threads};
+	/**
+	 * Gets the files and their content.
+	 * If the file was not read (because reading it failed or it was bigger than max_size) the ByteArray is empty (isValid()==false).
+	 */
+	typedef std::function<void( const std::filesystem::path &, ByteArray && )> file_sink;
+
+	/**
+	 * Read files into memory.
+	 * The files are handed to the sink (in the calling thread) in the order they are done, which is not necessarily the given order.
+	 * \param files the files to read
+	 * \param sink the function getting the files
+	 * \param max_size files bigger than this are not read (use FilePtr for them)
+	 * \param depth the maximum amount of files in flight (including those which are read and not handed to the sink yet)
+	 * \param use the backend to be used (automatic is uring if available, otherwise threads)
+	 * \returns the amount of files read
+	 */
+	static size_t read( const std::vector<std::filesystem::path> &files, const file_sink &sink, size_t max_size = SIZE_MAX, size_t depth = 64, backend use = automatic );
+	/// \returns true if io_uring can be used
+	static bool hasUring();
+
+	/// gets a single item by its index, \returns an invalid ByteArray if that failed
+	typedef std::function<ByteArray( size_t index )> fetcher;
+	/// gets the fetched items by their index (failed ones as invalid ByteArray)
+	typedef std::function<void( size_t index, ByteArray && )> item_sink;
+	/**
+	 * Fetch items (e.g. remote files) with several workers and hand them to the sink (in the calling thread) as they arrive.
+	 * Each worker calls connect once to get its fetcher (e.g. one with its own connection to a server). If that throws, the
+	 * worker doesn't take any items and leaves them to the others. Only if none of the workers could connect the first
+	 * of the errors is rethrown.
+	 * At most twice as many items as there are workers are kept waiting for the sink.
+	 * \param count the amount of items to fetch
+	 * \param workers the maximum amount of workers (and thus items being fetched at once)
+	 * \param connect the function giving each worker its fetcher (called in the worker thread)
+	 * \param sink the function getting the items
+	 * \returns the amount of items fetched
+	 */
+	static size_t fetch( size_t count, size_t workers, const std::function<fetcher()> &connect, const item_sink &sink );
+
+	/**
+	 * Set how many files IOFactory keeps in flight when loading a directory (0 to load them one after another).
+	 * That pays off where waiting for the storage dominates (network filesystems, cold disks), for data that is
+	 * cached or on tmpfs it costs more than it saves. So the default is 0, or taken from the environment variable
+	 * ISIS_READ_DEPTH if that is set.
+	 */
+	static void setDepth( size_t files );
+	static size_t getDepth();
+};
+}
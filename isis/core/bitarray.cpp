@@ -0,0 +1,255 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2020  <copyright holder> <email>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bitarray.hpp"
+#include "common.hpp"
+#include <bit>
+#include <atomic>
+
+namespace isis::data
+{
+namespace
+{
+constexpr size_t block_bytes = 64 * 1024; // packed bytes per parallel job
+constexpr size_t parallel_bytes = 1024 * 1024; // below this amount of packed bytes everything is done in one go
+
+template<typename T> constexpr bool packable = std::is_arithmetic_v<T>;
+
+/// run op(begin,end) on blocks of the bytes [0,bytes), in parallel if there are enough of them
+void forBlocks( size_t bytes, const std::function<void( size_t begin, size_t end )> &op )
+{
+	if( bytes < parallel_bytes ) {
+		op( 0, bytes );
+	} else {
+		const size_t blocks = ( bytes + block_bytes - 1 ) / block_bytes;
+		util::parallelFor( blocks, [&]( size_t begin, size_t end ) {
+			op( begin * block_bytes, std::min( end * block_bytes, bytes ) );
+		} );
+	}
+}
+
+/// combine the bytes of dst with the bytes of src word by word
+template<typename OP> void combine( uint8_t *dst, const uint8_t *src, size_t bytes, OP op )
+{
+	forBlocks( bytes, [&]( size_t begin, size_t end ) {
+		size_t i = begin;
+
+		for( ; i + sizeof( uint64_t ) <= end; i += sizeof( uint64_t ) ) {
+			uint64_t a, b;
+			memcpy( &a, dst + i, sizeof( uint64_t ) );
+			memcpy( &b, src + i, sizeof( uint64_t ) );
+			a = op( a, b );
+			memcpy( dst + i, &a, sizeof( uint64_t ) );
+		}
+
+		for( ; i < end; i++ )
+			dst[i] = op( dst[i], src[i] );
+	} );
+}
+
+void checkScalar( const ValueArray &values )
+{
+	if( !values.visit( []( auto ptr ) {return packable<typename decltype( ptr )::element_type>;} ) ) {
+		LOG( Runtime, error ) << "Cannot pack " << values.typeName() << " into bits, it is not a scalar type";
+		throw std::domain_error( "Unsupported datatype" );
+	}
+}
+void checkLength( size_t a, size_t b )
+{
+	if( a != b ) {
+		LOG( Runtime, error ) << "Length mismatch between bit arrays (" << a << "!=" << b << ")";
+		throw std::invalid_argument( "Length mismatch" );
+	}
+}
+}
+
+BitArray::BitArray( size_t length ): m_bytes( ( length + 7 ) / 8 ), m_length( length )
+{
+	std::fill_n( m_bytes.beginTyped<uint8_t>(), m_bytes.getLength(), 0 );
+}
+
+BitArray::BitArray( const TypedArray<uint8_t> &bytes, size_t length ): m_bytes( bytes ), m_length( length )
+{
+	LOG_IF( bytes.getLength() * 8 < length, Debug, error ) << "The " << bytes.getLength() << " bytes given are too few for " << length << " bits";
+	assert( bytes.getLength() * 8 >= length );
+}
+
+BitArray::BitArray( const ValueArray &values ): BitArray( values.getLength() )
+{
+	pack( values );
+}
+
+BitArray BitArray::copy()const
+{
+	BitArray ret( m_length );
+	memcpy( ret.m_bytes.beginTyped<uint8_t>(), m_bytes.beginTyped<uint8_t>(), ( m_length + 7 ) / 8 );
+	return ret;
+}
+
+BitArray::iterator BitArray::begin() {return {m_bytes.beginTyped<uint8_t>(), 0};}
+BitArray::iterator BitArray::end() {return begin() + m_length;}
+BitArray::const_iterator BitArray::begin()const {return {m_bytes.beginTyped<uint8_t>(), 0};}
+BitArray::const_iterator BitArray::end()const {return begin() + m_length;}
+
+void BitArray::pack( const ValueArray &values )
+{
+	checkScalar( values );
+	checkLength( m_length, values.getLength() );
+	uint8_t *const dst = m_bytes.beginTyped<uint8_t>();
+
+	values.visit( [&]( auto ptr ) {
+		typedef typename decltype( ptr )::element_type value_type;
+
+		if constexpr( packable<value_type> ) {
+			const value_type *const src = ptr.get();
+			forBlocks( ( m_length + 7 ) / 8, [&]( size_t begin, size_t end ) {
+				for( size_t b = begin; b < end; b++ ) {
+					const value_type *const in = src + b * 8;
+					const size_t n = std::min<size_t>( 8, m_length - b * 8 );
+					uint8_t byte = 0;
+
+					if( n == 8 ) { // unrolled by the compiler
+						for( size_t j = 0; j < 8; j++ )
+							byte |= uint8_t( in[j] != 0 ) << ( 7 - j );
+					} else {
+						for( size_t j = 0; j < n; j++ )
+							byte |= uint8_t( in[j] != 0 ) << ( 7 - j );
+					}
+
+					dst[b] = byte;
+				}
+			} );
+		}
+	} );
+}
+
+void BitArray::unpackTo( ValueArray &dst )const
+{
+	checkScalar( dst );
+	checkLength( m_length, dst.getLength() );
+	const uint8_t *const src = m_bytes.beginTyped<uint8_t>();
+
+	dst.visit( [&]( auto ptr ) {
+		typedef typename decltype( ptr )::element_type value_type;
+
+		if constexpr( packable<value_type> ) {
+			value_type *const out = ptr.get();
+			forBlocks( ( m_length + 7 ) / 8, [&]( size_t begin, size_t end ) {
+				for( size_t b = begin; b < end; b++ ) {
+					value_type *const o = out + b * 8;
+					const size_t n = std::min<size_t>( 8, m_length - b * 8 );
+
+					if( n == 8 ) {
+						for( size_t j = 0; j < 8; j++ )
+							o[j] = ( src[b] >> ( 7 - j ) ) & 1;
+					} else {
+						for( size_t j = 0; j < n; j++ )
+							o[j] = ( src[b] >> ( 7 - j ) ) & 1;
+					}
+				}
+			} );
+		}
+	} );
+}
+
+ValueArray BitArray::unpack( unsigned short ID )const
+{
+	ValueArray ret = ValueArray::createByID( ID, m_length );
+	unpackTo( ret );
+	return ret;
+}
+
+size_t BitArray::count()const
+{
+	const uint8_t *const src = m_bytes.beginTyped<uint8_t>();
+	const size_t full_bytes = m_length / 8;
+	std::atomic<size_t> ret = 0;
+
+	forBlocks( full_bytes, [&]( size_t begin, size_t end ) {
+		size_t cnt = 0, i = begin;
+
+		for( ; i + sizeof( uint64_t ) <= end; i += sizeof( uint64_t ) ) {
+			uint64_t word;
+			memcpy( &word, src + i, sizeof( uint64_t ) );
+			cnt += std::popcount( word );
+		}
+
+		for( ; i < end; i++ )
+			cnt += std::popcount( src[i] );
+
+		ret += cnt;
+	} );
+
+	if( m_length % 8 ) // ignore the unused bits of the last byte
+		ret += std::popcount( uint8_t( src[full_bytes] & ( 0xFF << ( 8 - m_length % 8 ) ) ) );
+
+	return ret;
+}
+
+BitArray &BitArray::flip()
+{
+	uint8_t *const dst = m_bytes.beginTyped<uint8_t>();
+	forBlocks( ( m_length + 7 ) / 8, [dst]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; i++ )
+			dst[i] = ~dst[i];
+	} );
+	return *this;
+}
+
+BitArray &BitArray::operator&=( const BitArray &other )
+{
+	checkLength( m_length, other.m_length );
+	combine( m_bytes.beginTyped<uint8_t>(), other.m_bytes.beginTyped<uint8_t>(), ( m_length + 7 ) / 8, []( auto a, auto b ) {return a & b;} );
+	return *this;
+}
+BitArray &BitArray::operator|=( const BitArray &other )
+{
+	checkLength( m_length, other.m_length );
+	combine( m_bytes.beginTyped<uint8_t>(), other.m_bytes.beginTyped<uint8_t>(), ( m_length + 7 ) / 8, []( auto a, auto b ) {return a | b;} );
+	return *this;
+}
+BitArray &BitArray::operator^=( const BitArray &other )
+{
+	checkLength( m_length, other.m_length );
+	combine( m_bytes.beginTyped<uint8_t>(), other.m_bytes.beginTyped<uint8_t>(), ( m_length + 7 ) / 8, []( auto a, auto b ) {return a ^ b;} );
+	return *this;
+}
+BitArray BitArray::operator~()const
+{
+	return copy().flip();
+}
+
+bool BitArray::operator==( const BitArray &other )const
+{
+	if( m_length != other.m_length )
+		return false;
+
+	const uint8_t *const a = m_bytes.beginTyped<uint8_t>(), *const b = other.m_bytes.beginTyped<uint8_t>();
+	const size_t full_bytes = m_length / 8;
+
+	if( memcmp( a, b, full_bytes ) != 0 )
+		return false;
+
+	const uint8_t mask = 0xFF << ( 8 - m_length % 8 );
+	return m_length % 8 == 0 || ( a[full_bytes] & mask ) == ( b[full_bytes] & mask );
+}
+
+BitArray operator&( const BitArray &a, const BitArray &b ) {return a.copy() &= b;}
+BitArray operator|( const BitArray &a, const BitArray &b ) {return a.copy() |= b;}
+BitArray operator^( const BitArray &a, const BitArray &b ) {return a.copy() ^= b;}
+}
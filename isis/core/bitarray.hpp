@@ -0,0 +1,161 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2020  <copyright holder> <email>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "valuearray_typed.hpp"
+
+namespace isis::data
+{
+/**
+ * Bit packed array of boolean values.
+ * The bits are stored most significant bit first in each byte (the layout of NIfTI DT_BINARY), so bit i is
+ * (bytes[i/8] >> (7 - i%8)) & 1.
+ * Like ValueArray copies are cheap and share the memory, use copy() for a deep copy.
+ * The logical operations and count() work on whole 64bit words, packing and unpacking are done in parallel for
+ * big arrays.
+ */
+class BitArray
+{
+	TypedArray<uint8_t> m_bytes;
+	size_t m_length = 0;
+
+	template<bool IS_CONST> class Iterator;
+public:
+	/// reference to a single bit
+	class reference
+	{
+		uint8_t *m_byte;
+		uint8_t m_mask;
+	public:
+		reference( uint8_t *byte, uint8_t mask ): m_byte( byte ), m_mask( mask ) {}
+		operator bool()const {return *m_byte & m_mask;}
+		reference &operator=( bool value ) {
+			if( value )
+				*m_byte |= m_mask;
+			else
+				*m_byte &= ~m_mask;
+
+			return *this;
+		}
+		reference &operator=( const reference &other ) {return *this = bool( other );}
+	};
+	typedef Iterator<false> iterator;
+	typedef Iterator<true> const_iterator;
+
+	/// create an empty array
+	BitArray() = default;
+	/// create an array of length bits which are all false
+	explicit BitArray( size_t length );
+	/**
+	 * Create a bit array from packed bytes without copying them (e.g. from a FilePtr).
+	 * \param bytes the packed bits, must have at least (length+7)/8 elements
+	 * \param length the amount of bits
+	 */
+	BitArray( const TypedArray<uint8_t> &bytes, size_t length );
+	/// create a bit array with the bits set where values is not zero (values must be of a scalar type)
+	explicit BitArray( const ValueArray &values );
+
+	[[nodiscard]] size_t getLength()const {return m_length;}
+	/// the packed bytes (not a copy)
+	[[nodiscard]] const TypedArray<uint8_t> &bytes()const {return m_bytes;}
+	/// a deep copy
+	[[nodiscard]] BitArray copy()const;
+
+	bool operator[]( size_t at )const {return m_bytes.beginTyped<uint8_t>()[at / 8] & ( 0x80 >> ( at % 8 ) );}
+	reference operator[]( size_t at ) {return {m_bytes.beginTyped<uint8_t>() + at / 8, uint8_t( 0x80 >> ( at % 8 ) )};}
+
+	iterator begin();
+	iterator end();
+	const_iterator begin()const;
+	const_iterator end()const;
+
+	/**
+	 * Set the bits where values is not zero (and clear the others).
+	 * \param values the values to pack, must be of a scalar type and must have the length of this array
+	 */
+	void pack( const ValueArray &values );
+	/// unpack the bits into a new array of the given scalar type containing 0 and 1
+	[[nodiscard]] ValueArray unpack( unsigned short ID = util::typeID<bool>() )const;
+	template<typename T> [[nodiscard]] TypedArray<T> unpack()const {return TypedArray<T>( unpack( util::typeID<T>() ) );}
+	/**
+	 * Unpack the bits into an existing array of a scalar type.
+	 * dst must have the length of this array.
+	 */
+	void unpackTo( ValueArray &dst )const;
+
+	/// the amount of set bits
+	[[nodiscard]] size_t count()const;
+	[[nodiscard]] bool any()const {return count() > 0;}
+	[[nodiscard]] bool none()const {return !any();}
+
+	/// invert all bits
+	BitArray &flip();
+	/// \throws std::invalid_argument if the lengths of the arrays differ
+	BitArray &operator&=( const BitArray &other );
+	/// \throws std::invalid_argument if the lengths of the arrays differ
+	BitArray &operator|=( const BitArray &other );
+	/// \throws std::invalid_argument if the lengths of the arrays differ
+	BitArray &operator^=( const BitArray &other );
+	BitArray operator~()const;
+
+	bool operator==( const BitArray &other )const;
+};
+
+BitArray operator&( const BitArray &a, const BitArray &b );
+BitArray operator|( const BitArray &a, const BitArray &b );
+BitArray operator^( const BitArray &a, const BitArray &b );
+
+template<bool IS_CONST> class BitArray::Iterator
+{
+	typedef std::conditional_t<IS_CONST, const uint8_t *, uint8_t *> pointer_type;
+	pointer_type m_bytes = nullptr;
+	ptrdiff_t m_pos = 0;
+public:
+	typedef std::random_access_iterator_tag iterator_category;
+	typedef bool value_type;
+	typedef ptrdiff_t difference_type;
+	typedef std::conditional_t<IS_CONST, bool, BitArray::reference> reference;
+	typedef void pointer;
+
+	Iterator() = default;
+	Iterator( pointer_type bytes, ptrdiff_t pos ): m_bytes( bytes ), m_pos( pos ) {}
+	operator Iterator<true>()const {return {m_bytes, m_pos};}
+
+	reference operator*()const {
+		if constexpr( IS_CONST )
+			return m_bytes[m_pos / 8] & ( 0x80 >> ( m_pos % 8 ) );
+		else
+			return {m_bytes + m_pos / 8, uint8_t( 0x80 >> ( m_pos % 8 ) )};
+	}
+	reference operator[]( difference_type n )const {return *( *this + n );}
+
+	Iterator &operator++() {++m_pos; return *this;}
+	Iterator &operator--() {--m_pos; return *this;}
+	Iterator operator++( int ) {Iterator ret = *this; ++m_pos; return ret;}
+	Iterator operator--( int ) {Iterator ret = *this; --m_pos; return ret;}
+	Iterator &operator+=( difference_type n ) {m_pos += n; return *this;}
+	Iterator &operator-=( difference_type n ) {m_pos -= n; return *this;}
+	Iterator operator+( difference_type n )const {return {m_bytes, m_pos + n};}
+	Iterator operator-( difference_type n )const {return {m_bytes, m_pos - n};}
+	difference_type operator-( const Iterator &other )const {return m_pos - other.m_pos;}
+
+	bool operator==( const Iterator &other )const {return m_bytes == other.m_bytes && m_pos == other.m_pos;}
+	auto operator<=>( const Iterator &other )const {return m_pos <=> other.m_pos;}
+};
+}
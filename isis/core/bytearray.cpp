@@ -19,6 +19,14 @@
 
 #include "bytearray.hpp"
 #include "color.hpp"
+#include "common.hpp"
+#include <cmath>
+#include <utility>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 namespace isis::data{
 
@@ -26,8 +34,11 @@ namespace _internal {
 
 typedef std::function<data::ValueArray(data::ByteArray &, size_t, size_t, bool )> generator_fn;
 
+// indexed by the isis-typeID, empty for types that are no array types
+typedef std::array<generator_fn, util::Value::NumOfTypes> generator_table;
+
 template<int ID=std::variant_size_v<ArrayTypes>-1>
-void make_generators(std::map<unsigned short, generator_fn>& map) { //The ID here is the index in ArrayTypes, NOT the isis-typeID
+void make_generators(generator_table& map) { //The ID here is the index in ArrayTypes, NOT the isis-typeID
 	typedef typename std::variant_alternative_t<ID,ArrayTypes>::element_type element_type; //get the arrays' element type
 	constexpr size_t index=util::typeID<element_type>();//get the isis-typeID of the element type
 
@@ -36,14 +47,41 @@ void make_generators(std::map<unsigned short, generator_fn>& map) { //The ID her
 	};
 	make_generators<ID-1>(map);//recursion
 }
-template<> void make_generators<-1>(std::map<unsigned short, generator_fn>&) {}//terminator
+template<> void make_generators<-1>(generator_table&) {}//terminator
 
-struct GeneratorMap: public std::map<unsigned short, generator_fn> {
+// filled once and never changed afterwards, so it can be read from any thread
+struct GeneratorMap: public generator_table {
 	GeneratorMap(){
 		make_generators(*this);
 	}
 };
 
+constexpr size_t convert_block = 4096; // elements swapped and converted in one go (small enough to stay in the cache)
+
+template<typename DST, typename SRC> DST convertValue( SRC value, bool scale, double scale_factor, double scale_offset )
+{
+	typedef std::numeric_limits<DST> limits;
+
+	if constexpr( std::is_same_v<DST, bool> ) {
+		return scale ? value * scale_factor + scale_offset != 0 : value != 0;
+	} else if constexpr( std::is_integral_v<DST> ) {
+		if constexpr( std::is_integral_v<SRC> && !std::is_same_v<SRC, bool> ) {
+			if( !scale ) // stay in the integer domain
+				return std::cmp_less( value, limits::lowest() ) ? limits::lowest() : std::cmp_greater( value, limits::max() ) ? limits::max() : DST( value );
+		}
+
+		const double scaled = std::round( scale ? value * scale_factor + scale_offset : double( value ) );
+
+		if( std::isnan( scaled ) ) // has no integer counterpart (and casting it would be undefined)
+			return DST( 0 );
+
+		// double(limits::max()) might be rounded up for 64bit types, so check with >=
+		return scaled <= double( limits::lowest() ) ? limits::lowest() : scaled >= double( limits::max() ) ? limits::max() : DST( scaled );
+	} else {
+		return scale ? DST( value * scale_factor + scale_offset ) : DST( value );
+	}
+}
+
 
 }
 
@@ -54,12 +92,94 @@ ByteArray::ByteArray(const TypedArray<uint8_t> &ref):TypedArray<uint8_t>(ref){}
 ValueArray ByteArray::atByID(unsigned short ID, std::size_t offset, std::size_t len, bool swap_endianess)
 {
 	LOG_IF(!isValid(), Debug, error ) << "There is no mapped data for this ByteArray - I'm very likely gonna crash soon ..";
-	auto &map = util::Singletons::get<_internal::GeneratorMap, 0>();
-	assert( !map.empty() );
-	const _internal::generator_fn gen = map[ID];
-	assert( gen );
-	return gen( *this, offset, len, swap_endianess );
+	const auto &map = util::Singletons::get<_internal::GeneratorMap, 0>();
+	assert( ID < map.size() && map[ID] );
+	return map[ID]( *this, offset, len, swap_endianess );
 }
 
+ValueArray ByteArray::convertByID(unsigned short srcID, unsigned short dstID, size_t offset, size_t len, bool swap_endianess, const scaling_pair &scaling)
+{
+	const ValueArray src = atByID( srcID, offset, len, false ); // just a view, swapping is done block wise below
+	ValueArray dst = ValueArray::createByID( dstID, src.getLength() );
+	const bool swap = swap_endianess && !writing;
+	const bool scale = scaling.isRelevant();
+	const double scale_factor = scale ? scaling.scale.as<double>() : 1, scale_offset = scale ? scaling.offset.as<double>() : 0;
+
+	for( const ValueArray *array : {&src, static_cast<const ValueArray *>( &dst )} ) {
+		if( !array->visit( []( auto ptr ) {return std::is_arithmetic_v<typename decltype( ptr )::element_type>;} ) ) {
+			LOG( Runtime, error ) << "Cannot convert " << src.typeName() << " into " << dst.typeName() << " on the fly, only scalar types are supported";
+			throw std::domain_error( "Unsupported datatype" );
+		}
+	}
+
+	src.visit( [&]( auto s ) {
+		typedef typename decltype( s )::element_type src_type;
+		dst.visit( [&]( auto d ) {
+			typedef typename decltype( d )::element_type dst_type;
+
+			if constexpr( std::is_arithmetic_v<src_type> && std::is_arithmetic_v<dst_type> ) {
+				const src_type *const in = s.get();
+				dst_type *const out = d.get();
+				util::parallelFor( ( src.getLength() + _internal::convert_block - 1 ) / _internal::convert_block, [&]( size_t begin, size_t end ) {
+					src_type buffer[_internal::convert_block];
+
+					for( size_t b = begin * _internal::convert_block; b < std::min( end * _internal::convert_block, src.getLength() ); b += _internal::convert_block ) {
+						const size_t n = std::min( _internal::convert_block, src.getLength() - b );
+						const src_type *values = in + b;
+
+						if( swap && sizeof( src_type ) > 1 ) { // swap into the (cached) buffer
+							endianSwapArray( values, values + n, buffer );
+							values = buffer;
+						}
+
+						for( size_t i = 0; i < n; i++ )
+							out[b + i] = _internal::convertValue<dst_type>( values[i], scale, scale_factor, scale_offset );
+					}
+				} );
+			}
+		} );
+	} );
+	return dst;
+}
+
+bool ByteArray::advise( Access pattern, size_t offset, size_t length )const
+{
+	if( offset >= getLength() )
+		return false;
+
+	if( length == 0 || length > getLength() - offset )
+		length = getLength() - offset;
+
+#ifdef WIN32
+	return false;
+#else
+	int advice;
+
+	switch( pattern ) {
+	case Access::normal:advice = MADV_NORMAL;break;
+	case Access::sequential:advice = MADV_SEQUENTIAL;break;
+	case Access::random:advice = MADV_RANDOM;break;
+	case Access::willneed:advice = MADV_WILLNEED;break;
+	case Access::hugepage:
+#ifdef MADV_HUGEPAGE
+		advice = MADV_HUGEPAGE;break;
+#else
+		return false;
+#endif
+	}
+
+	// madvise wants the start to be page aligned
+	static const uintptr_t page_size = sysconf( _SC_PAGESIZE );
+	const uintptr_t start = reinterpret_cast<uintptr_t>( static_cast<const uint8_t *>( getRawAddress().get() ) + offset ), aligned = start & ~( page_size - 1 );
+
+	if( madvise( reinterpret_cast<void *>( aligned ), length + ( start - aligned ), advice ) != 0 ) {
+		LOG( Debug, info ) << "madvise for " << length << " bytes at " << reinterpret_cast<const void *>( start ) << " failed, the error was: " << util::getLastSystemError();
+		return false;
+	}
+
+	return true;
+#endif
+}
+bool ByteArray::prefetch( size_t offset, size_t length )const {return advise( Access::willneed, offset, length );}
 
 }
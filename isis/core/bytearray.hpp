@@ -29,6 +29,9 @@ protected:
 	bool writing=false; // for derived classes to flag memory as actually writing to (mapped) file (disables endian swap)
 
 public:
+	/// expected access patterns for advise
+	enum class Access {normal, sequential, random, willneed, hugepage};
+
 	ByteArray()=default;
 	ByteArray(const ByteArray &src)=default;
 	/**
@@ -82,7 +85,7 @@ public:
 		} else { // flip bytes into a new ValueArray
 			LOG( Debug, verbose_info ) << "Byte swapping " <<  util::typeName<T>() << " for endianness";
 			TypedArray<T> ret=ValueArray::make<T>(len );
-			data::endianSwapArray( ptr.get(), ptr.get() + std::min( len, getLength() / sizeof( T ) ), ret.begin() );
+			data::endianSwapArray( ptr.get(), ptr.get() + std::min( len, getLength() / sizeof( T ) ), ret.template beginTyped<T>() );
 			return ret;
 		}
 	}
@@ -98,6 +101,44 @@ public:
 	 * \param swap_endianess if endianess should be swapped when reading data file (ignored when used on files opened for writing)
 	 */
 	data::ValueArray atByID(unsigned short ID, size_t offset, size_t len = 0, bool swap_endianess = false );
+	/**
+	 * Get the data at offset converted into a new ValueArray.
+	 * Swapping (if requested) and conversion are done in small blocks in one go, so the source is read only once
+	 * instead of being swapped into a temporary array that is then converted.
+	 * If a writable mapping is to be swapped in place use atByID and ValueArray::endianSwap instead.
+	 * \param srcID the type of the data in the source
+	 * \param dstID the requested type
+	 * \param offset the position in the file to start from (in bytes)
+	 * \param len the requested length of the resulting ValueArray in elements (0 for all remaining data)
+	 * \param swap_endianess if endianess should be swapped before the conversion (ignored when used on files opened for writing)
+	 * \param scaling if valid and relevant the values are transformed into value*scale+offset, there is no automatic scaling
+	 * (results for integer types are rounded and clamped to the range of the type)
+	 * \throws std::domain_error if srcID or dstID are not scalar types
+	 */
+	data::ValueArray convertByID(unsigned short srcID, unsigned short dstID, size_t offset, size_t len = 0, bool swap_endianess = false, const scaling_pair &scaling = scaling_pair() );
+	/**
+	 * Tell the kernel how the memory is going to be accessed.
+	 * This is meant for data mapped from a file (see FilePtr). sequential makes the kernel read ahead aggressively
+	 * and drop pages behind, random stops useless readahead and willneed starts reading in the background.
+	 * hugepage asks for the memory to be backed by huge pages.
+	 * The advice applies to all pages touched by the range. It's only a hint and has hardly any effect on memory
+	 * that is not mapped from a file.
+	 * \param pattern the expected access pattern
+	 * \param offset the start of the range (in bytes)
+	 * \param length the length of the range in bytes (0 for all remaining data)
+	 * \returns false if the kernel didn't take the advice
+	 */
+	bool advise( Access pattern, size_t offset = 0, size_t length = 0 )const;
+	/**
+	 * Start reading a range of a mapped file in the background.
+	 * Plugins can issue this ahead of decoding, so the data is there when it's needed.
+	 * Same as advise( Access::willneed, offset, length ).
+	 */
+	bool prefetch( size_t offset = 0, size_t length = 0 )const;
+	/// \copydoc convertByID
+	template<KnownArrayType T> TypedArray<T> convertAt(unsigned short srcID, size_t offset, size_t len = 0, bool swap_endianess = false, const scaling_pair &scaling = scaling_pair() ){
+		return TypedArray<T>( convertByID( srcID, util::typeID<T>(), offset, len, swap_endianess, scaling ) );
+	}
 };
 }
 
@@ -161,7 +161,7 @@ size_t Chunk::compareRange( const std::array<size_t,4> &source_start, const std:
 size_t Chunk::compare( const isis::data::Chunk &dst ) const
 {
 	if( getSizeAsVector() == dst.getSizeAsVector() )
-		return ValueArray::compare(0, getVolume() - 1, dst, 0 );
+		return ValueArray::compare(0, getVolume(), dst, 0 );
 	else
 		return std::max( getVolume(), dst.getVolume() );
 }
@@ -278,40 +278,109 @@ std::list<Chunk> Chunk::spliceAt (dimensions atDim, util::PropertyMap &&propSour
 	return ret;
 }
 
-void Chunk::flipAlong( const dimensions dim )
+namespace
 {
-	const size_t elSize = getBytesPerVoxel();
-	const util::vector4<size_t> whole_size = getSizeAsVector();
+constexpr size_t swap_buffer_size = 64 * 1024; // bytes
+constexpr size_t roll_buffer_size = 16 * 1024 * 1024; // bytes, bigger rolls are done by std::rotate
+
+/// the chunk as seen from dim: [outer][length][block] elements
+struct DimLayout {
+	size_t block = 1, length, outer = 1;
+	DimLayout( const util::vector4<size_t> &size, dimensions dim ): length( size[dim] ) {
+		for( int d = 0; d < dim; d++ )
+			block *= size[d];
+		for( int d = dim + 1; d < 4; d++ )
+			outer *= size[d];
+	}
+};
 
-	auto swap_ptr = std::static_pointer_cast<uint8_t>( getRawAddress() );
-	uint8_t *swap_start = swap_ptr.get();
-	const uint8_t *const swap_end = swap_start + whole_size.product() * elSize;
+void forRange( size_t count, bool parallel, const std::function<void( size_t begin, size_t end )> &op )
+{
+	if( parallel )
+		util::parallelFor( count, op );
+	else
+		op( 0, count );
+}
 
-	size_t block_volume = whole_size.product();
+/// swap two non-overlapping memory ranges through a small buffer
+void swapBytes( uint8_t *a, uint8_t *b, size_t len, uint8_t *buffer )
+{
+	for( size_t pos = 0; pos < len; pos += swap_buffer_size ) {
+		const size_t n = std::min( swap_buffer_size, len - pos );
+		memcpy( buffer, a + pos, n );
+		memcpy( a + pos, b + pos, n );
+		memcpy( b + pos, buffer, n );
+	}
+}
+}
 
-	for( int i = data::timeDim; i >= dim; i-- ) {
-		assert( ( block_volume % whole_size[i] ) == 0 );
-		block_volume /= whole_size[i];
+void Chunk::flipAlong( const dimensions dim )
+{
+	const DimLayout layout( getSizeAsVector(), dim );
+	const bool parallel = getVolume() * getBytesPerVoxel() >= parallel_bytes;
+
+	if( layout.block == 1 ) { // reverse the rows (typed, so the compiler can use shuffles)
+		visit( [&]( auto ptr ) {
+			auto *const data = ptr.get();
+			forRange( layout.outer, parallel, [&]( size_t begin, size_t end ) {
+				for( size_t o = begin; o < end; o++ )
+					std::reverse( data + o * layout.length, data + ( o + 1 ) * layout.length );
+			} );
+		} );
+	} else { // swap each block with the one at the opposite end
+		const size_t block_bytes = layout.block * getBytesPerVoxel();
+		const size_t pairs = layout.length / 2;
+		const auto data_ptr = std::static_pointer_cast<uint8_t>( getRawAddress() );
+		uint8_t *const data = data_ptr.get();
+
+		forRange( layout.outer * pairs, parallel, [&]( size_t begin, size_t end ) {
+			std::vector<uint8_t> buffer( std::min( swap_buffer_size, block_bytes ) );
+
+			for( size_t job = begin; job < end; job++ ) {
+				const size_t o = job / pairs, i = job % pairs;
+				uint8_t *const start = data + o * layout.length * block_bytes;
+				swapBytes( start + i * block_bytes, start + ( layout.length - 1 - i ) * block_bytes, block_bytes, buffer.data() );
+			}
+		} );
 	}
+}
 
-	assert( block_volume );
-	block_volume *= elSize;
-	const size_t swap_volume = block_volume * whole_size[dim];
-	uint8_t buff[ block_volume ];
-
-	//iterate over all swap-volumes
-	for( ; swap_start < swap_end; swap_start += swap_volume ) { //outer loop
-		// swap each block with the one at the oppsite end of the swap_volume
-		uint8_t *a = swap_start; //first block
-		uint8_t *b = swap_start + swap_volume - block_volume; //last block within the swap-volume
-
-		for( ; a < b; a += block_volume, b -= block_volume ) { // grow a, shrink b (inner loop)
-			memcpy( buff, a, block_volume );
-			memcpy( a, b, block_volume );
-			memcpy( b, buff, block_volume );
+void Chunk::rollAlong( const dimensions dim, ptrdiff_t shift )
+{
+	const DimLayout layout( getSizeAsVector(), dim );
+	shift %= ptrdiff_t( layout.length );
+	if( shift < 0 )
+		shift += layout.length;
+	if( shift == 0 )
+		return;
+
+	const size_t block_bytes = layout.block * getBytesPerVoxel();
+	const size_t run_bytes = layout.length * block_bytes;
+	const size_t tail_bytes = shift * block_bytes; // the part at the end which moves to the front
+	const bool buffered = std::min( tail_bytes, run_bytes - tail_bytes ) <= roll_buffer_size;
+	const auto data_ptr = std::static_pointer_cast<uint8_t>( getRawAddress() );
+	uint8_t *const data = data_ptr.get();
+
+	forRange( layout.outer, getVolume() * getBytesPerVoxel() >= parallel_bytes, [&]( size_t begin, size_t end ) {
+		std::vector<uint8_t> buffer( buffered ? std::min( tail_bytes, run_bytes - tail_bytes ) : 0 );
+
+		for( size_t o = begin; o < end; o++ ) {
+			uint8_t *const run = data + o * run_bytes;
+
+			if( !buffered ) {
+				std::rotate( run, run + run_bytes - tail_bytes, run + run_bytes );
+			} else if( tail_bytes <= run_bytes - tail_bytes ) { // move the tail through the buffer
+				memcpy( buffer.data(), run + run_bytes - tail_bytes, tail_bytes );
+				memmove( run + tail_bytes, run, run_bytes - tail_bytes );
+				memcpy( run, buffer.data(), tail_bytes );
+			} else { // move the head through the buffer
+				const size_t head_bytes = run_bytes - tail_bytes;
+				memcpy( buffer.data(), run, head_bytes );
+				memmove( run, run + head_bytes, tail_bytes );
+				memcpy( run + tail_bytes, buffer.data(), head_bytes );
+			}
 		}
-
-	}
+	} );
 }
 
 void Chunk::swapDim( unsigned short dim_a,unsigned short dim_b, std::shared_ptr<util::ProgressFeedback> feedback)
@@ -226,11 +226,24 @@ public:
 	std::list<Chunk> spliceAt(isis::data::dimensions atDim)const;
 	std::list<Chunk> spliceAt(isis::data::dimensions atDim, util::PropertyMap &&propSource )const;
 
+	/// chunks of at least this many bytes are flipped/rolled in parallel
+	static constexpr size_t parallel_bytes = 1024 * 1024;
+
 	/**
 	  * Flips the chunk along a dimension dim in image space.
+	  * This is done in place, for any type of voxels.
 	  */
 	void flipAlong( const dimensions dim );
 
+	/**
+	 * Circularly shift the voxels of the chunk along a dimension dim in image space.
+	 * The voxel at position i along dim is moved to (i + shift) modulo the size of dim.
+	 * This is done in place, for any type of voxels.
+	 * \param dim the dimension to shift along
+	 * \param shift the distance to shift (negative values shift towards the begin)
+	 */
+	void rollAlong( const dimensions dim, ptrdiff_t shift );
+
 	//http://en.wikipedia.org/wiki/In-place_matrix_transposition#Non-square_matrices%3a_Following_the_cycles
 	void swapDim(unsigned short dim_a,unsigned short dim_b,std::shared_ptr<util::ProgressFeedback> feedback=std::shared_ptr<util::ProgressFeedback>());
 
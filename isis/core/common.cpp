@@ -1,5 +1,7 @@
 #include "common.hpp"
 #include <cstring>
+#include <mutex>
+#include <thread>
 
 namespace isis::util
 {
@@ -30,6 +32,36 @@ std::string getLastSystemError()
 	return strerror( errno );
 #endif
 }
+void parallelFor(size_t count, const std::function<void(size_t begin, size_t end)> &op)
+{
+	const size_t threads = std::min<size_t>( count, std::max( 1u, std::thread::hardware_concurrency() ) );
+
+	if( threads < 2 ) {
+		op( 0, count );
+		return;
+	}
+
+	// exceptions can't leave a thread, so the first one is kept and rethrown once all parts are done
+	std::exception_ptr error;
+	std::mutex error_lock;
+	{
+		std::vector<std::jthread> pool;
+		pool.reserve( threads );
+		for( size_t t = 0; t < threads; t++ )
+			pool.emplace_back( [&, begin = count * t / threads, end = count * ( t + 1 ) / threads]() {
+				try {
+					op( begin, end );
+				} catch( ... ) {
+					const std::lock_guard<std::mutex> guard( error_lock );
+					if( !error )
+						error = std::current_exception();
+				}
+			} );
+	} // joins the threads
+
+	if( error )
+		std::rethrow_exception( error );
+}
 ///in a list of paths shorten those paths until they are equal
 std::filesystem::path getRootPath(std::list< std::filesystem::path > sources,bool sorted)
 {
@@ -28,6 +28,7 @@
 #include "../config.hpp"
 #include <charconv>
 #include <complex>
+#include <functional>
 
 #ifdef WIN32
 #include <Windows.h>
@@ -65,6 +66,16 @@ continousFind(ForwardIterator &current, const ForwardIterator end, const T &comp
 }
 
 std::string getLastSystemError();
+
+/**
+ * Run op on consecutive ranges of [0,count) in parallel.
+ * The range is split into one part per hardware thread (or less if count is smaller) and the call blocks until all parts are done.
+ * If op throws, the first exception is rethrown once all parts are done (as it would be if op was called directly).
+ * \param count the size of the whole range
+ * \param op the function to run on each part, it gets the begin and the end of its part
+ */
+void parallelFor(size_t count, const std::function<void(size_t begin, size_t end)> &op);
+
 std::filesystem::path getRootPath(std::list<std::filesystem::path> sources, bool sorted = false);
 
 std::filesystem::path pathReduce(std::set<std::filesystem::path> sources);
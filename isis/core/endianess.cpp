@@ -0,0 +1,136 @@
+#include "endianess.hpp"
+
+#include <cstring>
+#include <algorithm>
+#include <array>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ISIS_SWAP_X86 1
+#include <immintrin.h>
+#endif
+
+namespace isis::data::_internal
+{
+API_EXCLUDE_BEGIN;
+namespace
+{
+typedef void ( *swap_kernel )( const uint8_t *src, uint8_t *dst, size_t bytes, uint_fast8_t unit_size );
+
+template<typename T, T( *SWAP )( T )> void swapScalars( const uint8_t *src, uint8_t *dst, size_t bytes )
+{
+	for( size_t i = 0; i + sizeof( T ) <= bytes; i += sizeof( T ) ) {
+		T value;
+		memcpy( &value, src + i, sizeof( T ) ); // memcpy as neither src nor dst need to be aligned
+		value = SWAP( value );
+		memcpy( dst + i, &value, sizeof( T ) );
+	}
+}
+uint16_t bswap16( uint16_t v ) {return __builtin_bswap16( v );}
+uint32_t bswap32( uint32_t v ) {return __builtin_bswap32( v );}
+uint64_t bswap64( uint64_t v ) {return __builtin_bswap64( v );}
+
+void swapScalar( const uint8_t *src, uint8_t *dst, size_t bytes, uint_fast8_t unit_size )
+{
+	switch( unit_size ) {
+	case 2:
+		swapScalars<uint16_t, bswap16>( src, dst, bytes );
+		break;
+	case 4:
+		swapScalars<uint32_t, bswap32>( src, dst, bytes );
+		break;
+	case 8:
+		swapScalars<uint64_t, bswap64>( src, dst, bytes );
+		break;
+	default: // odd sizes (e.g. long double)
+		for( size_t i = 0; i + unit_size <= bytes; i += unit_size )
+			if( src == dst ) {
+				std::reverse( dst + i, dst + i + unit_size );
+			} else {
+				std::reverse_copy( src + i, src + i + unit_size, dst + i );
+			}
+	}
+}
+
+#ifdef ISIS_SWAP_X86
+// shuffle mask reversing the bytes of each unit within 16 bytes
+std::array<uint8_t, 16> shuffleMask( uint_fast8_t unit_size )
+{
+	std::array<uint8_t, 16> ret;
+
+	for( uint8_t i = 0; i < 16; i++ )
+		ret[i] = i / unit_size * unit_size + unit_size - 1 - i % unit_size;
+
+	return ret;
+}
+
+__attribute__( ( target( "ssse3" ) ) ) void swapSSSE3( const uint8_t *src, uint8_t *dst, size_t bytes, uint_fast8_t unit_size )
+{
+	const std::array<uint8_t, 16> m = shuffleMask( unit_size );
+	const __m128i mask = _mm_loadu_si128( reinterpret_cast<const __m128i *>( m.data() ) );
+	size_t i = 0;
+
+	for( ; i + 16 <= bytes; i += 16 ) {
+		const __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i *>( src + i ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( dst + i ), _mm_shuffle_epi8( v, mask ) );
+	}
+
+	swapScalar( src + i, dst + i, bytes - i, unit_size );
+}
+
+__attribute__( ( target( "avx2" ) ) ) void swapAVX2( const uint8_t *src, uint8_t *dst, size_t bytes, uint_fast8_t unit_size )
+{
+	// vpshufb shuffles within the two 128bit lanes, which is fine as units never cross them
+	const std::array<uint8_t, 16> m = shuffleMask( unit_size );
+	const __m256i mask = _mm256_broadcastsi128_si256( _mm_loadu_si128( reinterpret_cast<const __m128i *>( m.data() ) ) );
+	size_t i = 0;
+
+	for( ; i + 64 <= bytes; i += 64 ) {
+		const __m256i a = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( src + i ) );
+		const __m256i b = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( src + i + 32 ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i *>( dst + i ), _mm256_shuffle_epi8( a, mask ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i *>( dst + i + 32 ), _mm256_shuffle_epi8( b, mask ) );
+	}
+
+	for( ; i + 32 <= bytes; i += 32 ) {
+		const __m256i v = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( src + i ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i *>( dst + i ), _mm256_shuffle_epi8( v, mask ) );
+	}
+
+	swapScalar( src + i, dst + i, bytes - i, unit_size );
+}
+#endif //ISIS_SWAP_X86
+
+swap_kernel selectKernel()
+{
+#ifdef ISIS_SWAP_X86
+	__builtin_cpu_init();
+
+	if( __builtin_cpu_supports( "avx2" ) ) {
+		LOG( Debug, info ) << "Using AVX2 for byte swapping";
+		return swapAVX2;
+	} else if( __builtin_cpu_supports( "ssse3" ) ) {
+		LOG( Debug, info ) << "Using SSSE3 for byte swapping";
+		return swapSSSE3;
+	}
+#endif
+	return swapScalar;
+}
+}
+API_EXCLUDE_END;
+
+void swapBytes( const void *src, void *dst, size_t count, uint_fast8_t unit_size )
+{
+	const uint8_t *const s = static_cast<const uint8_t *>( src );
+	uint8_t *const d = static_cast<uint8_t *>( dst );
+
+	if( unit_size == 1 ) {
+		if( s != d )
+			memcpy( d, s, count );
+	} else if( unit_size == 2 || unit_size == 4 || unit_size == 8 ) {
+		static const swap_kernel kernel = selectKernel();
+		kernel( s, d, count * unit_size, unit_size );
+	} else {
+		swapScalar( s, d, count * unit_size, unit_size );
+	}
+}
+}
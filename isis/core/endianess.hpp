@@ -3,6 +3,7 @@
 #include "value.hpp"
 #include "common.hpp"
 #include <type_traits>
+#include <complex>
 
 namespace isis
 {
@@ -97,6 +98,43 @@ template<typename TYPE, size_t SIZE> struct EndianSwapper<std::array<TYPE, SIZE>
 		return ret;
 	}
 };
+template<typename TYPE, size_t SIZE> struct EndianSwapper<util::vector<TYPE, SIZE>, false> {
+	static util::vector<TYPE, SIZE> swap( const util::vector<TYPE, SIZE> &src ) {
+		util::vector<TYPE, SIZE> ret;
+		std::transform( src.begin(), src.end(), ret.begin(), EndianSwapper<TYPE, std::is_arithmetic<TYPE>::value>::swap );
+		return ret;
+	}
+};
+
+// complex - swap real and imaginary part
+template<typename TYPE> struct EndianSwapper<std::complex<TYPE>, false> {
+	static std::complex<TYPE> swap( const std::complex<TYPE> &src ) {
+		return {SwapImpl<sizeof( TYPE )>::doSwap( src.real() ), SwapImpl<sizeof( TYPE )>::doSwap( src.imag() )};
+	}
+};
+
+// the scalar type a type is made of (if it is just a packed set of them), that's what the bulk swap works on
+template<typename TYPE> struct SwapUnit {typedef void type;};
+template<typename TYPE> requires std::is_arithmetic_v<TYPE> struct SwapUnit<TYPE> {typedef TYPE type;};
+template<typename TYPE> struct SwapUnit<std::complex<TYPE>> {typedef TYPE type;};
+template<typename TYPE> struct SwapUnit<util::color<TYPE>> {typedef TYPE type;};
+template<typename TYPE, size_t SIZE> struct SwapUnit<std::array<TYPE, SIZE>> {typedef TYPE type;};
+template<typename TYPE, size_t SIZE> struct SwapUnit<util::vector<TYPE, SIZE>> {typedef TYPE type;};
+
+template<typename TYPE> constexpr bool bulk_swappable = [] {
+	typedef typename SwapUnit<TYPE>::type unit;
+	if constexpr( std::is_void_v<unit> )
+		return false;
+	else
+		return sizeof( TYPE ) % sizeof( unit ) == 0 && std::is_trivially_copyable_v<TYPE>;
+}();
+
+/**
+ * Reverse the byte order of count scalars of unit_size bytes each.
+ * Uses SSSE3/AVX2 byte shuffles if the cpu has them (checked at runtime).
+ * src and dst may be the same (in-place swap), but must not overlap otherwise.
+ */
+void swapBytes( const void *src, void *dst, size_t count, uint_fast8_t unit_size );
 } //_internal
 /// @endcond _internal
 
@@ -105,10 +143,22 @@ template<typename T> static  T endianSwap( const T &var )
 {
 	return _internal::EndianSwapper<T, std::is_arithmetic< T >::value >::swap( var );
 }
+/**
+ * Swap the byte order of the elements in [begin,end) and store them at target.
+ * Contiguous arrays of scalars, colors, vectors and complex numbers are swapped by a vectorised kernel,
+ * begin and target may be the same for an in-place swap.
+ */
 template<typename ITER, typename TITER> static  void endianSwapArray( const ITER begin, const ITER end, TITER target )
 {
-	for( ITER i = begin; i != end; i++, target++ ) {
-		*target = endianSwap( *i );
+	typedef std::remove_cv_t<std::remove_pointer_t<ITER>> value_type;
+
+	if constexpr( std::is_pointer_v<ITER> && std::is_same_v<TITER, value_type *> && _internal::bulk_swappable<value_type> ) {
+		typedef typename _internal::SwapUnit<value_type>::type unit;
+		_internal::swapBytes( begin, target, ( end - begin ) * ( sizeof( value_type ) / sizeof( unit ) ), sizeof( unit ) );
+	} else {
+		for( ITER i = begin; i != end; i++, target++ ) {
+			*target = endianSwap( *i );
+		}
 	}
 }
 
@@ -11,18 +11,47 @@
 #ifdef WIN32
 #else
 #include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 
+#include <atomic>
 #include <iostream>
+#include <mutex>
 #include <fcntl.h>
 #include <unistd.h>
 #include "singletons.hpp"
+#include "tmpfile.hpp"
 
 #include <sys/time.h>
 #include <sys/resource.h>
 
 namespace isis::data
 {
+namespace
+{
+std::atomic<size_t> &mapThreshold()
+{
+	static std::atomic<size_t> threshold = []() -> size_t {
+		const char *env = getenv( "ISIS_MAP_THRESHOLD" );
+		return env ? strtoull( env, nullptr, 10 ) * 1024 : 2 * 1024 * 1024;
+	}();
+	return threshold;
+}
+std::mutex scratch_dir_lock;
+std::filesystem::path &scratchDir()
+{
+	static std::filesystem::path dir = []() -> std::filesystem::path {
+		const char *env = getenv( "ISIS_SCRATCH_DIR" );
+		if( env && *env )
+			return env;
+
+		std::error_code err;
+		const std::filesystem::path tmp = std::filesystem::temp_directory_path( err ); // TMPDIR or /tmp
+		return err ? std::filesystem::path( "/tmp" ) : tmp;
+	}();
+	return dir;
+}
+}
 
 rlim_t FilePtr::file_count=0;
 
@@ -70,11 +99,12 @@ bool FilePtr::map( _internal::FileHandle &&file, size_t len, bool write, const s
 	FILE_HANDLE mmaph = 0;
 	rlimit rlim;
 	getrlimit(RLIMIT_DATA,&rlim);
-	
-	if(rlim.rlim_cur<len){
+
+	// private writable mappings count as data, shared ones (used for writing) don't
+	if(!write && rlim.rlim_cur<len){
 		if(rlim.rlim_max>len){
 			rlim.rlim_cur=len;
-			setrlimit(RLIMIT_NOFILE, &rlim);
+			setrlimit(RLIMIT_DATA, &rlim);
 		} else {
 			LOG(Runtime,warning) << "Can't increase the limit for for mapped file size to " << len << ", this will crash..";
 		}
@@ -165,9 +195,12 @@ FilePtr::FilePtr(const std::filesystem::path &filename, size_t len, bool write,
 			return;
 		}
 
+#ifndef WIN32
+		posix_fadvise(file, 0, file_size, POSIX_FADV_SEQUENTIAL); // we read all of it in one go, so the kernel can read ahead further
+#endif
 		size_t read_pos=0;
 		while (read_pos<file_size){
-			const auto result = read(file,getRawAddress(read_pos).get(),file_size);
+			const auto result = read(file,getRawAddress(read_pos).get(),file_size-read_pos);
 			if(result>0) {
 				read_pos += result;
 			} else if(result==0) {
@@ -185,6 +218,77 @@ FilePtr::FilePtr(const std::filesystem::path &filename, size_t len, bool write,
 	// from here on the pointer will be set if mapping succeeded
 }
 
+FilePtr FilePtr::scratch( size_t len )
+{
+	FilePtr ret;
+
+	if( !checkLimit( 1 ) ) {
+		LOG( Runtime, error ) << "Can't open another scratch file, too many files are open already";
+		return ret;
+	}
+
+#ifndef WIN32
+	const std::filesystem::path dir = getScratchDir();
+	int handle = -1;
+#ifdef O_TMPFILE
+	handle = open( dir.c_str(), O_TMPFILE | O_RDWR | O_EXCL, S_IRUSR | S_IWUSR ); // a file without a name
+#endif
+
+	if( handle < 0 ) { // not supported by the filesystem, so make a named file and remove the name right away
+		std::string name = ( dir / "isis_XXXXXX.scratch" ).native();
+		handle = mkstemps( name.data(), 8 );
+
+		if( handle >= 0 )
+			unlink( name.c_str() );
+	}
+
+	if( handle < 0 ) {
+		const std::string create_error = util::getLastSystemError(); // before LOG can change errno
+		LOG( Runtime, error ) << "Failed to create a scratch file in " << dir << ", the error was: " << create_error;
+		return ret;
+	}
+
+	// reserve the space now, running out of it while writing into the mapping would kill us with SIGBUS
+	const int err = posix_fallocate( handle, 0, len );
+	void *const ptr = err ? MAP_FAILED : mmap( nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0 );
+	const std::string map_error = ptr == MAP_FAILED && !err ? util::getLastSystemError() : std::string(); // before close and LOG can change errno
+
+	// the mapping keeps the file alive on its own, so the handle is closed right away and many scratch files don't use up file descriptors
+	::close( handle );
+
+	if( err ) {
+		LOG( Runtime, error ) << "Failed to reserve " << len << " bytes for a scratch file in " << dir << ", the error was: " << strerror( err );
+		return ret;
+	} else if( ptr == MAP_FAILED ) {
+		LOG( Runtime, error ) << "Failed to map a scratch file in " << dir << ", the error was: " << map_error;
+		return ret;
+	}
+
+	const bool advised = madvise( ptr, len, MADV_SEQUENTIAL ) == 0; // not in LOG_IF, that would skip it if Debug is disabled
+	LOG_IF( !advised, Debug, warning ) << "madvise on a scratch file in " << dir << " failed, the error was: " << util::getLastSystemError();
+	static_cast<ByteArray &>( ret ) = ByteArray( std::shared_ptr<uint8_t>( static_cast<uint8_t *>( ptr ), [len]( uint8_t *p ) {munmap( p, len );} ), len );
+	ret.m_good = true;
+#else
+	const util::TmpFile file( ".scratch" ); // will be removed when leaving, the mapping stays valid
+	ret = FilePtr( file, len, true );
+#endif
+	return ret;
+}
+
+void FilePtr::setScratchDir( const std::filesystem::path &dir )
+{
+	const std::lock_guard<std::mutex> guard( scratch_dir_lock );
+	scratchDir() = dir;
+}
+std::filesystem::path FilePtr::getScratchDir()
+{
+	const std::lock_guard<std::mutex> guard( scratch_dir_lock );
+	return scratchDir();
+}
+
+void FilePtr::setMapThreshold( size_t bytes ) {mapThreshold() = bytes;}
+size_t FilePtr::getMapThreshold() {return mapThreshold();}
+
 bool FilePtr::good() const {
 	return m_good && getRawAddress();
 }
@@ -86,7 +86,33 @@ public:
 	 * \param write the file be opened for writing (writing to the mapped memory will write to the file, otherwise it will cause a copy-on-write)
 	 * \param mapsize size below which the file will actually be copied into memory (instead of being mapped). Applies only when write is false.
 	 */
-	explicit FilePtr(const std::filesystem::path &filename, size_t len = 0, bool write = false, size_t mapsize = 2*1024*1024);
+	explicit FilePtr(const std::filesystem::path &filename, size_t len = 0, bool write = false, size_t mapsize = getMapThreshold());
+
+	/**
+	 * Set the default for the size below which files are read into memory instead of being mapped.
+	 * Reading small files is cheaper than setting up (and tearing down) a mapping, mapping big files avoids copying them.
+	 * The default is 2MB, or taken from the environment variable ISIS_MAP_THRESHOLD (in KB) if that is set.
+	 */
+	static void setMapThreshold( size_t bytes );
+	static size_t getMapThreshold();
+
+	/**
+	 * Create a FilePtr on a new temporary file in the scratch directory (for data that shall not be kept in memory).
+	 * The space for the file is reserved right away. The file has no name (O_TMPFILE), or its name is removed right
+	 * after creating it, where the filesystem doesn't support that.
+	 * The memory stays valid (and backed by the file) until this and all ValueArray made from it are gone.
+	 * So the kernel can page it out into that file instead of the swap, which allows working on data larger than the
+	 * physical memory. The mapping is advised for sequential access.
+	 * \param len the size of the memory (and the file) in bytes
+	 * \returns the mapping, good() will be false if creating, reserving or mapping the file failed
+	 */
+	static FilePtr scratch( size_t len );
+	/**
+	 * Set the directory scratch files are made in.
+	 * The default is taken from the environment variable ISIS_SCRATCH_DIR, or from TMPDIR (then "/tmp") if that is not set.
+	 */
+	static void setScratchDir( const std::filesystem::path &dir );
+	static std::filesystem::path getScratchDir();
 
 	[[nodiscard]] bool good() const;
 	void release();
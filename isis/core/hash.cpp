@@ -0,0 +1,176 @@
+/*
+    Copyright (C) 2010  reimer@cbs.mpg.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "hash.hpp"
+#include "common.hpp"
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef HAVE_OPENSSL
+#include <openssl/evp.h>
+#endif
+
+namespace isis::util
+{
+namespace
+{
+constexpr uint64_t prime1 = 0x9E3779B185EBCA87ULL, prime2 = 0xC2B2AE3D27D4EB4FULL, prime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ULL, prime5 = 0x27D4EB2F165667C5ULL;
+
+uint64_t read64( const uint8_t *p ) {uint64_t ret; memcpy( &ret, p, 8 ); return ret;}
+uint32_t read32( const uint8_t *p ) {uint32_t ret; memcpy( &ret, p, 4 ); return ret;}
+
+uint64_t xxhRound( uint64_t acc, uint64_t input )
+{
+	acc += input * prime2;
+	return std::rotl( acc, 31 ) * prime1;
+}
+uint64_t xxhMerge( uint64_t acc, uint64_t value )
+{
+	acc ^= xxhRound( 0, value );
+	return acc * prime1 + prime4;
+}
+void xxhStripe( std::array<uint64_t, 4> &acc, const uint8_t *p )
+{
+	for( int i = 0; i < 4; i++ )
+		acc[i] = xxhRound( acc[i], read64( p + i * 8 ) );
+}
+}
+
+Hasher::Hasher( algorithm algo ): m_algo( algo ), m_acc{prime1 + prime2, prime2, 0, 0 - prime1}
+{
+	if( !isAvailable( algo ) ) {
+		LOG( Runtime, error ) << "SHA-256 hashes are not available, isis was built without OpenSSL";
+		throw std::invalid_argument( "unavailable hash algorithm" );
+	}
+
+#ifdef HAVE_OPENSSL
+	if( algo == sha256 ) {
+		m_context.reset( EVP_MD_CTX_new(), []( void *ctx ) {EVP_MD_CTX_free( static_cast<EVP_MD_CTX *>( ctx ) );} );
+		EVP_DigestInit_ex( static_cast<EVP_MD_CTX *>( m_context.get() ), EVP_sha256(), nullptr );
+	}
+#endif
+}
+
+bool Hasher::isAvailable( algorithm algo )
+{
+#ifdef HAVE_OPENSSL
+	return true;
+#else
+	return algo == xxh64;
+#endif
+}
+
+Hasher &Hasher::update( const void *data, size_t len )
+{
+#ifdef HAVE_OPENSSL
+	if( m_algo == sha256 ) {
+		EVP_DigestUpdate( static_cast<EVP_MD_CTX *>( m_context.get() ), data, len );
+		return *this;
+	}
+#endif
+	auto p = static_cast<const uint8_t *>( data );
+	m_total += len;
+
+	if( m_buffered ) { // fill up the buffered stripe first
+		const size_t fill = std::min( len, m_buffer.size() - m_buffered );
+		memcpy( m_buffer.data() + m_buffered, p, fill );
+		m_buffered += fill;
+		p += fill;
+		len -= fill;
+
+		if( m_buffered < m_buffer.size() )
+			return *this;
+
+		xxhStripe( m_acc, m_buffer.data() );
+		m_buffered = 0;
+	}
+
+	for( ; len >= 32; p += 32, len -= 32 )
+		xxhStripe( m_acc, p );
+
+	memcpy( m_buffer.data(), p, len );
+	m_buffered = len;
+	return *this;
+}
+
+Hasher &Hasher::update( const std::string &str )
+{
+	update( uint64_t( str.size() ) );
+	return update( str.data(), str.size() );
+}
+
+std::string Hasher::digest()const
+{
+	static const char hex[] = "0123456789abcdef";
+	std::string ret;
+#ifdef HAVE_OPENSSL
+	if( m_algo == sha256 ) {
+		// finalize a copy, so this can still be updated
+		std::unique_ptr<EVP_MD_CTX, void( * )( EVP_MD_CTX * )> ctx( EVP_MD_CTX_new(), EVP_MD_CTX_free );
+		EVP_MD_CTX_copy_ex( ctx.get(), static_cast<const EVP_MD_CTX *>( m_context.get() ) );
+		unsigned char md[EVP_MAX_MD_SIZE];
+		unsigned int md_len = 0;
+		EVP_DigestFinal_ex( ctx.get(), md, &md_len );
+
+		for( unsigned int i = 0; i < md_len; i++ ) {
+			ret += hex[md[i] >> 4];
+			ret += hex[md[i] & 0xF];
+		}
+
+		return ret;
+	}
+#endif
+	uint64_t h;
+
+	if( m_total >= 32 ) {
+		h = std::rotl( m_acc[0], 1 ) + std::rotl( m_acc[1], 7 ) + std::rotl( m_acc[2], 12 ) + std::rotl( m_acc[3], 18 );
+
+		for( uint64_t acc : m_acc )
+			h = xxhMerge( h, acc );
+	} else
+		h = prime5; // + seed (which is 0)
+
+	h += m_total;
+
+	const uint8_t *p = m_buffer.data(), *end = p + m_buffered;
+
+	for( ; p + 8 <= end; p += 8 )
+		h = std::rotl( h ^ xxhRound( 0, read64( p ) ), 27 ) * prime1 + prime4;
+
+	if( p + 4 <= end ) {
+		h = std::rotl( h ^ ( uint64_t( read32( p ) ) * prime1 ), 23 ) * prime2 + prime3;
+		p += 4;
+	}
+
+	for( ; p < end; p++ )
+		h = std::rotl( h ^ ( *p * prime5 ), 11 ) * prime1;
+
+	h ^= h >> 33;
+	h *= prime2;
+	h ^= h >> 29;
+	h *= prime3;
+	h ^= h >> 32;
+
+	for( int shift = 60; shift >= 0; shift -= 4 )
+		ret += hex[( h >> shift ) & 0xF];
+
+	return ret;
+}
+}
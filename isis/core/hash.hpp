@@ -0,0 +1,61 @@
+/*
+    Copyright (C) 2010  reimer@cbs.mpg.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <cstdint>
+
+namespace isis::util
+{
+/**
+ * Streaming hash over arbitrary data.
+ * Data can be fed in pieces of any size, the result only depends on the concatenation of all pieces.
+ * - xxh64 is the fast non-cryptographic XXH64 hash (of the data in host byte order)
+ * - sha256 is only available if isis was built with OpenSSL (ISIS_USE_OPENSSL)
+ */
+class Hasher
+{
+public:
+	enum algorithm {xxh64, sha256};
+
+	/// \throws std::invalid_argument if the algorithm is not available
+	explicit Hasher( algorithm algo = xxh64 );
+	Hasher &update( const void *data, size_t len );
+	/// add a string (its length is added as well, so consecutive strings don't run into each other)
+	Hasher &update( const std::string &str );
+	template<typename T> Hasher &update( const T &value ) requires std::is_trivially_copyable_v<T> {
+		return update( &value, sizeof( T ) );
+	}
+	/// \returns the hash of all data added so far as lowercase hex string
+	[[nodiscard]] std::string digest()const;
+	[[nodiscard]] static bool isAvailable( algorithm algo );
+private:
+	algorithm m_algo;
+	// state of xxh64
+	std::array<uint64_t, 4> m_acc;
+	std::array<uint8_t, 32> m_buffer;
+	size_t m_buffered = 0;
+	uint64_t m_total = 0;
+	// context of sha256
+	std::shared_ptr<void> m_context;
+};
+}
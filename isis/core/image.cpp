@@ -733,41 +733,47 @@ scaling_pair Image::getScalingTo( short unsigned int targetID ) const
 
 size_t Image::compare( const isis::data::Image &comp ) const
 {
-	size_t ret = 0;
+	return diff( comp ).differing;
+}
+
+DiffStats Image::diff( const Image &comp, double abs_eps, double rel_eps ) const
+{
 	LOG_IF( ! ( clean && comp.clean ), Debug, error )
 	        << "Comparing unindexed images will cause you trouble, run reIndex()!";
 
 	if ( getSizeAsVector() != comp.getSizeAsVector() ) {
 		LOG( Runtime, warning ) << "Size of images differs (" << getSizeAsVector() << "/"
-		                        << comp.getSizeAsVector() << "). Adding difference to the result.";
-		ret += ( getSizeAsVector() - comp.getSizeAsVector() ).product();
+		                        << comp.getSizeAsVector() << "). Assuming all voxels to be different.";
+		DiffStats ret;
+		ret.differing = std::max( getVolume(), comp.getVolume() );
+		ret.first = 0;
+		return ret;
 	}
 
-	const util::vector4<size_t> firstVec=chunkPtrAt( 0 )->getSizeAsVector(),secondVec=comp.chunkPtrAt( 0 )->getSizeAsVector();
-	util::vector4<size_t> minVector;
-	std::transform(
-	    std::begin(firstVec),std::end(firstVec),
-	    std::begin(secondVec),std::begin(minVector),
-	    [](size_t first,size_t second){return std::min(first,second);}
-	);
-	const size_t increment = minVector.product();
-
-	for ( size_t i = 0; i < getVolume(); i += increment ) {
-		const size_t nexti = i + increment - 1;
-		const std::pair<size_t, size_t> c1pair1( i / chunkVolume, i % chunkVolume );
-		const std::pair<size_t, size_t> c1pair2( nexti / chunkVolume, nexti % chunkVolume );
-		const std::pair<size_t, size_t> c2pair1( i / comp.chunkVolume, i % comp.chunkVolume );
-		assert( c1pair1.first == c1pair2.first );
-		LOG( Debug, verbose_info ) << "Comparing chunks at " << c1pair1.first << " and "   << c2pair1.first;
-		const Chunk &c1 = *chunkPtrAt( c1pair1.first );
-		const Chunk &c2 = *( comp.chunkPtrAt( c2pair1.first ) );
-		LOG( Debug, verbose_info )
-		        << "Start positions are " << c1pair1.second << " and " << c2pair1.second
-		        << " and the length is " << c1pair2.second - c1pair1.second;
-		ret += static_cast<const ValueArray&>(c1).compare(c1pair1.second, c1pair2.second, c2, c2pair1.second );
+	// walk both chunk lists and pair up the longest ranges that are in one chunk of each image
+	std::vector<_internal::DiffRange> ranges;
+
+	for ( size_t i = 0; i < getVolume(); ) {
+		const size_t c1 = i / chunkVolume, c2 = i / comp.chunkVolume;
+		const size_t start1 = i - c1 * chunkVolume, start2 = i - c2 * comp.chunkVolume;
+		const size_t length = std::min( chunkVolume - start1, comp.chunkVolume - start2 );
+		LOG( Debug, verbose_info ) << "Comparing chunks at " << c1 << " and " << c2 << " from " << start1 << " and " << start2 << " for " << length << " voxels";
+		ranges.push_back( {chunkPtrAt( c1 ).get(), start1, comp.chunkPtrAt( c2 ).get(), start2, length} );
+		i += length;
 	}
 
-	return ret;
+	return _internal::diff( ranges, abs_eps, rel_eps );
+}
+
+std::string Image::contentHash( util::Hasher::algorithm algo ) const
+{
+	LOG_IF( ! clean, Debug, error ) << "Hashing an unindexed image will cause you trouble, run reIndex()!";
+	std::vector<const ValueArray *> arrays;
+
+	for( size_t c = 0; c < lookup.size(); c++ )
+		arrays.push_back( chunkPtrAt( c ).get() );
+
+	return _internal::hash( arrays, algo );
 }
 
 Image::orientation Image::getMainOrientation()const
@@ -944,6 +950,67 @@ size_t Image::spliceDownTo( dimensions dim )   //rowDim = 0, columnDim, sliceDim
 	return lookup.size();
 }
 
+void Image::moveAlong( dimensions dim, const std::function<void( Chunk & )> &chunk_op, const std::function<size_t( size_t )> &source_pos )
+{
+	LOG_IF( ! clean, Debug, error ) << "Moving voxels of an unindexed image will cause you trouble, run reIndex()!";
+	const util::vector4<size_t> size = getSizeAsVector();
+
+	if( lookup[0]->getSizeAsVector()[dim] == size[dim] ) { // the chunks span dim, do it inside them
+		if( lookup[0]->getVolume() * lookup[0]->getBytesPerVoxel() >= Chunk::parallel_bytes ) {
+			for( const std::shared_ptr<Chunk> &ch : lookup ) // the chunks parallelize themselves
+				chunk_op( *ch );
+		} else {
+			util::parallelFor( lookup.size(), [&]( size_t begin, size_t end ) {
+				for( size_t c = begin; c < end; c++ )
+					chunk_op( *lookup[c] );
+			} );
+		}
+		return;
+	}
+
+	if( lookup[0]->getSizeAsVector()[dim] != 1 ) {
+		LOG( Debug, info ) << "Splicing " << identify() << " down to " << dim << " to move its chunks";
+		spliceDownTo( dim );
+	}
+
+	// exchange the data of the chunks (the chunks are the voxels of a grid in which dim has its full size)
+	const util::vector4<size_t> chunk_size = lookup[0]->getSizeAsVector();
+	size_t stride = 1; // distance of neighbouring chunks along dim in the lookup table
+
+	for( int d = 0; d < dim; d++ )
+		stride *= size[d] / chunk_size[d];
+
+	std::vector<ValueArray> data( lookup.size() );
+	std::transform( lookup.begin(), lookup.end(), data.begin(), []( const std::shared_ptr<Chunk> &ch ) {return static_cast<ValueArray &>( *ch );} );
+
+	for( size_t c = 0; c < lookup.size(); c++ ) {
+		const size_t pos = ( c / stride ) % size[dim];
+		const size_t source = c + ( source_pos( pos ) - pos ) * stride; // unsigned wrap around cancels out
+		static_cast<ValueArray &>( *lookup[c] ) = data[source];
+	}
+}
+
+void Image::flipAlong( dimensions dim )
+{
+	const size_t length = getDimSize( dim );
+	moveAlong(
+		dim, [dim]( Chunk & ch ) {ch.flipAlong( dim );},
+		[length]( size_t pos ) {return length - 1 - pos;}
+	);
+}
+
+void Image::rollAlong( dimensions dim, ptrdiff_t shift )
+{
+	const ptrdiff_t length = getDimSize( dim );
+	shift %= length;
+	if( shift < 0 )
+		shift += length;
+	moveAlong(
+		dim, [dim, shift]( Chunk & ch ) {ch.rollAlong( dim, shift );},
+		[length, shift]( size_t pos ) {return ( pos + length - shift ) % length;}
+	);
+}
+
 size_t Image::getNrOfColumns() const
 {
 	return getDimSize( data::rowDim );
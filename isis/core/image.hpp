@@ -18,6 +18,7 @@
 #include <memory>
 #include <vector>
 #include <stack>
+#include <algorithm>
 #include "sortedchunklist.hpp"
 #include "common.hpp"
 #include "progressfeedback.hpp"
@@ -65,6 +66,12 @@ private:
 	 */
 	const std::shared_ptr<Chunk> &chunkPtrAt ( size_t at ) const;
 
+	/**
+	 * Move voxels along dim.
+	 * Either by running chunk_op on all chunks if they span dim, or by moving the data of the chunk at source_pos(pos) to pos.
+	 */
+	void moveAlong( dimensions dim, const std::function<void( Chunk & )> &chunk_op, const std::function<size_t( size_t )> &source_pos );
+
 	/**
 	 * Computes chunk- and voxel- indices.
 	 * The returned chunk-index applies to the lookup-table (chunkAt), and the voxel-index to this chunk.
@@ -88,6 +95,7 @@ private:
 	}
 
 
+	friend class ImageAssembler;
 protected:
 	bool clean;
 	static std::list<isis::util::PropertyMap::PropPath> defaultChunkEqualitySet;
@@ -242,7 +250,7 @@ public:
 		LOG_IF(!clean,  Debug, warning )  << "Accessing voxels of a not-clean image. Pleas run reIndex first";
 		const std::pair<size_t, size_t> index = commonGet ( first, second, third, fourth );
 		const auto &data = chunkPtrAt ( index.first )->castTo<T>();
-		return data.get()+index.second;
+		return *(data.get()+index.second);
 	}
 
 	const util::Value getVoxelValue (size_t nrOfColumns, size_t nrOfRows = 0, size_t nrOfSlices = 0, size_t nrOfTimesteps = 0 ) const;
@@ -450,6 +458,21 @@ public:
 	 */
 	size_t compare ( const Image &comp ) const;
 
+	/**
+	 * Compares the voxel-values of this image to the given and computes statistics about the differences.
+	 * Voxels of different types are compared as double. See ValueArray::diff for the meaning of the tolerances.
+	 * \returns the statistics of the differences, the indexes in it are linear voxel indexes of the images
+	 */
+	[[nodiscard]] DiffStats diff( const Image &comp, double abs_eps = 0, double rel_eps = 0 ) const;
+
+	/**
+	 * Compute a hash of the voxel data of the image.
+	 * The result does not depend on how the image is split into chunks, and equals ValueArray::hash of a chunk holding all voxels.
+	 * It does depend on the type of the voxels. Use PropertyMap::propertyHash for the metadata.
+	 * \returns the hash as lowercase hex string
+	 */
+	[[nodiscard]] std::string contentHash( util::Hasher::algorithm algo = util::Hasher::xxh64 ) const;
+
 	orientation getMainOrientation() const;
 
 	/**
@@ -461,7 +484,7 @@ public:
 	 */
 	template<typename T> void copyToMem ( T *dst, size_t len) const {
 		if ( clean ) {
-			const scaling_pair scaling = getScalingTo ( util::typeName<T>() );
+			const scaling_pair scaling = getScalingTo ( util::typeID<T>() );
 
 			// we could do this using convertToType - but this solution does not need any additional temporary memory
 			for( const std::shared_ptr<Chunk> &ref :  lookup ) {
@@ -562,6 +585,20 @@ public:
 	 */
 	size_t spliceDownTo ( dimensions dim );
 
+	/**
+	 * Flip the voxel data along a dimension in image space (the geometry of the image is not changed).
+	 * Chunks which span the whole dimension are flipped in place.
+	 * Otherwise the data of the chunks is exchanged while their metadata stays where it is (the image is spliced down to dim if needed).
+	 */
+	void flipAlong( dimensions dim );
+
+	/**
+	 * Circularly shift the voxel data along a dimension in image space (the geometry of the image is not changed).
+	 * The voxel at position i along dim is moved to (i + shift) modulo the size of dim.
+	 * Chunks are handled like in flipAlong.
+	 */
+	void rollAlong( dimensions dim, ptrdiff_t shift );
+
 	/// \returns the number of rows of the image
 	size_t getNrOfRows() const;
 	/// \returns the number of columns of the image
@@ -687,6 +724,110 @@ public:
 		return begin() + getVolume();
 	};
 
+	/**
+	 * Random access view of the voxels of a TypedImage.
+	 * On creation it takes a snapshot of the chunk base pointers and strides of the image. Accessing voxels then
+	 * neither needs a lookup of the chunk, nor a division, nor any locking or logging (coordinates are only checked by assert).
+	 * The accessor keeps the voxel data alive, but anything changing the layout of the image (insertChunk, reIndex, convertToType, ...)
+	 * will not be reflected by it.
+	 */
+	template<typename V> class AccessorTemplate
+	{
+		std::vector<ValueArray> m_chunks; // keep the voxel data alive
+		std::vector<V*> m_bases;
+		std::array<size_t,4> m_size, m_voxel_stride, m_chunk_stride; // for each dimension the step in the chunk and the step between chunks
+	public:
+		/// view of all voxels along one dimension
+		class Line
+		{
+			V *const *m_bases;
+			size_t m_chunk, m_chunk_step, m_offset, m_offset_step, m_length;
+		public:
+			Line( V *const *bases, size_t chunk, size_t chunk_step, size_t offset, size_t offset_step, size_t length )
+			:m_bases(bases),m_chunk(chunk),m_chunk_step(chunk_step),m_offset(offset),m_offset_step(offset_step),m_length(length){}
+			V &operator[]( size_t i )const {
+				assert( i < m_length );
+				return m_bases[m_chunk + i * m_chunk_step][m_offset + i * m_offset_step];
+			}
+			[[nodiscard]] size_t size()const {return m_length;}
+		};
+
+		explicit AccessorTemplate( const TypedImage &img ) : m_size( img.getSizeAsVector() ) {
+			assert( img.isClean() );
+			m_chunks.reserve( img.lookup.size() );
+			m_bases.reserve( img.lookup.size() );
+			for( const std::shared_ptr<Chunk> &ch : img.lookup ) {
+				assert( ch->template is<T>() ); //it's a typed image, so all chunks should be T
+				m_chunks.push_back( *ch );
+				m_bases.push_back( ch->template castTo<T>().get() );
+			}
+
+			// chunks always span whole lower dimensions of the image
+			const size_t chunkVolume = img.lookup.empty() ? 0 : img.lookup.front()->getVolume();
+			size_t stride = 1;
+			bool in_chunk = true;
+			for( unsigned short d = 0; d < 4; d++ ) {
+				if( in_chunk && stride == chunkVolume )
+					in_chunk = false, stride = 1;
+				m_voxel_stride[d] = in_chunk ? stride : 0;
+				m_chunk_stride[d] = in_chunk ? 0 : stride;
+				stride *= m_size[d];
+			}
+		}
+
+		/// \returns a reference to the voxel at the given coordinates
+		V &operator()( size_t first, size_t second = 0, size_t third = 0, size_t fourth = 0 )const {
+			assert( first < m_size[0] && second < m_size[1] && third < m_size[2] && fourth < m_size[3] );
+			return m_bases[
+				first * m_chunk_stride[0] + second * m_chunk_stride[1] + third * m_chunk_stride[2] + fourth * m_chunk_stride[3]
+			][
+				first * m_voxel_stride[0] + second * m_voxel_stride[1] + third * m_voxel_stride[2] + fourth * m_voxel_stride[3]
+			];
+		}
+		/**
+		 * Get a voxel for stencil operations.
+		 * Coordinates outside of the image are clamped to its border (the border voxels are repeated).
+		 */
+		V &clamped( ptrdiff_t first, ptrdiff_t second = 0, ptrdiff_t third = 0, ptrdiff_t fourth = 0 )const {
+			auto clamp = [this]( ptrdiff_t pos, unsigned short dim ) {
+				return static_cast<size_t>( std::clamp<ptrdiff_t>( pos, 0, m_size[dim] - 1 ) );
+			};
+			return operator()( clamp( first, 0 ), clamp( second, 1 ), clamp( third, 2 ), clamp( fourth, 3 ) );
+		}
+		/**
+		 * Get all voxels along a dimension.
+		 * The coordinate for dim is ignored, the line always starts at 0.
+		 */
+		Line line( dimensions dim, size_t first, size_t second = 0, size_t third = 0, size_t fourth = 0 )const {
+			std::array<size_t,4> pos{first, second, third, fourth};
+			pos[dim] = 0;
+			return Line(
+				m_bases.data(),
+				pos[0] * m_chunk_stride[0] + pos[1] * m_chunk_stride[1] + pos[2] * m_chunk_stride[2] + pos[3] * m_chunk_stride[3],
+				m_chunk_stride[dim],
+				pos[0] * m_voxel_stride[0] + pos[1] * m_voxel_stride[1] + pos[2] * m_voxel_stride[2] + pos[3] * m_voxel_stride[3],
+				m_voxel_stride[dim],
+				m_size[dim]
+			);
+		}
+		[[nodiscard]] const std::array<size_t,4> &getSize()const {return m_size;}
+	};
+	using Accessor = AccessorTemplate<T>;
+	using ConstAccessor = AccessorTemplate<const T>;
+
+	/// get a fast random access view of the voxels (see AccessorTemplate)
+	Accessor getAccessor() {
+		if ( !checkMakeClean() ) {
+			LOG ( Debug, error )  << "Image is not clean. The accessor will be invalid ...";
+		}
+		return Accessor( *this );
+	}
+	/// get a fast random access view of the voxels (see AccessorTemplate)
+	ConstAccessor getAccessor() const {
+		LOG_IF( !isClean(), Debug, error )  << "Image is not clean. The accessor will be invalid ...";
+		return ConstAccessor( *this );
+	}
+
 	/**
 	 * Run a function on every Chunk in the image.
 	 */
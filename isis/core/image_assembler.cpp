@@ -0,0 +1,112 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2020  <copyright holder> <email>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "image_assembler.hpp"
+
+namespace isis::data
+{
+ImageAssembler::ImageAssembler( image_sink sink, size_t emit_after, util::slist *rejected )
+	: m_sink( std::move( sink ) ), m_emit_after( emit_after ), m_rejected( rejected ) {}
+
+bool ImageAssembler::push( const Chunk &chunk )
+{
+	auto reject = [&]() {
+		m_dropped++;
+
+		if( m_rejected )
+			m_rejected->push_back( chunk.getValueAs<std::string>( "source" ) );
+
+		return false;
+	};
+
+	if( !chunk.isValid() ) {
+		LOG( Runtime, error ) << "Rejecting invalid chunk. Missing properties: " << chunk.getMissing();
+		return reject();
+	}
+
+	m_pushed++;
+	auto found = std::find_if( m_pending.begin(), m_pending.end(), [&chunk]( Pending &p ) {return p.image.insertChunk( chunk );} );
+
+	if( found == m_pending.end() ) { // no pending image took it, start a new one
+		m_pending.emplace_back();
+		m_pending.back().image.minIndexingDim = rowDim;
+
+		if( !m_pending.back().image.insertChunk( chunk ) ) {
+			m_pending.pop_back();
+			return reject();
+		}
+
+		found = std::prev( m_pending.end() );
+	}
+
+	found->chunks++;
+	found->last_push = m_pushed;
+
+	if( m_emit_after ) {
+		for( auto i = m_pending.begin(); i != m_pending.end(); ) {
+			if( m_pushed - i->last_push >= m_emit_after ) {
+				LOG( Debug, info ) << "Image with " << i->chunks << " chunks didn't get any of the last " << m_emit_after << " chunks, handing it on";
+				finish( std::move( *i ) );
+				m_pending.erase( i++ );
+			} else
+				i++;
+		}
+	}
+
+	return true;
+}
+
+void ImageAssembler::finish( Pending &&pending )
+{
+	Image &image = pending.image;
+	std::unique_ptr<util::slist> image_rejected( m_rejected ? new util::slist : nullptr );
+
+	if( !image.reIndex( image_rejected.get() ) ) {
+		LOG( Runtime, error ) << "Failed to create image from " << pending.chunks << " chunks.";
+		LOG( Runtime, info ) << "Dropping non clean Image";
+	} else if( !image.isValid() ) {
+		LOG_IF( !image.getMissing().empty(), Runtime, error ) << "Cannot insert image. Missing properties: " << image.getMissing();
+		m_dropped += pending.chunks;
+	} else {
+		if( m_rejected )
+			m_rejected->splice( m_rejected->begin(), *image_rejected );
+
+		m_emitted++;
+		LOG( Runtime, info ) << "Image " << m_emitted << " with size " << util::MSubject( image.getSizeAsString() ) << " done.";
+		m_sink( std::move( image ) );
+	}
+}
+
+size_t ImageAssembler::flush()
+{
+	const size_t before = m_emitted;
+
+	while( !m_pending.empty() ) {
+		LOG( Debug, info ) << m_pending.size() << " pending images left to be indexed.";
+		finish( std::move( m_pending.front() ) );
+		m_pending.pop_front();
+	}
+
+	LOG_IF( m_dropped, Runtime, warning ) << "Dropped " << m_dropped << " chunks because they didn't form valid images";
+	m_dropped = 0;
+	return m_emitted - before;
+}
+
+size_t ImageAssembler::pending()const {return m_pending.size();}
+size_t ImageAssembler::emitted()const {return m_emitted;}
+}
@@ -0,0 +1,73 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2020  <copyright holder> <email>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "image.hpp"
+#include <functional>
+
+namespace isis::data
+{
+/**
+ * Puts chunks together into images while they are coming in.
+ * Each chunk is inserted into the first pending image that takes it, or starts a new one. That is the same
+ * distribution IOFactory::chunkListToImageList does on a list of the same chunks, but there is no need to have all
+ * chunks loaded before the first image can be started.
+ *
+ * Images are indexed and handed to the sink on flush(). If emit_after is set, pending images which did not get any
+ * of the last emit_after chunks are considered complete and handed to the sink right away. A chunk that would have
+ * fitted such an image but comes in later will then start a new image.
+ */
+class ImageAssembler
+{
+public:
+	typedef std::function<void( Image && )> image_sink;
+	/**
+	 * \param sink the function getting the finished images
+	 * \param emit_after hand on images which did not get any of the last emit_after chunks (0 to only do that on flush)
+	 * \param rejected if given, the sources of chunks which didn't make it into an image will be added
+	 */
+	explicit ImageAssembler( image_sink sink, size_t emit_after = 0, util::slist *rejected = nullptr );
+	/**
+	 * Insert a chunk into the first pending image that takes it (or a new one).
+	 * \returns false if the chunk was rejected because it is invalid
+	 */
+	bool push( const Chunk &chunk );
+	/// index all pending images and hand the valid ones to the sink \returns the amount of images handed on
+	size_t flush();
+	/// \returns the amount of images which have not been handed to the sink yet
+	[[nodiscard]] size_t pending()const;
+	/// \returns the amount of images which have been handed to the sink so far
+	[[nodiscard]] size_t emitted()const;
+private:
+	struct Pending {
+		Image image;
+		size_t chunks = 0, last_push = 0;
+	};
+	// use ImageIO's logging here (like IOFactory does)
+	typedef ImageIoLog Runtime;
+	typedef ImageIoDebug Debug;
+
+	std::list<Pending> m_pending;
+	image_sink m_sink;
+	size_t m_emit_after, m_pushed = 0, m_emitted = 0, m_dropped = 0;
+	util::slist *m_rejected;
+
+	void finish( Pending &&image );
+};
+}
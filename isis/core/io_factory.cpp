@@ -11,6 +11,7 @@
 //
 
 #include "io_factory.hpp"
+#include "batch_reader.hpp"
 #ifdef WIN32
 	#include <windows.h>
 	#include <Winbase.h>
@@ -22,6 +23,9 @@
 #include <iostream>
 #include <algorithm>
 #include <utility>
+#include <fstream>
+#include <mutex>
+#include <random>
 
 #include "log.hpp"
 #include "common.hpp"
@@ -37,11 +41,114 @@ IOFactory::FileFormatPtr IOFactory::io_error::which()const{
 	return p_format;
 }
 
+API_EXCLUDE_BEGIN;
+/// @cond _internal
+namespace _internal
+{
+/**
+ * Stand-in for a plugin which was registered from the manifest.
+ * Answers all questions about names, suffixes and dialects from the cached record and only opens the actual library
+ * once it is needed for reading or writing.
+ */
+class LazyFileFormat: public image_io::FileFormat{
+	std::string name;
+	std::list<util::istring> read_suffixes,write_suffixes,dialect_list;
+	bool reads_files;
+	mutable std::mutex lock;
+	mutable IOFactory::FileFormatPtr plugin;
+	std::function<IOFactory::FileFormatPtr()> opener;
+protected:
+	std::list<util::istring> suffixes( io_modes modes )const override{
+		std::list<util::istring> ret;
+		if(modes & read_only)
+			ret.insert(ret.end(),read_suffixes.begin(),read_suffixes.end());
+		if(modes & write_only)
+			ret.insert(ret.end(),write_suffixes.begin(),write_suffixes.end());
+		ret.sort();ret.unique();
+		return ret;
+	}
+	image_io::FileFormat &real()const{
+		std::lock_guard<std::mutex> guard(lock);
+		if(!plugin){
+			LOG(ImageIoDebug,info) << "Opening " << plugin_file << " as it is actually needed for " << util::MSubject(name);
+			plugin=opener();
+			if(!plugin)
+				throwGenericError("Failed to load the plugin library "+plugin_file.native());
+		}
+		return *plugin;
+	}
+public:
+	LazyFileFormat(std::string _name,std::list<util::istring> _read,std::list<util::istring> _write,std::list<util::istring> _dialects,bool _reads_files,std::function<IOFactory::FileFormatPtr()> _opener)
+	:name(std::move(_name)),read_suffixes(std::move(_read)),write_suffixes(std::move(_write)),dialect_list(std::move(_dialects)),reads_files(_reads_files),opener(std::move(_opener)){}
+	LazyFileFormat(IOFactory::FileFormatPtr loaded)
+	:name(loaded->getName()),read_suffixes(loaded->getSuffixes(read_only)),write_suffixes(loaded->getSuffixes(write_only)),dialect_list(loaded->dialects()),reads_files(loaded->readsFiles()),plugin(std::move(loaded)){}
+
+	std::string getName()const override{return name;}
+	std::list<util::istring> dialects()const override{return dialect_list;}
+	bool readsFiles()const override{return reads_files;}
+	std::pair<std::string, std::string> makeBasename( const std::string &filename )const override{
+		return real().makeBasename(filename);
+	}
+
+	std::list<data::Chunk> load( const std::filesystem::path &filename, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback )override{
+		return real().load(filename,std::move(formatstack),std::move(dialects),std::move(feedback));
+	}
+	std::list<data::Chunk> load(std::streambuf *source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback )override{
+		return real().load(source,std::move(formatstack),std::move(dialects),std::move(feedback));
+	}
+	std::list<data::Chunk> load(data::ByteArray source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback )override{
+		return real().load(std::move(source),std::move(formatstack),std::move(dialects),std::move(feedback));
+	}
+	void loadInto( const std::filesystem::path &filename, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback, const chunk_sink &sink )override{
+		real().loadInto(filename,std::move(formatstack),std::move(dialects),std::move(feedback),sink);
+	}
+	void loadInto( std::streambuf *source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback, const chunk_sink &sink )override{
+		real().loadInto(source,std::move(formatstack),std::move(dialects),std::move(feedback),sink);
+	}
+	void loadInto( data::ByteArray source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback, const chunk_sink &sink )override{
+		real().loadInto(std::move(source),std::move(formatstack),std::move(dialects),std::move(feedback),sink);
+	}
+	void write( const data::Image &image, const std::string &filename, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback )override{
+		real().write(image,filename,std::move(dialects),std::move(feedback));
+	}
+	void write( const std::list<data::Image> &images, const std::string &filename, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback )override{
+		real().write(images,filename,std::move(dialects),std::move(feedback));
+	}
+};
+
+int64_t modificationTime(const std::filesystem::path &file){
+	return std::filesystem::last_write_time(file).time_since_epoch().count();
+}
+std::string joinList(const std::list<util::istring> &list){
+	return util::listToString(list.begin(),list.end(),",","","");
+}
+std::list<util::istring> splitList(const std::string &str){
+	return util::makeIStringList(util::stringToList<std::string>(str,','));
+}
+// split at tabs, keeping empty fields
+std::vector<std::string> splitFields(const std::string &line){
+	std::vector<std::string> ret(1);
+	for(char c:line){
+		if(c=='\t')
+			ret.emplace_back();
+		else
+			ret.back().push_back(c);
+	}
+	return ret;
+}
+}
+/// @endcond _internal
+API_EXCLUDE_END;
+
 IOFactory::IOFactory()
 {
 	const char *env_path = getenv( "ISIS_PLUGIN_PATH" );
 	const char *env_home = getenv( "HOME" );
 
+	manifest_file = getManifestPath();
+	if( !manifest_file.empty() )
+		readManifest();
+
 	if( env_path ) {
 		findPlugins( std::filesystem::path( env_path ).native() );
 	}
@@ -79,6 +186,9 @@ IOFactory::IOFactory()
 #else
 	findPlugins( std::string( PLUGIN_PATH ) );
 #endif
+
+	if( manifest_changed )
+		writeManifest();
 }
 
 bool IOFactory::registerFileFormat( const FileFormatPtr& plugin, bool front ){
@@ -102,6 +212,59 @@ bool IOFactory::registerFileFormat_impl( const FileFormatPtr& plugin, bool front
 	return true;
 }
 
+IOFactory::FileFormatPtr IOFactory::openPlugin( const std::filesystem::path &file )
+{
+	const std::string pluginName = file.native();
+#ifdef WIN32
+	HINSTANCE handle = LoadLibrary( pluginName.c_str() );
+#else
+	void *handle = dlopen( pluginName.c_str(), RTLD_NOW );
+#endif
+
+	if ( handle ) {
+#ifdef WIN32
+		image_io::FileFormat* ( *factory_func )() = ( image_io::FileFormat * ( * )() )GetProcAddress( handle, "factory" );
+#else
+		image_io::FileFormat* ( *factory_func )() = ( image_io::FileFormat * ( * )() )dlsym( handle, "factory" );
+#endif
+
+		auto deleter = [handle, pluginName]( image_io::FileFormat *format ) {
+			delete format;
+#ifdef WIN32
+			if( !FreeLibrary( ( HINSTANCE )handle ) )
+				std::cerr << "Failed to release plugin " << pluginName << " (was loaded at " << handle << ")";
+			// TODO we cannot use LOG here, because the loggers are gone allready
+#else
+			if ( dlclose( handle ) != 0 )
+				std::cerr << "Failed to release plugin " << pluginName << " (was loaded at " << handle << ")";
+			// TODO we cannot use LOG here, because the loggers are gone already
+#endif
+		};
+
+		if ( factory_func ) {
+			FileFormatPtr io_class( factory_func(), deleter );
+			io_class->plugin_file = pluginName;
+			return io_class;
+		} else {
+#ifdef WIN32
+			LOG( Runtime, warning )
+					<< "could not get format factory function from " << util::MSubject( pluginName );
+			FreeLibrary( handle );
+#else
+			LOG( Runtime, warning )
+					<< "could not get format factory function from " << util::MSubject( pluginName ) << ":" << util::MSubject( dlerror() );
+			dlclose( handle );
+#endif
+		}
+	} else
+#ifdef WIN32
+		LOG( Runtime, warning ) << "Could not load library " << util::MSubject( pluginName );
+#else
+		LOG( Runtime, warning ) << "Could not load library " << util::MSubject( pluginName ) << ":" <<  util::MSubject( dlerror() );
+#endif
+	return {};
+}
+
 unsigned int IOFactory::findPlugins( const std::string &path )
 {
 	std::filesystem::path p( path );
@@ -125,59 +288,40 @@ unsigned int IOFactory::findPlugins( const std::string &path )
 		if ( std::filesystem::is_directory( *itr ) )continue;
 
 		if ( std::regex_match( itr->path().filename().string(), pluginFilter ) ) {
-			const std::string pluginName = itr->path().native();
-#ifdef WIN32
-			HINSTANCE handle = LoadLibrary( pluginName.c_str() );
-#else
-			void *handle = dlopen( pluginName.c_str(), RTLD_NOW );
-#endif
-
-			if ( handle ) {
-#ifdef WIN32
-				image_io::FileFormat* ( *factory_func )() = ( image_io::FileFormat * ( * )() )GetProcAddress( handle, "factory" );
-#else
-				image_io::FileFormat* ( *factory_func )() = ( image_io::FileFormat * ( * )() )dlsym( handle, "factory" );
-#endif
-
-				auto deleter = [handle, pluginName]( image_io::FileFormat *format ) {
-					delete format;
-#ifdef WIN32
-					if( !FreeLibrary( ( HINSTANCE )handle ) )
-						std::cerr << "Failed to release plugin " << pluginName << " (was loaded at " << handle << ")";
-					// TODO we cannot use LOG here, because the loggers are gone allready
-#else
-					if ( dlclose( handle ) != 0 )
-						std::cerr << "Failed to release plugin " << pluginName << " (was loaded at " << handle << ")";
-					// TODO we cannot use LOG here, because the loggers are gone already
-#endif
-				};
-
-				if ( factory_func ) {
-					FileFormatPtr io_class( factory_func(), deleter );
+			const std::filesystem::path pluginFile = itr->path();
+			const int64_t mtime = _internal::modificationTime( pluginFile );
+			const uintmax_t size = std::filesystem::file_size( pluginFile );
+			std::shared_ptr<image_io::FileFormat> io_class;
+
+			const auto cached = manifest.find( pluginFile );
+			if( !manifest_file.empty() && cached != manifest.end() && cached->second.mtime == mtime && cached->second.size == size ) {
+				const PluginRecord &rec = cached->second;
+				LOG( Runtime, verbose_info ) << "Using cached description of " << util::MSubject( pluginFile ) << ", won't load it until its needed";
+				io_class = std::make_shared<_internal::LazyFileFormat>(
+					rec.name, rec.read_suffixes, rec.write_suffixes, rec.dialects, rec.reads_files, [pluginFile]() {return openPlugin( pluginFile );}
+				);
+			} else if( FileFormatPtr loaded = openPlugin( pluginFile ) ) {
+				if( manifest_file.empty() ) { // no manifest, use the plugin directly
+					io_class = loaded;
+				} else {
+					io_class = std::make_shared<_internal::LazyFileFormat>( loaded );
+					manifest[pluginFile] = PluginRecord{
+						pluginFile, mtime, size, loaded->getName(),
+						loaded->getSuffixes( image_io::FileFormat::read_only ), loaded->getSuffixes( image_io::FileFormat::write_only ), loaded->dialects(),
+						loaded->readsFiles()
+					};
+					manifest_changed = true;
+				}
+			}
 
-					if ( registerFileFormat_impl( io_class ) ) {
-						io_class->plugin_file = pluginName;
-						ret++;
-					} else {
-						LOG( Runtime, warning ) << "failed to register plugin " << util::MSubject( pluginName );
-					}
+			if( io_class ) {
+				io_class->plugin_file = pluginFile;
+				if ( registerFileFormat_impl( io_class ) ) {
+					ret++;
 				} else {
-#ifdef WIN32
-					LOG( Runtime, warning )
-							<< "could not get format factory function from " << util::MSubject( pluginName );
-					FreeLibrary( handle );
-#else
-					LOG( Runtime, warning )
-							<< "could not get format factory function from " << util::MSubject( pluginName ) << ":" << util::MSubject( dlerror() );
-					dlclose( handle );
-#endif
+					LOG( Runtime, warning ) << "failed to register plugin " << util::MSubject( pluginFile );
 				}
-			} else
-#ifdef WIN32
-				LOG( Runtime, warning ) << "Could not load library " << util::MSubject( pluginName );
-#else
-				LOG( Runtime, warning ) << "Could not load library " << util::MSubject( pluginName ) << ":" <<  util::MSubject( dlerror() );
-#endif
+			}
 		} else {
 			LOG( Runtime, verbose_info ) << "Ignoring " << itr->path() << " because it doesn't match " << pluginFilterStr;
 		}
@@ -186,12 +330,99 @@ unsigned int IOFactory::findPlugins( const std::string &path )
 	return ret;
 }
 
+std::filesystem::path IOFactory::getManifestPath()
+{
+	if( const char *env_manifest = getenv( "ISIS_PLUGIN_MANIFEST" ) )
+		return env_manifest; // might be empty, which disables the manifest
+
+	if( const char *env_cache = getenv( "XDG_CACHE_HOME" ); env_cache && *env_cache )
+		return std::filesystem::path( env_cache ) / "isis" / "plugins.manifest";
+	else if( const char *env_home = getenv( "HOME" ) )
+		return std::filesystem::path( env_home ) / ".cache" / "isis" / "plugins.manifest";
+	else
+		return {};
+}
+
+void IOFactory::readManifest()
+{
+	std::ifstream in( manifest_file );
+	if( !in.good() ) {
+		LOG( Runtime, info ) << "No plugin manifest found at " << manifest_file << ", will create it";
+		return;
+	}
+
+	std::string line;
+	if( !std::getline( in, line ) ) {
+		LOG( Runtime, info ) << "Plugin manifest " << manifest_file << " is empty, will fill it";
+		return;
+	} else if( line != "#isis plugin manifest 2" ) {
+		LOG( Runtime, warning ) << manifest_file << " is no valid plugin manifest, will recreate it";
+		manifest_changed = true;
+		return;
+	}
+
+	// one plugin per line: file, mtime, size, name, read-suffixes, write-suffixes, dialects, reads-files (tab separated)
+	while( std::getline( in, line ) ) {
+		const std::vector<std::string> fields = _internal::splitFields( line );
+		if( fields.size() != 8 ) {
+			LOG( Runtime, warning ) << "Ignoring broken line " << util::MSubject( line ) << " in " << manifest_file;
+			manifest_changed = true;
+			continue;
+		}
+		PluginRecord rec;
+		rec.file = fields[0];
+		rec.mtime = std::strtoll( fields[1].c_str(), nullptr, 10 );
+		rec.size = std::strtoull( fields[2].c_str(), nullptr, 10 );
+		rec.name = fields[3];
+		rec.read_suffixes = _internal::splitList( fields[4] );
+		rec.write_suffixes = _internal::splitList( fields[5] );
+		rec.dialects = _internal::splitList( fields[6] );
+		rec.reads_files = fields[7] == "1";
+
+		if( std::filesystem::exists( rec.file ) )
+			manifest[rec.file] = rec;
+		else
+			manifest_changed = true; // drop records of removed plugins
+	}
+	LOG( Runtime, info ) << "Read descriptions of " << manifest.size() << " plugins from " << manifest_file;
+}
+
+void IOFactory::writeManifest()const
+{
+	std::error_code err;
+	std::filesystem::create_directories( manifest_file.parent_path(), err );
+
+	// write into a temporary file and move it over the manifest, so concurrent processes never see a partial manifest
+	std::filesystem::path tmp = manifest_file;
+	tmp += "." + std::to_string( std::random_device()() );
+	{
+		std::ofstream out( tmp );
+		out << "#isis plugin manifest 2" << std::endl;
+		for( const auto &[file, rec] : manifest ) {
+			out << file.native() << '\t' << rec.mtime << '\t' << rec.size << '\t' << rec.name << '\t'
+				<< _internal::joinList( rec.read_suffixes ) << '\t' << _internal::joinList( rec.write_suffixes ) << '\t'
+				<< _internal::joinList( rec.dialects ) << '\t' << rec.reads_files << std::endl;
+		}
+		if( !out.good() ) {
+			LOG( Runtime, warning ) << "Failed to write plugin manifest to " << tmp;
+			std::filesystem::remove( tmp, err );
+			return;
+		}
+	}
+	std::filesystem::rename( tmp, manifest_file, err );
+	if( err ) {
+		LOG( Runtime, warning ) << "Failed to store plugin manifest as " << manifest_file << " (" << err.message() << ")";
+		std::filesystem::remove( tmp, err );
+	} else
+		LOG( Runtime, info ) << "Stored descriptions of " << manifest.size() << " plugins in " << manifest_file;
+}
+
 IOFactory &IOFactory::get()
 {
 	return util::Singletons::get<IOFactory, INT_MAX>();
 }
 
-std::list<Chunk> IOFactory::load_impl(const load_source &v, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback){
+size_t IOFactory::load_impl(const load_source &v, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback, const image_io::FileFormat::chunk_sink &sink){
 	bool overridden=true;
 	const std::filesystem::path* filename = std::get_if<std::filesystem::path>( &v );
 	if(formatstack.empty()){
@@ -200,7 +431,7 @@ std::list<Chunk> IOFactory::load_impl(const load_source &v, std::list<util::istr
 			formatstack=getFormatStack(filename->string());
 		} else {
 			LOG(Runtime,error) << "I got no format stack and no filename to deduce it from, won't load anything..";
-			return {};
+			return 0;
 		}
 	}
 	FileFormatList readerList = getFileFormatList(formatstack);
@@ -237,19 +468,21 @@ std::list<Chunk> IOFactory::load_impl(const load_source &v, std::list<util::istr
 			LOG_IF(filename, ImageIoDebug, info ) << "plugin to load file" << with_dialect << " " << *filename << ": " << format->getName();
 			LOG_IF(!filename, ImageIoDebug, info ) << "plugin to load " << with_dialect << ": " << format->getName();
 
+			size_t delivered=0;
+			const image_io::FileFormat::chunk_sink forward=[&](Chunk &&ch){
+				if(filename)
+					ch.refValueAsOr( "source", filename->native() ); // set source to filename or leave it if its already set
+				delivered++;
+				sink(std::move(ch));
+			};
 			try {
-				std::list<data::Chunk> loaded =std::visit(
-					[&](auto val) { return format->load( val, formatstack, use_dialects, feedback ); },
+				std::visit(
+					[&](auto val) { format->loadInto( val, formatstack, use_dialects, feedback, forward ); },
 					v
 				);
-				if(filename){
-					for( Chunk & ref :  loaded ) {
-						ref.refValueAsOr( "source", filename->native() ); // set source to filename or leave it if its already set
-					}
-				}
-				return loaded;
+				return delivered;
 			} catch ( const std::runtime_error& e ) {
-				if(readerList.empty()) // if it was the last reader drop through the error
+				if(readerList.empty() || delivered) // if it was the last reader (or it already delivered chunks) drop through the error
 					std::throw_with_nested(IOFactory::io_error(e.what(),format));
 				else {
 					LOG_IF(filename, Runtime, notice )
@@ -258,7 +491,7 @@ std::list<Chunk> IOFactory::load_impl(const load_source &v, std::list<util::istr
 			}
 		}
 	}
-	return {};
+	return 0;
 }
 
 std::list<util::istring> IOFactory::getFormatStack( const std::string& filename ){
@@ -289,86 +522,59 @@ IOFactory::FileFormatList IOFactory::getFileFormatList( std::list<util::istring>
 std::list< Image > IOFactory::chunkListToImageList( std::list<Chunk> &src, util::slist* rejected )
 {
 	LOG_IF(src.empty(),Debug,warning) << "Calling chunkListToImageList with an empty chunklist";
-	// throw away invalid chunks
-	size_t errcnt=0;
-	for(auto i=src.begin();i!=src.end();){
-		if(!i->isValid()){
-			LOG(image_io::Runtime, error ) << "Rejecting invalid chunk. Missing properties: " << i->getMissing();
-			errcnt++;
-			if(rejected)
-				rejected->push_back(i->getValueAs<std::string>("source")); 
-			src.erase(i++);//we must increment i before the removal, otherwise it will be invalid
-		} else
-			i++;
-	}
-
 	std::list< Image > ret;
+	ImageAssembler assembler( [&ret]( Image &&image ) {ret.push_back( image );}, 0, rejected );
 
-	while ( !src.empty() ) {
-		LOG( Debug, info ) << src.size() << " Chunks left to be distributed.";
-		size_t before = src.size();
-
-		std::unique_ptr<util::slist> buff_rejected(rejected? new util::slist:nullptr);
-		Image buff( src, rowDim, buff_rejected.get() );
-
-		if ( buff.isClean() ) {
-			if( buff.isValid() ) { //if the image was successfully indexed and is valid, keep it
-				ret.push_back( buff );
-				if(rejected)
-					rejected->splice(rejected->begin(),*buff_rejected);
-				LOG( Runtime, info ) << "Image " << ret.size() << " with size " << util::MSubject( buff.getSizeAsString() ) << " done.";
-			} else {
-				LOG_IF( !buff.getMissing().empty(), Runtime, error )
-						<< "Cannot insert image. Missing properties: " << buff.getMissing();
-				errcnt += before - src.size();
-			}
-		} else
-			LOG( Runtime, info ) << "Dropping non clean Image";
-	}
+	for( const Chunk &ch : src )
+		assembler.push( ch );
 
-	LOG_IF( errcnt, Runtime, warning ) << "Dropped " << errcnt << " chunks because they didn't form valid images";
+	src.clear();
+	assembler.flush();
 	return ret;
 }
 
 std::list< Chunk > IOFactory::loadChunks( const load_source &v, std::list<util::istring> formatstack, std::list<util::istring> dialects)
+{
+	std::list<Chunk> ret;
+	loadChunksInto( v, [&ret]( Chunk &&ch ) {ret.push_back( std::move( ch ) );}, std::move( formatstack ), std::move( dialects ) );
+	return ret;
+}
+
+size_t IOFactory::loadChunksInto( const load_source &v, const image_io::FileFormat::chunk_sink &sink, std::list<util::istring> formatstack, std::list<util::istring> dialects )
 {
 	const std::filesystem::path* filename = std::get_if<std::filesystem::path>( &v );
 	if(filename)
 		assert(!std::filesystem::is_directory( *filename ));
-	return get().load_impl( v, std::move(formatstack), std::move(dialects), get().m_feedback );
+	return get().load_impl( v, std::move(formatstack), std::move(dialects), get().m_feedback, sink );
 }
 
-
 std::list< Image > IOFactory::load( const util::slist &paths, const std::list<util::istring>& formatstack, const std::list<util::istring>& dialects, isis::util::slist* rejected )
 {
-	std::list<Chunk> chunks;
+	std::list<data::Image> images;
+	loadInto( paths, [&images]( Image &&image ) {images.push_back( image );}, 0, formatstack, dialects, rejected );
+	return images;
+}
+
+size_t IOFactory::loadInto( const util::slist &paths, const ImageAssembler::image_sink &sink, size_t emit_after, const std::list<util::istring>& formatstack, const std::list<util::istring>& dialects, util::slist* rejected )
+{
+	ImageAssembler assembler( sink, emit_after, rejected );
+	const image_io::FileFormat::chunk_sink to_assembler = [&assembler]( Chunk &&ch ) {assembler.push( ch );};
+
 	for( const std::string & path :  paths ) {
-		std::list<Chunk> loaded;
 		if(std::filesystem::is_directory( path )){
-			loaded=get().loadPath(path,formatstack,dialects,rejected);
+			get().loadPath( path, formatstack, dialects, rejected, to_assembler );
 		} else {
 			try{
-				loaded=get().load_impl( path , formatstack, dialects, get().m_feedback);
-				if(loaded.empty() && rejected)
+				if( get().load_impl( path , formatstack, dialects, get().m_feedback, to_assembler ) == 0 && rejected )
 					rejected->push_back(path);
 			} catch (io_error &e){
 				LOG(Runtime,error) << "Failed to load " << path << ", the last failing plugin was " << e.which()->getName() << " with " << e.what();
 			}
 		}
-		chunks.splice(chunks.end(),loaded);
 	}
-	std::list<data::Image> images = chunkListToImageList( chunks, rejected );
-	LOG( Runtime, info ) << "Generated " << images.size() << " images out of " << paths;
-
-	// store paths of red, but rejected chunks
-	std::set<std::string> image_rej;
-	for(const data::Chunk &ch :  chunks ){
-		image_rej.insert(ch.getValueAs<std::string>("source"));
-	}
-	if(rejected)
-		rejected->insert(rejected->end(),image_rej.begin(),image_rej.end());
-	
-	return images;
+	assembler.flush();
+	LOG( Runtime, info ) << "Generated " << assembler.emitted() << " images out of " << paths;
+	return assembler.emitted();
 }
 
 std::list<data::Image> IOFactory::load( const load_source &source, const std::list<util::istring>& formatstack, const std::list<util::istring>& dialects, isis::util::slist* rejected )
@@ -378,8 +584,10 @@ std::list<data::Image> IOFactory::load( const load_source &source, const std::li
 		return load( util::slist{filename->native()}, formatstack, dialects );
 	else {
 		try{
-			std::list<Chunk> loaded=get().load_impl( source , formatstack, dialects, get().m_feedback);
-			std::list<data::Image> images = chunkListToImageList( loaded, rejected );
+			std::list<data::Image> images;
+			ImageAssembler assembler( [&images]( Image &&image ) {images.push_back( image );}, 0, rejected );
+			get().load_impl( source , formatstack, dialects, get().m_feedback, [&assembler]( Chunk &&ch ) {assembler.push( ch );} );
+			assembler.flush();
 			LOG( Runtime, info ) << "Generated " << images.size() << " images";
 			return images;
 		} catch (io_error &e){
@@ -389,49 +597,77 @@ std::list<data::Image> IOFactory::load( const load_source &source, const std::li
 	}
 }
 
-std::list<Chunk> isis::data::IOFactory::loadPath(const std::filesystem::path& path, const std::list<util::istring>& formatstack, const std::list<util::istring>& dialects, util::slist* rejected)
+void IOFactory::loadPath(const std::filesystem::path& path, const std::list<util::istring>& formatstack, const std::list<util::istring>& dialects, util::slist* rejected, const image_io::FileFormat::chunk_sink &sink)
 {
-	std::list<Chunk> ret;
-	const size_t length = std::distance( std::filesystem::directory_iterator( path ), std::filesystem::directory_iterator() ); //@todo this will also count directories
+	// if asked to, files small enough to be read anyway (instead of being mapped) are read in batches, so we don't wait for each of them
+	// that only works for files the plugins can load from memory, the others are loaded one by one
+	const size_t depth = data::BatchReader::getDepth();
+	std::vector<std::filesystem::path> batch, single;
+	for ( std::filesystem::directory_iterator i( path ); i != std::filesystem::directory_iterator(); ++i )  {
+		if ( i->is_directory() )continue;
+		if ( !depth ) {
+			single.push_back( i->path() );
+			continue;
+		}
+
+		const FileFormatList readers = getFileFormatList( formatstack.empty() ? getFormatStack( i->path().string() ) : formatstack );
+		if( !readers.empty() && std::none_of( readers.begin(), readers.end(), []( const FileFormatPtr &f ) {return f->readsFiles();} ) )
+			batch.push_back( i->path() );
+		else
+			single.push_back( i->path() );
+	}
+
 	if( m_feedback ) {
+		const size_t length = batch.size() + single.size();
 		m_feedback->show( length, std::string( "Reading " ) + std::to_string(length) + " files from " + path.native() );
 	}
 
 	bool no_mapping=false;
 	// if we can handle the opened plugins plus the additional files
-	if(!data::FilePtr::checkLimit(io_formats.size() + length)){
-		LOG(Runtime,warning) << "Can't increase the limit for open files to " << length << ", falling back to remapped mode";
+	if(!data::FilePtr::checkLimit(io_formats.size() + single.size())){
+		LOG(Runtime,warning) << "Can't increase the limit for open files to " << single.size() << ", falling back to remapped mode";
 		no_mapping=true;
 	}
+	// enforce copy, to get data into memory
+	const image_io::FileFormat::chunk_sink copy_sink=[&sink](Chunk &&ch){sink(ch.copyByID(ch.getTypeID()));};
 
-	for ( std::filesystem::directory_iterator i( path ); i != std::filesystem::directory_iterator(); ++i )  {
-		if ( std::filesystem::is_directory( *i ) )continue;
-
+	const auto load_file = [&]( const load_source &source, const std::filesystem::path &file ) {
 		try {
-			std::list<Chunk> loaded= load_impl( *i, formatstack, dialects, nullptr );//we already do progress feedback, don't let the plugins do it
-			
-			if(no_mapping)
-				for(data::Chunk &c:loaded) // enforce copy, to get data into memory
-					c= c.copyByID(c.getTypeID());
-
-			if(rejected && loaded.empty()){
-				rejected->push_back(std::filesystem::path(*i).native());
+			size_t loaded;
+			if( std::holds_alternative<ByteArray>( source ) ) { // the plugins don't see the filename here, so set the source
+				const image_io::FileFormat::chunk_sink with_source = [&]( Chunk &&ch ) {
+					ch.refValueAsOr( "source", file.native() );
+					sink( std::move( ch ) );
+				};
+				loaded = load_impl( source, formatstack.empty() ? getFormatStack( file.string() ) : formatstack, dialects, nullptr, with_source );
+			} else //we already do progress feedback, don't let the plugins do it
+				loaded = load_impl( source, formatstack, dialects, nullptr, no_mapping ? copy_sink : sink );
+
+			if(rejected && loaded==0){
+				rejected->push_back(file.native());
 			}
-			ret.splice(ret.end(),loaded);
 		} catch(const io_error &e) {
 			LOG( Runtime, notice )
-				<< "Failed to load " <<  i->path() << " using " <<  e.which()->getName() << " ( " << e.what() << " )";
+				<< "Failed to load " << file << " using " <<  e.which()->getName() << " ( " << e.what() << " )";
 		}
 
 		if( m_feedback )
 			m_feedback->progress();
-		
-	}
+	};
+
+	// files which could not be read (e.g. because they are too big) are loaded the usual way (which also reports problems)
+	data::BatchReader::read( batch, [&]( const std::filesystem::path &file, ByteArray &&data ) {
+		if( data.isValid() )
+			load_file( data, file );
+		else
+			single.push_back( file );
+	}, data::FilePtr::getMapThreshold(), depth );
+
+	for( const std::filesystem::path &file : single )
+		load_file( file, file );
 
 	if( m_feedback )
 		m_feedback->close();
-
-	return ret;
 }
 
 bool IOFactory::write(const data::Image &image, const std::string &path, const std::list<util::istring> &formatstack, const std::list<
@@ -23,7 +23,9 @@
 
 #include "chunk.hpp"
 #include "image.hpp"
+#include "image_assembler.hpp"
 #include <variant>
+#include <filesystem>
 
 namespace isis
 {
@@ -49,7 +51,7 @@ private:
 	// use ImageIO's logging here instead of the normal data::Runtime/Debug
 	typedef ImageIoLog Runtime;
 	typedef ImageIoDebug Debug;
-	std::list<Chunk> load_impl(const load_source &v, std::list<util::istring> formatstack, std::list<util::istring> dialects,std::shared_ptr<util::ProgressFeedback> feedback);
+	size_t load_impl(const load_source &v, std::list<util::istring> formatstack, std::list<util::istring> dialects,std::shared_ptr<util::ProgressFeedback> feedback, const image_io::FileFormat::chunk_sink &sink);
 public:
 	/**
 	 * Load data from a set of files or directories with given paths and dialect.
@@ -80,6 +82,25 @@ public:
 	 */
 	static std::list<data::Chunk> loadChunks(const load_source &source, std::list<util::istring> formatstack = {}, std::list<util::istring> dialects = {});
 
+	/**
+	 * Load data from a set of files or directories and hand the images to sink as soon as they are done.
+	 * The chunks are put together into images while they are loaded (see ImageAssembler), so there is no need to keep
+	 * a list of all chunks and, if emit_after is set, images can be used while the rest is still being loaded.
+	 * @param paths list if files or directories to load
+	 * @param sink function getting the images
+	 * @param emit_after hand on images once they didn't get any of the last emit_after loaded chunks (0 to wait until everything is loaded)
+	 * @return the amount of images handed to sink
+	 */
+	static size_t loadInto(
+		const util::slist &paths, const ImageAssembler::image_sink &sink, size_t emit_after = 0,
+		const std::list<util::istring>& formatstack = {}, const std::list<util::istring>& dialects = {}, util::slist* rejected=nullptr
+	);
+	/**
+	 * Load data from a given filename/stream/memory and hand each chunk to sink as soon as its loaded.
+	 * @return the amount of chunks handed to sink
+	 */
+	static size_t loadChunksInto(const load_source &source, const image_io::FileFormat::chunk_sink &sink, std::list<util::istring> formatstack = {}, std::list<util::istring> dialects = {});
+
 	static bool write(const data::Image &image, const std::string &path, const std::list<util::istring> &formatstack = {}, const std::list<
 		util::istring> &dialects = {} );
 	static bool write( std::list<data::Image> images, const std::string &path, std::list<util::istring> formatstack = {}, const std::list<util::istring> &dialects = {} );
@@ -118,7 +139,7 @@ public:
 	 * */
 	static bool registerFileFormat( const FileFormatPtr& plugin, bool front=false );
 protected:
-	std::list<Chunk> loadPath(const std::filesystem::path& path, const std::list<util::istring>& formatstack = {}, const std::list<util::istring>& dialects = {}, util::slist *rejected=nullptr);
+	void loadPath(const std::filesystem::path& path, const std::list<util::istring>& formatstack, const std::list<util::istring>& dialects, util::slist *rejected, const image_io::FileFormat::chunk_sink &sink);
 
 	static IOFactory &get();
 	IOFactory();//shall not be created directly
@@ -126,7 +147,38 @@ protected:
 
 	bool registerFileFormat_impl( const FileFormatPtr& plugin, bool front=false );
 	unsigned int findPlugins( const std::string &path );
+
+	/**
+	 * Cached description of an io-plugin library.
+	 * Is used to register a plugin without actually loading the library.
+	 * The library will only be opened once the plugin is used for reading or writing.
+	 */
+	struct PluginRecord{
+		std::filesystem::path file;
+		int64_t mtime=0;
+		uintmax_t size=0;
+		std::string name;
+		std::list<util::istring> read_suffixes,write_suffixes,dialects;
+		bool reads_files=false;
+	};
+	/**
+	 * Open the plugin library and get a FileFormat object from its factory function.
+	 * \returns the FileFormat or an empty pointer if loading failed
+	 */
+	static FileFormatPtr openPlugin( const std::filesystem::path &file );
+	/**
+	 * Get the path of the plugin manifest.
+	 * It is taken from the environment variable ISIS_PLUGIN_MANIFEST, or "isis/plugins.manifest" in the cache directory
+	 * ($XDG_CACHE_HOME or $HOME/.cache). If ISIS_PLUGIN_MANIFEST is set but empty, no manifest will be used.
+	 */
+	static std::filesystem::path getManifestPath();
+	void readManifest();
+	void writeManifest()const;
 private:
+	std::map<std::filesystem::path, PluginRecord> manifest;
+	std::filesystem::path manifest_file;
+	bool manifest_changed=false;
+
 	/**
 	 * Stores a map of suffixes to a list FileFormats which supports this suffixes.
 	 * Leading "." are stripped in the suffixes.
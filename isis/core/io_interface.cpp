@@ -90,6 +90,19 @@ std::list<data::Chunk> FileFormat::load(std::streambuf *source, std::list<util::
 	return load(tmp.native(),formatstack,dialects,feedback);
 }
 
+void FileFormat::loadInto( const std::filesystem::path &filename, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback, const chunk_sink &sink ){
+	for( data::Chunk &ch : load( filename, std::move( formatstack ), std::move( dialects ), std::move( feedback ) ) )
+		sink( std::move( ch ) );
+}
+void FileFormat::loadInto( std::streambuf *source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback, const chunk_sink &sink ){
+	for( data::Chunk &ch : load( source, std::move( formatstack ), std::move( dialects ), std::move( feedback ) ) )
+		sink( std::move( ch ) );
+}
+void FileFormat::loadInto( data::ByteArray source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback, const chunk_sink &sink ){
+	for( data::Chunk &ch : load( std::move( source ), std::move( formatstack ), std::move( dialects ), std::move( feedback ) ) )
+		sink( std::move( ch ) );
+}
+
 bool hasOrTell( const util::PropertyMap::key_type &name, const util::PropertyMap &object, LogLevel level )
 {
 	if ( object.hasProperty( name ) ) {
@@ -106,6 +106,13 @@ public:
 	
 	static bool checkDialect(const std::list<util::istring> &dialects,const util::istring& searched);
 
+	/**
+	 * Tell if the plugin needs to read files by itself (because it overrides load/loadInto for filenames).
+	 * Files for plugins that don't may be read into memory by IOFactory (e.g. in batches) and given to the
+	 * ByteArray version of load/loadInto instead.
+	 */
+	virtual bool readsFiles()const {return false;}
+
 	/**
 	 * Load data from file into the given chunk list.
 	 * I case of an error std::runtime_error will be thrown.
@@ -142,6 +149,24 @@ public:
 	virtual std::list<data::Chunk> 
 	load(data::ByteArray source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback ); //@todo should be locked
 
+	/// function getting the loaded chunks one by one
+	typedef std::function<void( data::Chunk && )> chunk_sink;
+	/**
+	 * Load data from file and hand each chunk to sink as soon as it's there (instead of collecting them in a list).
+	 * I case of an error std::runtime_error will be thrown, chunks already handed to sink stay there.
+	 * The default implementations pass on what the respective load returns. Plugins which produce many chunks
+	 * (e.g. archives) should override them, so the chunks can be used while the rest is still being loaded.
+	 * Sink is always called from the calling thread.
+	 */
+	virtual void
+	loadInto( const std::filesystem::path &filename, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback, const chunk_sink &sink );
+	/// \copydoc loadInto( const std::filesystem::path &, std::list<util::istring>, std::list<util::istring>, std::shared_ptr<util::ProgressFeedback>, const chunk_sink & )
+	virtual void
+	loadInto( std::streambuf *source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback, const chunk_sink &sink );
+	/// \copydoc loadInto( const std::filesystem::path &, std::list<util::istring>, std::list<util::istring>, std::shared_ptr<util::ProgressFeedback>, const chunk_sink & )
+	virtual void
+	loadInto( data::ByteArray source, std::list<util::istring> formatstack, std::list<util::istring> dialects, std::shared_ptr<util::ProgressFeedback> feedback, const chunk_sink &sink );
+
 	/**
 	 * Write a single image to a file.
 	 * I case of an error std::runtime_error will be thrown.
@@ -0,0 +1,286 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2020  <copyright holder> <email>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "memorypool.hpp"
+#include "common.hpp"
+#include "fileptr.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <sys/mman.h>
+
+namespace isis::data
+{
+namespace
+{
+constexpr size_t min_pooled = 64 * 1024; // smaller buffers are left to malloc
+constexpr size_t huge_size = 2 * 1024 * 1024; // buffers of this size and above are mapped (and aligned for huge pages)
+constexpr size_t thread_classes = ( 21 - 16 ) * 4; // the size classes from 64KB to 2MB are cached per thread
+constexpr size_t thread_depth = 4; // buffers per size class in the thread cache
+
+// round up to a quarter of the next lower power of two
+size_t classSize( size_t bytes )
+{
+	const size_t step = std::bit_floor( bytes ) / 4;
+	return ( bytes + step - 1 ) / step * step;
+}
+size_t classIndex( size_t class_size )
+{
+	const size_t pow = std::bit_floor( class_size );
+	return ( std::countr_zero( pow ) - 16 ) * 4 + class_size / ( pow / 4 ) - 4;
+}
+
+void *allocateFresh( size_t class_size, bool zeroed )
+{
+	if( class_size < huge_size )
+		return zeroed ? calloc( class_size, 1 ) : malloc( class_size );
+
+	// map a bit more so the buffer can be aligned to huge pages
+	const size_t mapped = class_size + huge_size;
+	void *const ptr = mmap( nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+
+	if( ptr == MAP_FAILED ) {
+		LOG( Runtime, error ) << "Failed to map " << class_size << " bytes of memory (" << util::getLastSystemError() << ")";
+		return nullptr;
+	}
+
+	const uintptr_t begin = reinterpret_cast<uintptr_t>( ptr ), aligned = ( begin + huge_size - 1 ) & ~( huge_size - 1 );
+
+	if( aligned > begin )
+		munmap( ptr, aligned - begin );
+
+	if( begin + mapped > aligned + class_size )
+		munmap( reinterpret_cast<void *>( aligned + class_size ), begin + mapped - aligned - class_size );
+
+#ifdef MADV_HUGEPAGE
+	madvise( reinterpret_cast<void *>( aligned ), class_size, MADV_HUGEPAGE );
+#endif
+	return reinterpret_cast<void *>( aligned ); // anonymous mappings are zeroed already
+}
+void releaseToSystem( void *ptr, size_t class_size )
+{
+	if( class_size < huge_size )
+		free( ptr );
+	else
+		munmap( ptr, class_size );
+}
+
+struct Shared {
+	std::mutex lock;
+	std::unordered_map<size_t, std::vector<void *>> buffers; // free buffers by class size
+	std::atomic<size_t> limit = 0, cached = 0, reused = 0, fresh = 0;
+	std::atomic<size_t> budget = 0, in_use = 0, scratch = 0;
+
+	Shared() {
+		if( const char *env = getenv( "ISIS_MEMORY_POOL" ) )
+			limit = strtoull( env, nullptr, 10 ) * 1024 * 1024;
+
+		if( const char *env = getenv( "ISIS_MEMORY_BUDGET" ) )
+			budget = strtoull( env, nullptr, 10 ) * 1024 * 1024;
+	}
+	void put( void *ptr, size_t class_size ) {
+		const std::lock_guard<std::mutex> guard( lock );
+		buffers[class_size].push_back( ptr );
+	}
+	void *take( size_t class_size ) {
+		const std::lock_guard<std::mutex> guard( lock );
+		const auto found = buffers.find( class_size );
+
+		if( found == buffers.end() || found->second.empty() )
+			return nullptr;
+
+		void *const ret = found->second.back();
+		found->second.pop_back();
+		return ret;
+	}
+	// give buffers back to the system until no more than max_cached bytes are cached
+	void trim( size_t max_cached ) {
+		const std::lock_guard<std::mutex> guard( lock );
+
+		for( auto &[class_size, list] : buffers ) {
+			while( cached > max_cached && !list.empty() ) {
+				releaseToSystem( list.back(), class_size );
+				list.pop_back();
+				cached -= class_size;
+			}
+		}
+	}
+};
+// never destroyed, so the caches of threads can be given back at any time
+Shared &shared()
+{
+	static Shared *const ret = new Shared;
+	return *ret;
+}
+
+struct ThreadCache {
+	std::array<std::array<void *, thread_depth>, thread_classes> buffers;
+	std::array<uint8_t, thread_classes> count{};
+
+	void *take( size_t class_size ) {
+		const size_t index = classIndex( class_size );
+		return count[index] ? buffers[index][--count[index]] : nullptr;
+	}
+	bool put( void *ptr, size_t class_size ) {
+		const size_t index = classIndex( class_size );
+
+		if( count[index] == thread_depth )
+			return false;
+
+		buffers[index][count[index]++] = ptr;
+		return true;
+	}
+	// move everything into the shared pool
+	void flush() {
+		for( size_t index = 0; index < thread_classes; index++ ) {
+			const size_t class_size = ( size_t( 1 ) << ( index / 4 + 16 ) ) / 4 * ( index % 4 + 4 );
+
+			for( ; count[index]; count[index]-- )
+				shared().put( buffers[index][count[index] - 1], class_size );
+		}
+	}
+	~ThreadCache() {flush();}
+};
+thread_local ThreadCache thread_cache;
+}
+
+void *MemoryPool::allocate( size_t bytes, bool zeroed, bool pooled )
+{
+	if( bytes < min_pooled )
+		return zeroed ? calloc( bytes, 1 ) : malloc( bytes );
+
+	Shared &pool = shared();
+	pool.in_use += bytes;
+
+	if( !pooled ) { // no need for size classes or huge pages if the memory is not going to be reused
+		pool.fresh++;
+		void *const ret = zeroed ? calloc( bytes, 1 ) : malloc( bytes );
+
+		if( !ret )
+			pool.in_use -= bytes;
+
+		return ret;
+	}
+
+	const size_t class_size = classSize( bytes );
+	void *ret = nullptr;
+
+	if( pool.cached ) {
+		if( class_size < huge_size )
+			ret = thread_cache.take( class_size );
+
+		if( !ret )
+			ret = pool.take( class_size );
+	}
+
+	if( ret ) {
+		pool.cached -= class_size;
+		pool.reused++;
+
+		if( zeroed )
+			memset( ret, 0, bytes );
+
+		return ret;
+	} else {
+		pool.fresh++;
+		ret = allocateFresh( class_size, zeroed );
+
+		if( !ret )
+			pool.in_use -= bytes;
+
+		return ret;
+	}
+}
+
+void MemoryPool::release( void *p, size_t bytes, bool pooled )
+{
+	if( !p )
+		return;
+
+	if( bytes < min_pooled ) {
+		free( p );
+		return;
+	}
+
+	Shared &pool = shared();
+	pool.in_use -= bytes;
+
+	if( !pooled ) {
+		free( p );
+		return;
+	}
+
+	const size_t class_size = classSize( bytes );
+
+	if( pool.cached.fetch_add( class_size ) + class_size <= pool.limit ) {
+		if( class_size >= huge_size || !thread_cache.put( p, class_size ) )
+			pool.put( p, class_size );
+	} else {
+		pool.cached -= class_size;
+		releaseToSystem( p, class_size );
+	}
+}
+
+std::shared_ptr<void> MemoryPool::acquire( size_t bytes, bool zeroed )
+{
+	Shared &pool = shared();
+
+	if( pool.budget && bytes >= min_pooled && pool.in_use + bytes > pool.budget ) {
+		FilePtr scratch = FilePtr::scratch( bytes );
+
+		if( scratch.good() ) {
+			pool.scratch++;
+			LOG( Debug, verbose_info ) << "Mapped " << bytes << " bytes from a scratch file, " << pool.in_use << " bytes are in use already";
+			return scratch.getRawAddress();
+		}
+
+		LOG( Runtime, warning ) << "Failed to get a scratch file for " << bytes << " bytes, exceeding the memory budget";
+	}
+
+	const bool pooled = pool.limit != 0; // whatever the limit is later, the memory must be released the way it was allocated
+	return {allocate( bytes, zeroed, pooled ), Deleter{bytes, pooled}};
+}
+
+void MemoryPool::setLimit( size_t bytes )
+{
+	shared().limit = bytes;
+	thread_cache.flush(); // so they can be trimmed as well
+	shared().trim( bytes );
+}
+size_t MemoryPool::getLimit() {return shared().limit;}
+
+void MemoryPool::trim()
+{
+	thread_cache.flush();
+	shared().trim( 0 );
+}
+
+MemoryPool::Stats MemoryPool::getStats()
+{
+	return {shared().reused, shared().fresh, shared().cached, shared().in_use, shared().scratch};
+}
+
+void MemoryPool::setBudget( size_t bytes ) {shared().budget = bytes;}
+size_t MemoryPool::getBudget() {return shared().budget;}
+}
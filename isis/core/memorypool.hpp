@@ -0,0 +1,100 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2020  <copyright holder> <email>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace isis::data
+{
+/**
+ * Memory for the data of ValueArray (used by ValueArray::make and thus by createByID and all conversions).
+ *
+ * Without a limit (see setLimit) all buffers come from malloc.
+ * If a limit is set small buffers (below 64KB) still come from malloc. Bigger ones are rounded up to size classes
+ * (four per power of two), buffers of 2MB and more are mapped directly and advised to be backed by huge pages.
+ * Freed buffers are not given back to the system but kept for reuse by allocations of the same size class,
+ * so repeated allocation of the same sizes doesn't pay for page faults again.
+ * Each thread has a small cache of its own for buffers below 2MB, everything else is shared.
+ *
+ * If a memory budget is set (see setBudget) buffers that don't fit into it anymore are mapped from scratch files
+ * instead (out-of-core), so the kernel can page them out into those files.
+ */
+class MemoryPool
+{
+public:
+	/// deleter for shared_ptr to memory from allocate
+	struct Deleter {
+		size_t bytes;
+		bool pooled;
+		void operator()( void *p )const {release( p, bytes, pooled );}
+	};
+	struct Stats {
+		size_t reused;   ///< allocations served from the pool
+		size_t fresh;    ///< allocations of new memory (of at least 64KB)
+		size_t cached;   ///< bytes currently kept in the pool
+		size_t in_use;   ///< bytes of allocations of at least 64KB currently in use (not counting scratch files)
+		size_t scratch;  ///< allocations which went into scratch files because of the budget
+	};
+
+	/**
+	 * Allocate memory.
+	 * \param bytes the size of the requested memory
+	 * \param zeroed fill the memory with 0 (skip that if all of it is going to be overwritten anyway)
+	 * \param pooled get memory that can be kept in the pool, otherwise it's plain memory from malloc
+	 * \returns the memory, or nullptr if there is none left
+	 */
+	static void *allocate( size_t bytes, bool zeroed = true, bool pooled = true );
+	/// give memory from allocate back (bytes and pooled must be what was passed to allocate)
+	static void release( void *p, size_t bytes, bool pooled = true );
+	/**
+	 * Get memory for a ValueArray.
+	 * Within the memory budget this is memory from allocate. Beyond the budget the memory is mapped from a scratch
+	 * file (see FilePtr::scratch). If that fails as well, the heap is used anyway.
+	 * \param bytes the size of the requested memory
+	 * \param zeroed fill the memory with 0 (memory from scratch files is always zeroed)
+	 * \returns a shared_ptr to the memory which takes care of giving it back, it points to nullptr if there is no memory left
+	 */
+	static std::shared_ptr<void> acquire( size_t bytes, bool zeroed = true );
+
+	/**
+	 * Set the maximum amount of freed memory that is kept for reuse.
+	 * The default is taken from the environment variable ISIS_MEMORY_POOL (in MB) and is 0 (no pooling) if that is not set.
+	 * Reducing the limit frees memory from the pool as needed.
+	 */
+	static void setLimit( size_t bytes );
+	static size_t getLimit();
+	/// give all memory in the pool back to the system (except for the caches of other threads)
+	static void trim();
+	static Stats getStats();
+
+	/**
+	 * Set the memory budget for the data of ValueArray.
+	 * If an allocation of at least 64KB would make the memory in use exceed the budget, acquire maps it from a scratch
+	 * file instead. That way datasets beyond the physical memory can be processed without swapping.
+	 * The budget is not strict, concurrent allocations may exceed it a bit. Memory kept in the pool is not counted.
+	 * The default is taken from the environment variable ISIS_MEMORY_BUDGET (in MB) and is 0 (no budget) if that is not set.
+	 *
+	 * The scratch files go into the directory from ISIS_SCRATCH_DIR, or TMPDIR if that is not set (see FilePtr::setScratchDir).
+	 * /tmp often is a tmpfs, which is held in memory itself, so a directory on a disk should be used with a budget.
+	 */
+	static void setBudget( size_t bytes );
+	static size_t getBudget();
+};
+}
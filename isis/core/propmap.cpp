@@ -617,6 +617,23 @@ bool PropertyMap::operator!=(const PropertyMap &other) const {return container !
 PropertyMap::PathSet PropertyMap::getKeys()const   {return genKeyList(trueP);}
 PropertyMap::PathSet PropertyMap::getMissing()const {return genKeyList(invalidP);}
 
+std::string PropertyMap::propertyHash( const PathSet &paths, Hasher::algorithm algo )const
+{
+	Hasher hasher( algo );
+
+	for( const PropPath &path : paths.empty() ? getKeys() : paths ) {
+		hasher.update( path.toString() );
+
+		if( const PropertyValue *found = queryProperty( path ); found && !found->isEmpty() ) {
+			hasher.update( found->getTypeName() );
+			hasher.update( found->toString() );
+		} else
+			hasher.update( std::string() ); // empty type name marks missing properties
+	}
+
+	return hasher.digest();
+}
+
 void PropertyMap::addNeeded( const PropPath &path )
 {
 	touchProperty( path ).setNeeded(true);
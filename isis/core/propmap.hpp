@@ -19,6 +19,7 @@
 #include "property.hpp"
 #include "log.hpp"
 #include "istring.hpp"
+#include "hash.hpp"
 #include <set>
 #include <algorithm>
 #include <optional>
@@ -401,6 +402,14 @@ public:
 	 */
 	PathSet getKeys()const;
 
+	/**
+	 * Compute a canonical hash of properties.
+	 * Path, type and value of each property are hashed in the order of the paths, so the result does not depend on the order the properties were set in.
+	 * \param paths the paths of the properties to be hashed (all if empty), paths of non-existing properties are hashed as such
+	 * \returns the hash as lowercase hex string
+	 */
+	[[nodiscard]] std::string propertyHash( const PathSet &paths = {}, Hasher::algorithm algo = Hasher::xxh64 )const;
+
 	/**
 	 * Get a list of missing properties.
 	 * \returns a list of the paths for all properties which are marked as needed and but are empty.
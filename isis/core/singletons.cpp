@@ -2,24 +2,25 @@
 
 namespace isis::util
 {
-
-Singletons::registry & Singletons::getRegistry()
+Singletons::singleton &Singletons::getEntry( const std::type_index &type )
 {
+	struct registry: std::map<std::type_index, singleton> {
+		std::mutex lock;
+		~registry() {
+			// transfer all singletons (aka unique pointers) into a priority sorted list and delete them accordingly
+			std::multimap<int, single_ptr> delete_stack;
+			for( auto &v : *this ) {
+				delete_stack.emplace( v.second.prio, std::move( v.second.ptr ) );
+			}//registry now is full of null-pointers
+			//remove all singletons beginning at the lowest priority
+			while( !delete_stack.empty() ) {
+				delete_stack.erase( delete_stack.begin() );
+			}
+		}
+	};
 	static registry static_reg;
-	return static_reg;
-}
-Singletons::~Singletons()
-{
-	// transfer all singletons (aka unique pointers) into a priority sorted list and delete them accordingly
-	auto &reg= getRegistry();
-	std::map<int,single_ptr> delete_stack;
-	for(auto &v:reg){//the mapped value of the registry reg is a PRIO/single_ptr pair
-		delete_stack.insert(std::move(v.second)); //exactly what insert expects (we use move here as unique_ptr can not be copied)
-	}//reg now is full of null-pointers
-	//remove all registries beginning at the lowest priority
-	while ( !delete_stack.empty() ) {
-		delete_stack.erase(delete_stack.begin() );
-	}
+	std::lock_guard<std::mutex> guard( static_reg.lock );
+	return static_reg[type]; // map entries don't move, so it's fine to use the reference without the lock
 }
 
 }
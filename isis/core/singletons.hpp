@@ -7,6 +7,8 @@
 #include <typeindex>
 #include <memory>
 #include <functional>
+#include <atomic>
+#include <mutex>
 
 namespace isis::util
 {
@@ -22,7 +24,8 @@ namespace isis::util
  * Singletons::get < MyClass, INT_MAX - 1 >()
  * \endcode
  * This generates a Singleton of MyClass with highest priority.
- * \note This is (currently) not thread save.
+ * \note get is thread safe. The singleton is created exactly once (concurrent callers wait for that),
+ * after that getting it doesn't take any lock.
  */
 class Singletons
 {
@@ -30,12 +33,15 @@ class Singletons
 	// in order to keep the pointer (and in extend the registry) type free
 	using single_ptr = std::unique_ptr<void,std::function<void(void const*)>>;
 	// and an attached priority
-	using singleton = std::pair<int,single_ptr>;
-	using registry = std::map<std::type_index,singleton>;
+	struct singleton {
+		std::once_flag created;
+		int prio = 0;
+		single_ptr ptr;
+	};
 
 	Singletons()=default;
-	~Singletons();
-	static registry &getRegistry();
+	/// get the (stable) registry entry for type, creates an empty one if needed
+	static singleton &getEntry( const std::type_index &type );
 public:
 	/**
 	 * The first call creates a singleton of type T with the priority PRIO (ascending order),
@@ -44,16 +50,26 @@ public:
 	 * \return a reference to the same object of type T.
 	 */
 	template<class T, int PRIO = INT_MAX-1, typename... ARGS> static T &get(ARGS&&... args) {
-		singleton &sngl= getRegistry()[typeid(T)];
-		if ( !sngl.second ) {
-			// create singleton in unique_ptr where only the deleter knows the type
-			sngl = {PRIO,single_ptr (
-				new T(&args...),
-				[](void const *p){delete(static_cast<T const*>(p));}
-			)};
+		// the shared registry is only asked once, after that the pointer is taken from here
+		static std::atomic<T *> cached = nullptr;
+		T *ret = cached.load( std::memory_order_acquire );
+
+		if( !ret ) {
+			singleton &sngl = getEntry( typeid( T ) );
+			std::call_once( sngl.created, [&]() {
+				// create singleton in unique_ptr where only the deleter knows the type
+				sngl.prio = PRIO;
+				sngl.ptr = single_ptr(
+					new T(&args...),
+					[](void const *p){delete(static_cast<T const*>(p));}
+				);
+			} );
+			assert( sngl.ptr );
+			ret = static_cast<T *>( sngl.ptr.get() );
+			cached.store( ret, std::memory_order_release );
 		}
-		assert(sngl.second);
-		return *(static_cast<T*>(sngl.second.get()));
+
+		return *ret;
 	}
 };
 
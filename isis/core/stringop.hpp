@@ -6,7 +6,9 @@
 
 #include "common.hpp"
 #include "istring.hpp"
-#include "charconv"
+#include <charconv>
+#include <string_view>
+#include <cctype>
 
 namespace isis::util{
 
@@ -23,23 +25,18 @@ TARGET listToString(
 	return ret.str();
 }
 
-template<typename traits>
-bool stringTofloat(const std::basic_string<char, traits> &str, float& target){
-	char *end;
-	target= strtof(str.data(),&end);
-	return str.data()+str.length() == end;
-}
-template<typename traits>
-bool stringTofloat(const std::basic_string<char, traits> &str, double& target){
-	char *end;
-	target= strtof(str.data(),&end);
-	return str.data()+str.length() == end;
-}
-template<typename traits>
-bool stringTofloat(const std::basic_string<char, traits> &str, long double& target){
-	char *end;
-	target= strtof(str.data(),&end);
-	return str.data()+str.length() == end;
+/**
+ * Parse a number from the begin of a string using std::from_chars (no locale, no allocation).
+ * Other than from_chars this skips leading whitespace and a leading "+" (like strtod does).
+ * \returns the result of from_chars, so ptr points behind the parsed number
+ */
+template<typename T> std::from_chars_result parseNumber(std::string_view str, T &target){
+	const char *at=str.data(), *const end=str.data()+str.size();
+	while(at<end && std::isspace(static_cast<unsigned char>(*at)))
+		at++;
+	if(end-at>1 && *at=='+' && at[1]!='-')
+		at++;
+	return std::from_chars(at,end,target);
 }
 /**
  * Try a static conversion from string to any type.
@@ -50,10 +47,11 @@ bool stringTofloat(const std::basic_string<char, traits> &str, long double& targ
 template<typename TARGET, typename traits>
 bool stringTo(const std::basic_string<char, traits> &str, TARGET& target){
 	if constexpr(std::is_integral_v<TARGET> && !std::is_same_v<bool,TARGET>){
-		auto [p,ec] = std::from_chars(str.data(),str.data()+str.size(),target);
+		auto [p,ec] = parseNumber({str.data(),str.size()},target);
 		return ec == std::errc();
 	} else if constexpr(std::is_floating_point_v<TARGET>){
-		return stringTofloat(str,target);// @todo get rid of this once from_chars is available for float
+		auto [p,ec] = parseNumber({str.data(),str.size()},target);
+		return ec == std::errc() && p == str.data()+str.size();
 	} else if constexpr(std::is_same_v<std::string,TARGET>){
 		target=std::string(str.data(),str.length());
 		return true;
@@ -1,6 +1,8 @@
 #include "types.hpp"
 #include "value.hpp"
 #include "types_array.hpp"
+#include <cctype>
+#include <algorithm>
 
 namespace isis{
 namespace util{
@@ -72,6 +74,165 @@ std::map<size_t, std::string> map_types(std::variant<_First, _Rest...>*)
 
 }
 
+namespace _internal{
+// minimal cursor on a string to parse dates and times
+class DateTimeParser{
+	const char *m_at, *m_end;
+public:
+	explicit DateTimeParser(std::string_view src):m_at(src.data()),m_end(src.data()+src.size()){
+		while(m_at<m_end && std::isspace(static_cast<unsigned char>(*m_at)))
+			m_at++;
+		while(m_end>m_at && (std::isspace(static_cast<unsigned char>(m_end[-1])) || m_end[-1]=='\0')) // DICOM pads with spaces or \0
+			m_end--;
+	}
+	[[nodiscard]] bool done()const{return m_at==m_end;}
+	[[nodiscard]] char peek()const{return done() ? '\0':*m_at;}
+	bool literal(char c){
+		if(peek()!=c)
+			return false;
+		m_at++;
+		return true;
+	}
+	// read min_digits to max_digits digits
+	bool number(int min_digits, int max_digits, int &dst){
+		int ret=0, digits=0;
+		for(;digits<max_digits && m_at+digits<m_end && std::isdigit(static_cast<unsigned char>(m_at[digits]));digits++)
+			ret=ret*10+m_at[digits]-'0';
+		if(digits<min_digits)
+			return false;
+		m_at+=digits;
+		dst=ret;
+		return true;
+	}
+	bool number(int digits, int &dst){return number(digits,digits,dst);}
+	bool month_name(int &dst){
+		static constexpr const char* names[]={"jan","feb","mar","apr","may","jun","jul","aug","sep","oct","nov","dec"};
+		if(m_end-m_at<3)
+			return false;
+		for(int m=0;m<12;m++){
+			if(std::equal(names[m],names[m]+3,m_at,[](char a, char b){return a==std::tolower(static_cast<unsigned char>(b));})){
+				m_at+=3;
+				dst=m+1;
+				return true;
+			}
+		}
+		return false;
+	}
+	// HH[MM[SS[.F]]] or HH:MM[:SS[.F]], the compact form needs all of HHMMSS unless short_forms is set
+	bool time_of_day(duration &dst, bool short_forms){
+		const char *const start=m_at;
+		int h, m=0, s=0;
+		if(number(1,2,h) && literal(':')){ // the separated form might omit leading zeros
+			if(!number(1,2,m) || (literal(':') && !number(1,2,s)))
+				return false;
+		} else { // the compact form HH[MM[SS]]
+			m_at=start;
+			if(!number(2,h))
+				return false;
+			if(number(2,m))
+				number(2,s);
+			if(!short_forms && m_at-start<6)
+				return false;
+		}
+		if(h>23 || m>59 || s>60)
+			return false;
+		dst=std::chrono::hours(h)+std::chrono::minutes(m)+std::chrono::seconds(s);
+		if(literal('.') || literal(',')){ // fraction of seconds
+			std::chrono::nanoseconds frac(0);
+			int digits=0;
+			for(int d;number(1,d);digits++){
+				if(digits<9)
+					frac=frac*10+std::chrono::nanoseconds(d);
+			}
+			if(digits==0)
+				return false;
+			for(;digits<9;digits++)
+				frac*=10;
+			dst+=std::chrono::duration_cast<duration>(frac);
+		}
+		return true;
+	}
+	bool make_date(int y, int m, int d, std::chrono::year_month_day &dst){
+		dst=std::chrono::year(y)/m/d;
+		return dst.ok();
+	}
+	// YYYYMMDD, YYYY-MM-DD, YYYY.MM.DD, DD.MM.YYYY or (if allowed) YYMMDD
+	bool calendar_date(std::chrono::year_month_day &dst, bool short_year){
+		const char *const start=m_at;
+		int a, m, d;
+		if(number(4,a)){
+			if((literal('-') || literal('.')) && number(2,m) && (literal(start[4]) && number(2,d)))
+				return make_date(a,m,d,dst);
+			m_at=start+4;
+			if(number(2,m) && number(2,d))
+				return make_date(a,m,d,dst);
+		}
+		m_at=start;
+		if(number(1,2,d) && literal('.') && number(1,2,m) && literal('.') && number(4,a))
+			return make_date(a,m,d,dst);
+		m_at=start;
+		if(short_year && number(2,a) && number(2,m) && number(2,d))
+			return make_date(a<69 ? 2000+a:1900+a,m,d,dst); // as strptime does it
+		m_at=start;
+		return false;
+	}
+	// DD Mon YYYY
+	bool written_date(std::chrono::year_month_day &dst){
+		int d, m, y;
+		return number(1,2,d) && literal(' ') && month_name(m) && literal(' ') && number(4,y) && make_date(y,m,d,dst);
+	}
+	void skip_utc_offset(){
+		const char *const start=m_at;
+		int offset;
+		literal('&');
+		if(!((literal('+') || literal('-')) && number(4,offset) && done()))
+			m_at=start;
+	}
+};
+}
+
+std::optional<date> parseDate(std::string_view src){
+	_internal::DateTimeParser parser(src);
+	std::chrono::year_month_day ymd;
+	if(parser.calendar_date(ymd,true) && parser.done())
+		return date(ymd);
+	else
+		return {};
+}
+std::optional<timestamp> parseTimestamp(std::string_view src){
+	{
+		// a time, maybe followed by a written date
+		// "HH" and "HHMM" are not taken here, bare numbers like "2001" might as well be years
+		_internal::DateTimeParser parser(src);
+		duration time;
+		std::chrono::year_month_day ymd;
+		if(parser.time_of_day(time,false)){
+			if(parser.done())
+				return timestamp(time);
+			else if(parser.literal(' ') && parser.written_date(ymd) && parser.done())
+				return timestamp(date(ymd))+time;
+		}
+	}
+	// a date maybe followed by a time
+	_internal::DateTimeParser parser(src);
+	std::chrono::year_month_day ymd;
+	if(!parser.calendar_date(ymd,false))
+		return {};
+
+	duration time(0);
+	if(!parser.done()){
+		while(parser.literal(' '));
+		parser.literal('T');
+		if(!parser.time_of_day(time,true))
+			return {};
+		parser.skip_utc_offset();
+	}
+	if(parser.done())
+		return timestamp(date(ymd))+time;
+	else
+		return {};
+}
+
 const std::map<size_t, std::string> &getTypeMap(bool arrayTypesOnly){
 	if(arrayTypesOnly){
 		static const auto ret = _internal::map_types(static_cast<data::ArrayTypes*>(nullptr));
@@ -100,16 +261,19 @@ std::ostream &std::operator<<(std::ostream &out, const isis::util::duration &s)
 std::ostream &std::operator<<(std::ostream &out, const isis::util::date &s)
 {
 	const time_t tme(chrono::duration_cast<chrono::seconds>(s.time_since_epoch()).count());
-	return out<<std::put_time(std::localtime(&tme), "%x");
+	std::tm t;
+	return out<<std::put_time(gmtime_r(&tme,&t), "%x"); // dates and times are stored as they were given (no timezone)
 }
 std::ostream &std::operator<<(std::ostream &out, const isis::util::timestamp &s)
 {
 	const chrono::seconds sec=std::chrono::duration_cast<chrono::seconds>(s.time_since_epoch());
 	const time_t tme(sec.count());
+	std::tm t;
+	gmtime_r(&tme,&t); // see parseTimestamp
 	if(s>=(isis::util::timestamp()+std::chrono::hours(24))) // if we have a real timepoint (not just time)
-		out<<std::put_time(std::localtime(&tme), "%c"); // write time and date
+		out<<std::put_time(&t, "%c"); // write time and date
 	else {
-		out<<std::put_time(std::localtime(&tme), "%X"); // otherwise, write just the time
+		out<<std::put_time(&t, "%X"); // otherwise, write just the time
 	}
 	// and maybe with milliseconds
 
@@ -6,6 +6,8 @@
 #include "vector.hpp"
 #include "selection.hpp"
 #include <iomanip>
+#include <optional>
+#include <string_view>
 
 #if __GNUC__ < 10
 namespace std::chrono{
@@ -21,6 +23,27 @@ typedef std::chrono::system_clock::duration duration; // @todo float duration mi
 typedef std::chrono::sys_time<duration> timestamp;
 typedef std::chrono::sys_days date;
 
+/**
+ * Parse a date without using locale or timezone.
+ * Supported are the DICOM DA "YYYYMMDD" (and its old form "YYYY.MM.DD"), ISO "YYYY-MM-DD", "YYMMDD" and "DD.MM.YYYY".
+ * Surrounding whitespace is ignored.
+ * \returns the date or nothing if src is no valid date in any of these formats
+ */
+std::optional<date> parseDate( std::string_view src );
+/**
+ * Parse a timestamp without using locale or timezone.
+ * The time is taken as it is (as if it was UTC), a time without a date is a time of 1970-01-01.
+ * Supported are
+ * - the DICOM TM "HHMMSS[.F]" and "HH:MM[:SS[.F]]" (the short forms "HH" and "HHMM" only after a date, alone they would be ambiguous)
+ * - the DICOM DT "YYYYMMDD[HH[MM[SS[.F]]]]" (a UTC offset "&ZZXX" at its end is ignored)
+ * - a date as in parseDate (but not "YYMMDD") followed by " " or "T" and the time
+ * - "HH:MM:SS DD Mon YYYY" (with english month names)
+ *
+ * Fractions of seconds are used up to nanoseconds. Surrounding whitespace is ignored.
+ * \returns the timestamp or nothing if src is no valid timestamp in any of these formats
+ */
+std::optional<timestamp> parseTimestamp( std::string_view src );
+
 
 /// @cond _internal
 namespace _internal{
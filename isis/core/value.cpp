@@ -132,19 +132,11 @@ const _internal::ValueConverterMap &Value::converters(){
 }
 
 const Value::Converter &Value::getConverterTo(unsigned short ID) const {
-	const auto f1 = converters().find( typeID() );
-	assert( f1 != converters().end() );
-	const auto f2 = f1->second.find( ID );
-	assert( f2 != f1->second.end() );
-	return f2->second;
+	return converters().get( typeID(), ID );
 }
 
 Value Value::createByID(unsigned short ID) {
-	const auto f1 = converters().find(ID);
-	assert( f1 != converters().end() );
-	const auto f2 = f1->second.find( ID );
-	assert( f2 != f1->second.end() );
-	return f2->second->create();//trivial conversion to itself should always be there
+	return converters().get( ID, ID )->create();//trivial conversion to itself should always be there
 }
 
 Value Value::copyByID(size_t ID) const{
@@ -28,6 +28,8 @@
 
 #include <complex>
 #include <iomanip>
+#include <charconv>
+#include <cstring>
 #include <boost/numeric/conversion/converter.hpp>
 
 /// @cond _internal
@@ -39,24 +41,6 @@ namespace _internal
 
 template<typename SRC,typename DST> constexpr bool is_num(){return std::is_arithmetic_v<SRC> && std::is_arithmetic_v<DST>;}
 
-template<typename T_DUR> bool parseTimeString(const std::string &src, const char *format,std::chrono::time_point<std::chrono::system_clock,T_DUR> &dst){
-	std::tm t = {0,0,0,1,0,70,0,0,-1,0,nullptr};
-	std::istringstream ss(src);
-	ss >> std::get_time(&t, format);
-	if(!ss.fail()) {
-		time_t tt = mktime(&t);
-		dst=std::chrono::round<T_DUR>(std::chrono::system_clock::from_time_t(tt));
-		if(ss.peek()=='.'){
-			float frac=0;
-			ss >> frac;
-			dst+=std::chrono::duration_cast<T_DUR>(std::chrono::duration<float>(frac));
-		}
-		LOG_IF(!ss.eof(),Debug,info) << ss.str() << "remained after parsing timestamp" << src;
-		return true;
-	} else 
-		return false;
-}
-	
 //Define generator - this can be global because it's using convert internally
 template<typename SRC, typename DST> class ValueGenerator: public ValueConverterBase
 {
@@ -109,14 +93,14 @@ public:
 // some helper
 /////////////////////////////////////////////////////////////////////////////
 
-// global numeric overflow handler @todo this is NOT thread-safe
+// numeric overflow handler (the result is kept per thread, so concurrent conversions don't see each others overflow)
 struct NumericOverflowHandler {
-	static range_check_result result;
+	static thread_local range_check_result result;
 	void operator() ( boost::numeric::range_check_result r ) { // throw bad_numeric_conversion derived
 		result = (range_check_result)r;
 	}
 };
-range_check_result NumericOverflowHandler::result = cInRange;
+thread_local range_check_result NumericOverflowHandler::result = cInRange;
 
 // basic numeric to numeric conversion (does rounding and handles overflow)
 template<typename SRC, typename DST> range_check_result num2num( const SRC &src, DST &dst )
@@ -142,8 +126,22 @@ template<typename DST> range_check_result str2scalar( const std::string &src, DS
 			return cInRange;
 		else //if the string is not "part" of the selection we count this as positive overflow
 			return cPosOverflow;
-	} else if constexpr(std::is_arithmetic_v<DST>){// if a converter from double is available first map to double and then convert that into DST
-		return num2num<double, DST>( std::stod( src ), dst ); //@todo so we need an overflow-check here
+	} else if constexpr(std::is_arithmetic_v<DST>){
+		// integers are parsed as such, so big ones don't lose precision on their way through double
+		if constexpr(std::is_integral_v<DST>){
+			std::conditional_t<std::is_signed_v<DST>, int64_t, uint64_t> integer;
+			const auto [end, ec] = parseNumber( src, integer );
+			if( ec == std::errc() && ( end == src.data() + src.size() || !std::strchr( ".eE", *end ) ) )
+				return num2num( integer, dst );
+		}
+		// otherwise map to double and convert that into DST (like std::stod trailing text is ignored)
+		double value;
+		const auto [end, ec] = parseNumber( src, value );
+		if( ec == std::errc::invalid_argument )
+			throw std::invalid_argument( "Failed to parse \"" + src + "\" as number" );
+		else if( ec == std::errc::result_out_of_range )
+			throw std::out_of_range( "\"" + src + "\" is out of the range of double" );
+		return num2num<double, DST>( value, dst );
 	} else {// otherwise, try direct mapping (rounding will fail)
 
 		LOG( Debug, warning ) << "using stringTo to convert from string to " << typeName<DST>() << " no rounding can be done.";
@@ -157,60 +155,38 @@ template<typename DST> range_check_result str2scalar( const std::string &src, DS
 // needs special handling
 template<> range_check_result str2scalar<date>( const std::string &src, date &dst )
 {
-	// see http://dicom.nema.org/dicom/2013/output/chtml/part05/sect_6.2.html for dicom VRs
-	//@todo support other formats and parse offset part of the DICOM VR "DT"
-	//@todo %c and %x are broken in gcc 
-	static const char *formats[]={
-		"%Y%m%d",
-		"%Y-%m-%d",
-		"%y%m%d",
-		"%d.%m.%Y"
-	};
-
-	for(const char *format:formats){
-		if(parseTimeString(src,format,dst))
-			return cInRange;
-	};
-
-	dst=date();
-	
-	LOG(Runtime, error ) // if it's still broken at least tell the user
-		<< "Miserably failed to interpret " << MSubject( src ) << " as " <<typeName<date>() << " returning " << MSubject( dst );
+	if( const auto parsed = parseDate( src ) ) {
+		dst = *parsed;
+	} else {
+		dst = date();
+		LOG( Runtime, error ) // if it's still broken at least tell the user
+			<< "Miserably failed to interpret " << MSubject( src ) << " as " << typeName<date>() << " returning " << MSubject( dst );
+	}
 	return cInRange;
 }
 // needs special handling
 template<> range_check_result str2scalar<timestamp>( const std::string &src, timestamp &dst )
 {
-	// see http://dicom.nema.org/dicom/2013/output/chtml/part05/sect_6.2.html for dicom VRs
-	//@todo support other formats and parse offset part of the DICOM VR "DT"
-	//@todo %c and %x are broken in gcc 
-	static const char *formats[]={"%Y%m%d%H%M%S","%Y%m%dT%H%M%S","%d.%m.%Y %H:%M:%S","%H%M%S","%H:%M:%S"};
-
-	for(const char *format:formats){
-		if(parseTimeString(src,format,dst))
-			return cInRange;
-	};
-
-	dst=timestamp();
-	
-	LOG(Runtime, error ) // if it's still broken at least tell the user
-		<< "Miserably failed to interpret " << MSubject( src ) << " as " <<typeName<timestamp>() << " returning " << MSubject( dst );
+	if( const auto parsed = parseTimestamp( src ) ) {
+		dst = *parsed;
+	} else {
+		dst = timestamp();
+		LOG( Runtime, error ) // if it's still broken at least tell the user
+			<< "Miserably failed to interpret " << MSubject( src ) << " as " << typeName<timestamp>() << " returning " << MSubject( dst );
+	}
 	return cInRange;
 }
 // needs special handling
 template<> range_check_result str2scalar<duration>(const std::string &src, duration &dst)
 {
 	// try to parse time format
-	static const char *formats[]={"%H:%M:%S"};
-	timestamp dummy;
-
-	for(const char *format:formats){
-		if(parseTimeString(src,format,dummy)){
-			dst=dummy-timestamp();
+	if( src.find( ':' ) != std::string::npos ) {
+		if( const auto parsed = parseTimestamp( src ); parsed && *parsed < timestamp( std::chrono::hours( 24 ) ) ) {
+			dst = parsed->time_since_epoch();
 			return cInRange;
 		}
-	};
-	
+	}
+
 	// ok just use whatever number we can manage to parse
 	//@todo support other ratios as milli
 	duration::rep count;
@@ -328,11 +304,28 @@ template<typename CLASS, typename SRC, typename DST> static std::shared_ptr<cons
 // special to string conversions
 template<typename T> std::string toStringConv( const T &src, std::false_type )
 {
-	std::stringstream s;
-	s << std::boolalpha << src; // bool will be converted to true/false
-	return s.str();
+	if constexpr( std::is_floating_point_v<T> ) { // same as the stream would do ("%g"), but without the stream
+		char buffer[64];
+		const auto [end, ec] = std::to_chars( buffer, buffer + sizeof( buffer ), src, std::chars_format::general, 6 );
+		assert( ec == std::errc() );
+		return {buffer, end};
+	} else {
+		std::stringstream s;
+		s << std::boolalpha << src; // bool will be converted to true/false
+		return s.str();
+	}
+}
+template<typename T> std::string toStringConv( const T &src, std::true_type )
+{
+	if constexpr( std::is_same_v<T, bool> ) {
+		return src ? "1" : "0";
+	} else {
+		char buffer[24];
+		const auto [end, ec] = std::to_chars( buffer, buffer + sizeof( buffer ), src );
+		assert( ec == std::errc() );
+		return {buffer, end};
+	}
 }
-template<typename T> std::string toStringConv( const T &src, std::true_type ) {return std::to_string( src );}
 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -765,7 +758,7 @@ public:
 //OK, that's about the foreplay. Now we get to the dirty stuff.
 ////////////////////////////////////////////////////////////////////////
 typedef std::shared_ptr<const ValueConverterBase> ConverterPtr;
-typedef std::map< size_t , std::map<size_t, ConverterPtr> > ConverterMap;
+typedef std::array<std::array<ConverterPtr, Value::NumOfTypes>, Value::NumOfTypes> ConverterMap;
 
 template<typename DST> struct MakeConvVisitor{
     template<typename SRC> std::shared_ptr<const ValueConverterBase> operator()(const SRC &)const{
@@ -791,8 +784,8 @@ template<int I=0> constexpr void makeOuterConv(ConverterMap &m_map){
 
 ValueConverterMap::ValueConverterMap()
 {
-	makeOuterConv( *this );
-	LOG( Debug, info ) << "conversion map for " << size() << " types created";
+	makeOuterConv( table );
+	LOG( Debug, info ) << "conversion map for " << table.size() << " types created";
 }
 
 }
@@ -20,7 +20,10 @@
 #pragma once
 
 #include <memory>
+#include <array>
+#include <cassert>
 #include "log.hpp"
+#include "types_value.hpp"
 #include "../config.hpp"
 
 /// @cond _internal
@@ -48,10 +51,21 @@ public:
 };
 
 API_EXCLUDE_BEGIN;
-class ValueConverterMap : public std::map< size_t, std::map<size_t, std::shared_ptr<const ValueConverterBase> > >
+/**
+ * Table of the converters for all pairs of types (indexed by the ids of the source and the destination type).
+ * It is filled once on construction and never changed afterwards, so it can be read from any thread.
+ */
+class ValueConverterMap
 {
+	static constexpr size_t types = std::variant_size_v<ValueTypes>;
+	std::array<std::array<std::shared_ptr<const ValueConverterBase>, types>, types> table;
 public:
 	ValueConverterMap();
+	/// \returns the converter from fromID to toID (which is empty if there is none)
+	[[nodiscard]] const std::shared_ptr<const ValueConverterBase> &get( size_t fromID, size_t toID )const {
+		assert( fromID < types && toID < types );
+		return table[fromID][toID];
+	}
 };
 
 }
@@ -220,12 +220,9 @@ ValueArray ValueArray::createByID(unsigned short ID, std::size_t len)
 {
 	ValueArray ret;
 	if(ID<std::variant_size_v<util::ValueTypes>) {
-		auto f1 = converters().find(ID);
-		_internal::ValueArrayConverterMap::mapped_type::const_iterator f2;
 		// try to get a converter to convert the requested type into itself - they're there for all known types
-		if (f1 != converters().end() && (f2 = f1->second.find(ID)) != f1->second.end()) {
-			const ValueArrayConverterBase &conv = *(f2->second);
-			ret = conv.create(len);
+		if (const Converter &conv = converters().get(ID, ID)) {
+			ret = conv->create(len);
 			LOG_IF(!ret.isValid(), Runtime, error) << "The created array is not valid, this is not going to end well..";
 		}
 		else {
@@ -247,45 +244,274 @@ ValueArray ValueArray::cloneToNew(std::size_t length) const
 }
 
 std::size_t ValueArray::compare(std::size_t start, std::size_t end, const ValueArray& dst, std::size_t dst_start) const
+{
+	return diff(start, end, dst, dst_start).differing;
+}
+
+DiffStats ValueArray::diff(size_t start, size_t end, const ValueArray &dst, size_t dst_start, double abs_eps, double rel_eps)const
 {
 	assert( start <= end );
-	size_t ret = 0;
-	size_t _length = end - start;
-
-	if ( dst.getTypeID() != getTypeID() ) {
-		LOG( Debug, error )
-		<< "Comparing to a ValueArray of different type(" << dst.typeName() << ", not " << typeName()
-		<< "). Assuming all voxels to be different";
-		return _length;
+	LOG_IF( end > getLength(), Runtime, error )
+	<< "End of the range (" << end << ") is behind the end of this ValueArray (" << getLength() << ")";
+	LOG_IF( end - start + dst_start > dst.getLength(), Runtime, error )
+	<< "End of the range (" << end - start + dst_start << ") is behind the end of the destination (" << dst.getLength() << ")";
+
+	return _internal::diff({{this, start, &dst, dst_start, end - start}}, abs_eps, rel_eps);
+}
+
+std::string ValueArray::hash( util::Hasher::algorithm algo )const
+{
+	return _internal::hash( {this}, algo );
+}
+
+double DiffStats::rms() const
+{
+	return compared ? std::sqrt( sum_sq / compared ) : 0;
+}
+DiffStats &DiffStats::merge(const DiffStats &other, size_t offset)
+{
+	compared += other.compared;
+	differing += other.differing;
+	sum_sq += other.sum_sq;
+	max_rel = std::max( max_rel, other.max_rel );
+
+	if( first == npos && other.first != npos )
+		first = other.first + offset;
+
+	if( other.worst != npos && ( worst == npos || other.max_abs > max_abs ) ) {
+		worst = other.worst + offset;
+		max_abs = other.max_abs;
 	}
 
-	LOG_IF( end >= getLength(), Runtime, error )
-	<< "End of the range (" << end << ") is behind the end of this ValueArray (" << getLength() << ")";
-	LOG_IF( _length + dst_start >= dst.getLength(), Runtime, error )
-	<< "End of the range (" << _length + dst_start << ") is behind the end of the destination (" << dst.getLength() << ")";
-
-	// lock the memory, so we can mem-compare the elements (use uint8_t because some compilers do not like arith on void*)
-	const std::shared_ptr<const uint8_t>
-	src_s = std::static_pointer_cast<const uint8_t>( getRawAddress() ),
-	dst_s = std::static_pointer_cast<const uint8_t>( dst.getRawAddress() );
-	const uint8_t *src_p = src_s.get(), *dst_p = dst_s.get();
-	const size_t el_size = bytesPerElem();
-
-	for ( size_t i = start; i < end; i++ ) {
-		if ( memcmp( src_p + ( i * el_size ), dst_p + ( i * el_size ), el_size ) != 0 )
-			ret++;
+	return *this;
+}
+std::ostream &operator<<(std::ostream &os, const DiffStats &stats)
+{
+	os << stats.differing << " of " << stats.compared << " values differ";
+
+	if( stats.worst != DiffStats::npos )
+		os << ", max abs error " << stats.max_abs << " at " << stats.worst << ", max rel error " << stats.max_rel << ", rms error " << stats.rms();
+
+	if( stats.first != DiffStats::npos )
+		os << ", first difference at " << stats.first;
+
+	return os;
+}
+
+namespace _internal{
+namespace{
+constexpr size_t diff_block_size = 1024 * 1024; // elements per parallel job
+constexpr size_t diff_run_size = 4096; // elements which are memcmp'ed at once to skip identical parts
+
+template<typename T> constexpr bool is_diff_scalar = std::is_arithmetic_v<T>;
+
+template<typename T> void diffScalar( const T *a, const T *b, size_t len, double abs_eps, double rel_eps, DiffStats &stats, size_t offset )
+{
+	for( size_t i = 0; i < len; i++ ) {
+		if( a[i] == b[i] )
+			continue;
+
+		const double va = a[i], vb = b[i];
+		double d, rel;
+		bool differs;
+
+		if( std::isfinite( va ) && std::isfinite( vb ) ) {
+			const double magnitude = std::max( std::abs( va ), std::abs( vb ) );
+			d = std::abs( va - vb );
+			rel = magnitude > 0 ? d / magnitude : 0;
+			differs = d > abs_eps && d > rel_eps * magnitude;
+		} else if( ( std::isnan( va ) && std::isnan( vb ) ) || va == vb ) {
+			continue; // two NaNs, or two infinities of the same sign
+		} else { // any other combination with NaN or infinity differs, no matter the eps
+			d = rel = std::numeric_limits<double>::infinity();
+			differs = true;
+		}
+
+		stats.sum_sq += d * d;
+		stats.max_rel = std::max( stats.max_rel, rel );
+
+		if( d > stats.max_abs || stats.worst == DiffStats::npos ) {
+			stats.max_abs = d;
+			stats.worst = offset + i;
+		}
+
+		if( differs ) {
+			if( stats.first == DiffStats::npos )
+				stats.first = offset + i;
+
+			stats.differing++;
+		}
+	}
+}
+
+/// compare equal typed ranges, skipping runs which are bitwise identical
+template<typename T> DiffStats diffTyped( const T *a, const T *b, size_t len, double abs_eps, double rel_eps )
+{
+	DiffStats ret;
+	ret.compared = len;
+
+	for( size_t run = 0; run < len; run += diff_run_size ) {
+		const size_t run_len = std::min( diff_run_size, len - run );
+
+		if( memcmp( a + run, b + run, run_len * sizeof( T ) ) == 0 )
+			continue;
+
+		if constexpr( is_diff_scalar<T> ) {
+			diffScalar( a + run, b + run, run_len, abs_eps, rel_eps, ret, run );
+		} else {
+			for( size_t i = run; i < run + run_len; i++ )
+				if( memcmp( a + i, b + i, sizeof( T ) ) != 0 ) {
+					if( ret.first == DiffStats::npos )
+						ret.first = i;
+
+					ret.differing++;
+				}
+		}
 	}
 
 	return ret;
 }
 
+bool isScalar( const ValueArray &array )
+{
+	return array.visit( []( auto ptr ) {return is_diff_scalar<typename decltype( ptr )::element_type>;} );
+}
+
+void copyAsDouble( const ValueArray &array, size_t start, size_t len, double *dst )
+{
+	array.visit( [&]( auto ptr ) {
+		typedef typename decltype( ptr )::element_type element_type;
+
+		if constexpr( is_diff_scalar<element_type> )
+			std::copy( ptr.get() + start, ptr.get() + start + len, dst );
+	} );
+}
+
+DiffStats diffRange( const DiffRange &range, double abs_eps, double rel_eps )
+{
+	const ValueArray &a = *range.first, &b = *range.second;
+
+	if( a.getTypeID() == b.getTypeID() ) {
+		return a.visit( [&]( auto ptr ) {
+			typedef typename decltype( ptr )::element_type element_type;
+			return diffTyped<element_type>(
+				ptr.get() + range.first_start, b.beginTyped<element_type>() + range.second_start, range.length, abs_eps, rel_eps
+			);
+		} );
+	} else if( isScalar( a ) && isScalar( b ) ) { // compare different scalar types as double
+		DiffStats ret;
+		std::vector<double> buff_a( std::min( diff_run_size, range.length ) ), buff_b( buff_a.size() );
+
+		for( size_t run = 0; run < range.length; run += diff_run_size ) {
+			const size_t run_len = std::min( diff_run_size, range.length - run );
+			copyAsDouble( a, range.first_start + run, run_len, buff_a.data() );
+			copyAsDouble( b, range.second_start + run, run_len, buff_b.data() );
+			ret.merge( diffTyped( buff_a.data(), buff_b.data(), run_len, abs_eps, rel_eps ), run );
+		}
+
+		return ret;
+	} else {
+		DiffStats ret;
+		ret.compared = ret.differing = range.length;
+		ret.first = 0;
+		return ret;
+	}
+}
+}
+
+DiffStats diff( const std::vector<DiffRange> &ranges, double abs_eps, double rel_eps )
+{
+	// split the ranges into blocks which can be compared independently
+	std::vector<std::pair<DiffRange, size_t>> blocks; // the block and its offset in the whole range
+	size_t offset = 0;
+
+	for( const DiffRange &range : ranges ) {
+		LOG_IF(
+			range.first->getTypeID() != range.second->getTypeID() && !( isScalar( *range.first ) && isScalar( *range.second ) ),
+			Debug, warning
+		) << "Comparing " << range.first->typeName() << " to " << range.second->typeName() << ". Assuming all voxels to be different";
+
+		for( size_t begin = 0; begin < range.length; begin += diff_block_size ) {
+			const size_t len = std::min( diff_block_size, range.length - begin );
+			blocks.push_back( {{range.first, range.first_start + begin, range.second, range.second_start + begin, len}, offset + begin} );
+		}
+
+		offset += range.length;
+	}
+
+	std::vector<DiffStats> results( blocks.size() );
+	util::parallelFor( blocks.size(), [&]( size_t begin, size_t end ) {
+		for( size_t b = begin; b < end; b++ )
+			results[b] = diffRange( blocks[b].first, abs_eps, rel_eps );
+	} );
+
+	DiffStats ret;
+
+	for( size_t b = 0; b < blocks.size(); b++ ) // merge in order, so first really is the first difference
+		ret.merge( results[b], blocks[b].second );
+
+	return ret;
+}
+
+std::string hash( const std::vector<const ValueArray *> &arrays, util::Hasher::algorithm algo )
+{
+	constexpr size_t block_size = 1024 * 1024; // elements per parallel job
+	struct Part {const ValueArray *array; size_t start, length;};
+
+	// split the data into blocks at fixed positions in the whole sequence
+	size_t volume = 0;
+
+	for( const ValueArray *array : arrays )
+		volume += array->getLength();
+
+	std::vector<std::vector<Part>> blocks( ( volume + block_size - 1 ) / block_size );
+	size_t pos = 0;
+
+	for( const ValueArray *array : arrays )
+		for( size_t start = 0; start < array->getLength(); ) {
+			const size_t block = pos / block_size;
+			const size_t length = std::min( array->getLength() - start, ( block + 1 ) * block_size - pos );
+			blocks[block].push_back( {array, start, length} );
+			start += length;
+			pos += length;
+		}
+
+	std::vector<std::string> digests( blocks.size() );
+	util::parallelFor( blocks.size(), [&]( size_t begin, size_t end ) {
+		for( size_t b = begin; b < end; b++ ) {
+			util::Hasher hasher( algo );
+			unsigned short type = 0;
+
+			for( const Part &part : blocks[b] ) {
+				if( part.array->getTypeID() != type ) { // the type only counts where it changes, so splitting arrays doesn't change the hash
+					type = part.array->getTypeID();
+					hasher.update( part.array->typeName() );
+				}
+
+				const size_t elem_size = part.array->bytesPerElem();
+				const auto data = std::static_pointer_cast<const uint8_t>( part.array->getRawAddress() );
+				hasher.update( data.get() + part.start * elem_size, part.length * elem_size );
+			}
+
+			digests[b] = hasher.digest();
+		}
+	} );
+
+	util::Hasher hasher( algo );
+	hasher.update( uint64_t( volume ) );
+
+	for( const std::string &digest : digests )
+		hasher.update( digest );
+
+	return hasher.digest();
+}
+}
+
 const ValueArray::Converter & ValueArray::getConverterFromTo(unsigned short fromID, unsigned short toID)
 {
-	const auto f1 = converters().find( fromID );
-	LOG_IF( f1 == converters().end(), Debug, error ) << "There is no known conversion from " << util::getTypeMap().at(fromID);
-	const auto f2 = f1->second.find( toID );
-	LOG_IF( f2 == f1->second.end(), Debug, error ) << "There is no known conversion from " << util::getTypeMap().at(fromID) << " to " << util::getTypeMap().at(toID);
-	return f2->second;
+	const Converter &ret = converters().get( fromID, toID );
+	LOG_IF( !ret, Debug, error ) << "There is no known conversion from " << util::getTypeMap().at(fromID) << " to " << util::getTypeMap().at(toID);
+	return ret;
 }
 
 const ValueArray::Converter & ValueArray::getConverterTo(unsigned short ID) const
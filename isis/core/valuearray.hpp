@@ -9,6 +9,8 @@
 #include "valuearray_converter.hpp"
 #include "valuearray_minmax.hpp"
 #include "valuearray_iterator.hpp"
+#include "hash.hpp"
+#include "memorypool.hpp"
 
 
 namespace isis::data{
@@ -25,9 +27,47 @@ struct scaling_pair {
 	friend std::ostream &operator<<(std::ostream &os, const scaling_pair &pair);
 };
 
+/**
+ * Statistics about the differences between two ranges of values (see ValueArray::diff).
+ * The numeric statistics are only computed for scalar types, for other types only differing elements are counted.
+ */
+struct DiffStats {
+	static constexpr size_t npos = std::numeric_limits<size_t>::max();
+	size_t compared = 0; ///< amount of compared elements
+	size_t differing = 0; ///< amount of elements which differ by more than the tolerance
+	double max_abs = 0; ///< biggest absolute difference
+	double max_rel = 0; ///< biggest difference relative to the bigger magnitude of both values
+	double sum_sq = 0; ///< sum of the squared differences
+	size_t first = npos; ///< index of the first element which differs by more than the tolerance
+	size_t worst = npos; ///< index of the element with the biggest absolute difference
+	[[nodiscard]] double rms()const;
+	/// add the statistics of a range which starts at offset
+	DiffStats &merge( const DiffStats &other, size_t offset );
+	friend std::ostream &operator<<( std::ostream &os, const DiffStats &stats );
+};
+
 class ValueArray;
 
 namespace _internal{
+/// A pair of ranges to be compared by _internal::diff.
+struct DiffRange {
+	const ValueArray *first;
+	size_t first_start;
+	const ValueArray *second;
+	size_t second_start;
+	size_t length;
+};
+/**
+ * Compare pairs of ranges in parallel.
+ * The statistics are accumulated as if all ranges were one consecutive range.
+ */
+DiffStats diff( const std::vector<DiffRange> &ranges, double abs_eps, double rel_eps );
+/**
+ * Hash the data of consecutive ValueArrays (see ValueArray::hash).
+ * The data is hashed in blocks of fixed size in parallel, and the hashes of the blocks are hashed together.
+ * As the blocks don't depend on the boundaries of the arrays, only their concatenation is relevant.
+ */
+std::string hash( const std::vector<const ValueArray *> &arrays, util::Hasher::algorithm algo );
 
 /// Proxy-Deleter to encapsulate the real deleter/shared_ptr when creating shared_ptr for parts of a shared_ptr
 class DelProxy : public std::shared_ptr<const void>
@@ -95,7 +135,7 @@ protected:
 public:
 	template<int I> using TypeByIndex = typename std::variant_alternative<I, ArrayTypes>::type;
 
-	using Converter = _internal::ValueArrayConverterMap::mapped_type::mapped_type;
+	using Converter = _internal::ConverterPtr;
 	using iterator =  _internal::GenericValueIterator<false>;
 	using const_iterator = _internal::GenericValueIterator<true>;
 	using reference = iterator::reference;
@@ -128,12 +168,24 @@ public:
 	 * Creates a ValueArray pointing to a newly allocated array of elements of the given type.
 	 * The array is zero-initialized.
 	 * If the requested length is 0 no memory will be allocated and the pointer will be "empty".
+	 * Unless a custom deleter is given the memory comes from (and goes back to) the MemoryPool.
+	 * Beyond the memory budget of the MemoryPool that will be memory mapped from a scratch file.
 	 * \param length amount of elements in the new array
 	 */
 	template<KnownArrayType T, typename DELETER=ValueArray::BasicDeleter>
 	static ValueArray make(size_t length, const DELETER &deleter=DELETER() ){
-		return ValueArray(( T * )calloc(length, sizeof( T ) ), length, deleter );
+		if constexpr(std::is_same_v<DELETER, BasicDeleter>)
+			return ValueArray(std::static_pointer_cast<T>(MemoryPool::acquire(length * sizeof( T ) ) ), length );
+		else
+			return ValueArray(( T * )calloc(length, sizeof( T ) ), length, deleter );
 	} //@todo maybe make it TypedArray
+	/**
+	 * Same as make, but the memory is not initialized.
+	 * Only use this if all of the array is going to be overwritten anyway.
+	 */
+	template<KnownArrayType T> static ValueArray makeUninitialized(size_t length){
+		return ValueArray(std::static_pointer_cast<T>(MemoryPool::acquire(length * sizeof( T ), false ) ), length );
+	}
 	
 	template<typename VIS> decltype(auto) visit(VIS&& visitor)
 	{
@@ -318,16 +370,34 @@ public:
 	/**
 	 * Compare the data of two ValueArray.
 	 * Counts how many elements in this and the given ValueArray are different within the given range.
-	 * If the type of this is not equal to the type of the given ValueArray the whole length is assumed to be different.
+	 * Scalar values of different types are compared as double, other types of data are only equal if they are of the same type.
 	 * If the given range does not fit into this or the given ValueArray an error is send to the runtime log and the function will probably crash.
 	 * \param start the first element in this, which should be compared to the first element in the given compare destination
 	 * \param end the first element in this, which should _not_ be compared anymore to the given compare ValueArray
 	 * \param dst the given destination ValueArray this should be compared to
 	 * \param dst_start the first element in the given destination ValueArray, which should be compared to the first element in this
-	 * \returns the amount of elements which actually differ in both ValueArray or the whole length of the range when the types are not equal.
+	 * \returns the amount of elements which actually differ in both ValueArray or the whole length of the range when the types cannot be compared.
 	 */
 	size_t compare(size_t start, size_t end, const ValueArray &dst, size_t dst_start )const;
 
+	/**
+	 * Compare the data of two ValueArray and compute statistics about the differences.
+	 * The range is compared block wise in parallel. Blocks that are bitwise identical are skipped quickly.
+	 * Scalar values count as different if their absolute difference is bigger than abs_eps and bigger than rel_eps times the bigger magnitude of both.
+	 * NaN is equal to NaN, but infinitely different from anything else.
+	 * Scalar values of different types are compared as double (so 64bit integers beyond 2^53 may lose precision).
+	 * The parameters are the same as for compare, the indexes in the result are relative to start.
+	 */
+	[[nodiscard]] DiffStats diff( size_t start, size_t end, const ValueArray &dst, size_t dst_start, double abs_eps = 0, double rel_eps = 0 )const;
+
+	/**
+	 * Compute a hash of the stored data.
+	 * The hash covers the raw data and the type of the elements (but not the length of the memory that is actually allocated).
+	 * It is computed in parallel and equal to the hash of any other sequence of ValueArrays of the same type that hold the same data (see Image::contentHash).
+	 * \returns the hash as lowercase hex string
+	 */
+	[[nodiscard]] std::string hash( util::Hasher::algorithm algo = util::Hasher::xxh64 )const;
+
 	[[nodiscard]] bool isValid()const;
 
 	/// return a shared pointer to void with optional offset in bytes
@@ -180,13 +180,15 @@ template<typename SRC, typename DST> class ValueArrayGenerator: public ValueArra
 {
 public:
 	[[nodiscard]] ValueArray create(const size_t len )const override {
-		void *allocated=calloc(len, sizeof( DST ) );
-		LOG_IF(allocated==nullptr,Runtime,error) << "Failed to allocate " << len*sizeof( DST ) << " bytes (" << strerror(errno)<<")";
-		return ValueArray(static_cast<DST *>(allocated), len );
+		ValueArray ret=ValueArray::make<DST>(len );
+		LOG_IF(len && !ret.getRawAddress(),Runtime,error) << "Failed to allocate " << len*sizeof( DST ) << " bytes (" << strerror(errno)<<")";
+		return ret;
 	}
 	[[nodiscard]] ValueArray generate(const ValueArray &src, const scaling_pair &scaling )const override {
-		//Create new "stuff" in memory
-		ValueArray dst=create(src.getLength() );
+		//Create new "stuff" in memory (numeric conversions write every element, so there is no need to zero it first)
+		ValueArray dst=std::is_arithmetic_v<SRC> && std::is_arithmetic_v<DST> ?
+			ValueArray::makeUninitialized<DST>(src.getLength() ):
+			create(src.getLength() );
 		convert( src, dst, scaling );//and convert into that
 		return dst;
 	}
@@ -454,8 +456,18 @@ ValueArrayConverterMap::ValueArrayConverterMap()
 	LOG( Debug, info ) << "Initializing liboil";
 	oil_init();
 #endif // ISIS_USE_LIBOIL
-	makeOuterConv( *this );
-	LOG( Debug, info ) << "conversion map for " << size() << " array-types created";
+	makeOuterConv( table );
+	LOG( Debug, info ) << "conversion map for " << std::variant_size_v<ArrayTypes> << " array-types created";
+}
+
+const ConverterPtr &ValueArrayConverterMap::get( size_t fromID, size_t toID )const
+{
+	static const ConverterPtr none;
+
+	if( fromID < table.size() && toID < table.size() )
+		return table[fromID][toID];
+	else
+		return none;
 }
 
 }
@@ -20,7 +20,7 @@
 #pragma once
 
 #include <memory>
-#include <map>
+#include <array>
 #include "value.hpp"
 
 /// @cond _internal
@@ -46,13 +46,20 @@ API_EXCLUDE_BEGIN;
 namespace _internal
 {
 typedef std::shared_ptr<const ValueArrayConverterBase> ConverterPtr;
-typedef std::map< size_t, std::map<size_t, ConverterPtr> > ConverterMap;
+// indexed by the type ids (of util::Value), so there are empty entries for the types that are no array types
+typedef std::array<std::array<ConverterPtr, util::Value::NumOfTypes>, util::Value::NumOfTypes> ConverterMap;
 
-
-class ValueArrayConverterMap : public ConverterMap
+/**
+ * Table of the converters for all pairs of array types (indexed by the ids of the source and the destination type).
+ * It is filled once on construction and never changed afterwards, so it can be read from any thread.
+ */
+class ValueArrayConverterMap
 {
+	ConverterMap table;
 public:
 	ValueArrayConverterMap();
+	/// \returns the converter from fromID to toID (which is empty if there is none)
+	[[nodiscard]] const ConverterPtr &get( size_t fromID, size_t toID )const;
 };
 
 }
@@ -17,3 +17,43 @@
  */
 
 #include "binarise.hpp"
+
+namespace isis::math{
+
+double otsu_thres(const Histogram &hist){
+	const size_t total=hist.total();
+	if(total==0)
+		return hist.binCenter(0);
+
+	double mu_t=0;
+	for(size_t i=0;i<hist.bins.size();i++)
+		mu_t+=hist.bins[i]*hist.binCenter(i);
+	mu_t/=total;
+
+	// maximize the between class variance (sigma_b^2 = (mu_t*omega - mu)^2 / (omega*(1-omega)))
+	size_t below=0,idx1=0,idx2=0;
+	double mu=0,max=-1;
+	for(size_t i=0;i<hist.bins.size();i++){
+		below+=hist.bins[i];
+		mu+=hist.bins[i]*hist.binCenter(i)/total;
+		if(below==0 || below==total)
+			continue;
+		const double omega=double(below)/total;
+		const double sigma_b_squared=std::pow(mu_t*omega-mu,2)/(omega*(1-omega));
+		if(sigma_b_squared>max){
+			max=sigma_b_squared;
+			idx1=idx2=i;
+		} else if(sigma_b_squared==max)
+			idx2=i;
+	}
+	//M: idx = mean(find(sigma_b_squared == maxval));
+	return hist.binCenter(idx1+(idx2-idx1)/2);
+}
+double otsu_thres(const data::ValueArray &data, size_t bins){
+	return otsu_thres(histogram(data,bins));
+}
+double otsu_thres(const data::Image &image, size_t bins){
+	return otsu_thres(histogram(image,bins));
+}
+
+}
@@ -21,47 +21,30 @@
 #include "histogram.hpp"
 
 namespace isis::math{
-namespace _internal{
-
-template<typename T, typename IType> T otsu_thres_impl(const IType &image){
-	static_assert( std::is_integral<T>::value , "cannot compute threshold from non-integer types" );
-	auto hstg=histogram(image.begin(),image.end());
-	auto hstg_n=math::normalize_histogram(hstg.begin(),hstg.end(), image.getVolume());
-
-	typedef decltype(hstg_n) hist_type;
 
-	hist_type omega;
-	std::partial_sum(hstg_n.begin(),hstg_n.end(),omega.begin());
-	
-	hist_type range,prod,mu;
-	std::iota(range.begin(),range.end(),1); 
-	prod = hstg_n * range;
-	std::partial_sum(prod.begin(),prod.end(),mu.begin()); 
-	double mu_t = mu.back();
-	
-	hist_type one;one.fill(1);
-	const auto v1 = (omega*mu_t - mu) * (omega*mu_t - mu);
-	const auto v2 = omega * (one - omega);
-	hist_type sigma_b_squared = v1 / v2;
+/**
+ * Compute the threshold separating the two classes of a histogram by Otsu's method.
+ * \returns the center of the last bin of the lower class (the bin center of the first bin, if there is only one class)
+ */
+double otsu_thres(const Histogram &hist);
+/// Compute the Otsu threshold of the values in data (see math::histogram for the meaning of bins).
+double otsu_thres(const data::ValueArray &data, size_t bins=0);
+/// Compute the Otsu threshold of the voxels of image (see math::histogram for the meaning of bins).
+double otsu_thres(const data::Image &image, size_t bins=0);
 
-	double max = *std::max_element(sigma_b_squared.begin(),sigma_b_squared.end());
-	
-	if(std::isfinite(max)){
-		//M: idx = mean(find(sigma_b_squared == maxval));
-		const size_t idx1 = std::distance(sigma_b_squared.begin(), std::find(sigma_b_squared.begin(),sigma_b_squared.end(),max));
-		const size_t idx2 = std::distance(std::find(sigma_b_squared.rbegin(),sigma_b_squared.rend(),max), sigma_b_squared.rend());
-		const size_t idx = idx1+ (idx2-idx1)/2;
-		return idx;
-	} else
-		return 0;
+namespace _internal{
+template<typename T> T threshold_cast(double thres){
+	if constexpr(std::is_integral_v<T>)
+		return static_cast<T>(std::lround(thres));
+	else
+		return static_cast<T>(thres);
 }
 }
 
 template<typename T> T otsu_thres(const data::TypedImage<T> &image){
-	return _internal::otsu_thres_impl(image);
+	return _internal::threshold_cast<T>(otsu_thres(static_cast<const data::Image&>(image)));
 }
 template<typename T> T otsu_thres(const data::TypedChunk<T> &image){
-	return _internal::otsu_thres_impl(image);
+	return _internal::threshold_cast<T>(otsu_thres(static_cast<const data::ValueArray&>(image)));
 }
 }
-
@@ -0,0 +1,309 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2018  Enrico Reimer <reimer@cbs.mpg.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filter.hpp"
+
+namespace isis::math
+{
+namespace
+{
+constexpr size_t tile_bytes = 256 * 1024; // working set of a tile (stays in the L2 cache)
+
+template<typename T> constexpr bool filterable = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+template<typename T, typename W> T toVoxel( W value )
+{
+	if constexpr( std::is_integral_v<T> ) {
+		value = std::round( value );
+
+		if( value <= W( std::numeric_limits<T>::lowest() ) )
+			return std::numeric_limits<T>::lowest();
+		else if( value >= W( std::numeric_limits<T>::max() ) )
+			return std::numeric_limits<T>::max();
+	}
+
+	return static_cast<T>( value );
+}
+
+/// The voxels of an image as seen from the filtered dimension: index = inner_idx + inner * (k + length * outer_idx)
+struct Layout {
+	size_t inner = 1, length, outer = 1;
+	std::vector<data::Chunk> chunks;
+	size_t chunk_volume;
+
+	Layout( const data::Image &img, data::dimensions dim ): chunks( img.copyChunksToVector( false ) ) {
+		const util::vector4<size_t> size = img.getSizeAsVector();
+		length = size[dim];
+		chunk_volume = chunks.front().getVolume();
+
+		for( int d = 0; d < dim; d++ )
+			inner *= size[d];
+
+		for( int d = dim + 1; d < 4; d++ )
+			outer *= size[d];
+	}
+
+	/// call op(ptr,pos,n) for the pieces of the voxels [start,start+count) that are contiguous in a chunk
+	template<typename OP> void forPieces( size_t start, size_t count, OP &&op )const {
+		for( size_t pos = 0; pos < count; ) {
+			const size_t c = start / chunk_volume, offset = start - c * chunk_volume;
+			const size_t n = std::min( count - pos, chunk_volume - offset );
+			chunks[c].visit( [&]( auto ptr ) {
+				if constexpr( filterable<typename decltype( ptr )::element_type> )
+					op( ptr.get() + offset, pos, n );
+			} );
+			pos += n;
+			start += n;
+		}
+	}
+
+	/**
+	 * Copy the lines of a tile from the image into buffer (or back if store is set).
+	 * In the buffer the lines are interleaved: buffer[k * count + line].
+	 * If inner is 1 (filtering along rows) the lines of a tile are count consecutive rows starting at outer_idx,
+	 * otherwise they are the count neighbouring voxels starting at first.
+	 */
+	template<typename W> void transfer( size_t outer_idx, size_t first, size_t count, W *buffer, bool store )const {
+		auto copy = [store]( auto &voxel, W &value ) {
+			if( store )
+				voxel = toVoxel<std::remove_reference_t<decltype( voxel )>>( value );
+			else
+				value = voxel;
+		};
+
+		if( inner > 1 ) {
+			for( size_t k = 0; k < length; k++ )
+				forPieces( first + inner * ( k + length * outer_idx ), count, [&]( auto *x, size_t pos, size_t n ) {
+					W *const b = buffer + k * count + pos;
+					for( size_t i = 0; i < n; i++ )
+						copy( x[i], b[i] );
+				} );
+		} else {
+			for( size_t line = 0; line < count; line++ )
+				forPieces( length * ( outer_idx + line ), length, [&]( auto *x, size_t pos, size_t n ) {
+					W *const b = buffer + pos * count + line;
+					for( size_t i = 0; i < n; i++ )
+						copy( x[i], b[i * count] );
+				} );
+		}
+	}
+};
+
+/// convolution with a sampled kernel
+struct FIR {
+	const Kernel &kernel;
+	size_t pad;
+	/// out[k] = sum_j kernel[j] * in[k + pad - j] for each line, in has pad extra elements at both ends
+	template<typename W> void operator()( const W *in, W *out, size_t length, size_t count )const {
+		const size_t n = length * count;
+		std::fill( out, out + n, W( 0 ) );
+
+		// one pass for each tap over the whole tile, so the inner loop is long and contiguous
+		for( size_t j = 0; j < kernel.size(); j++ ) {
+			const W weight = kernel[kernel.size() - 1 - j];
+			const W *__restrict x = in + j * count;
+			W *__restrict o = out;
+
+			for( size_t i = 0; i < n; i++ )
+				o[i] += weight * x[i];
+		}
+	}
+};
+
+/// third order recursive gaussian after Young and van Vliet (1995)
+struct IIR {
+	double B, b1, b2, b3;
+	size_t pad = 0;
+	explicit IIR( double sigma ) {
+		const double q = sigma >= 2.5 ? 0.98711 * sigma - 0.96330 : 3.97156 - 4.14554 * std::sqrt( 1 - 0.26891 * sigma );
+		const double q2 = q * q, q3 = q2 * q;
+		const double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+		b1 = ( 2.44413 * q + 2.85619 * q2 + 1.26661 * q3 ) / b0;
+		b2 = -( 1.4281 * q2 + 1.26661 * q3 ) / b0;
+		b3 = 0.422205 * q3 / b0;
+		B = 1 - ( b1 + b2 + b3 );
+	}
+	template<typename W> void operator()( const W *in, W *out, size_t length, size_t count )const {
+		const W B = this->B, b1 = this->b1, b2 = this->b2, b3 = this->b3;
+		auto row = [count]( auto *base, size_t k ) {return base + k * count;};
+
+		// causal pass, before the first voxel the steady state of a constant input is the input itself
+		for( size_t k = 0; k < length; k++ ) {
+			const W *x = row( in, k ), *p1 = k > 0 ? row( out, k - 1 ) : in, *p2 = k > 1 ? row( out, k - 2 ) : in, *p3 = k > 2 ? row( out, k - 3 ) : in;
+			W *o = row( out, k );
+
+			for( size_t i = 0; i < count; i++ )
+				o[i] = B * x[i] + b1 * p1[i] + b2 * p2[i] + b3 * p3[i];
+		}
+
+		// anti-causal pass in place, after the last voxel the steady state is the last result of the causal pass
+		const std::vector<W> edge( row( out, length - 1 ), row( out, length ) );
+
+		for( size_t k = length; k-- > 0; ) {
+			const W *n1 = k + 1 < length ? row( out, k + 1 ) : edge.data();
+			const W *n2 = k + 2 < length ? row( out, k + 2 ) : edge.data();
+			const W *n3 = k + 3 < length ? row( out, k + 3 ) : edge.data();
+			W *o = row( out, k );
+
+			for( size_t i = 0; i < count; i++ )
+				o[i] = B * o[i] + b1 * n1[i] + b2 * n2[i] + b3 * n3[i];
+		}
+	}
+};
+
+template<typename W, typename OP> void process( const Layout &layout, const OP &op )
+{
+	const size_t padded = layout.length + 2 * op.pad;
+	const size_t lines = layout.inner > 1 ? layout.inner : layout.outer;
+	const size_t tile = std::clamp<size_t>( tile_bytes / sizeof( W ) / padded, 1, lines );
+	const size_t tiles = ( lines + tile - 1 ) / tile;
+	const size_t jobs = layout.inner > 1 ? tiles * layout.outer : tiles;
+
+	LOG( Debug, verbose_info ) << "Filtering " << layout.inner *layout.outer << " lines of " << layout.length << " voxels in " << jobs << " tiles";
+	util::parallelFor( jobs, [&]( size_t begin, size_t end ) {
+		std::vector<W> in, out;
+
+		for( size_t job = begin; job < end; job++ ) {
+			size_t outer_idx, first = 0, count;
+
+			if( layout.inner > 1 ) {
+				outer_idx = job / tiles;
+				first = ( job % tiles ) * tile;
+				count = std::min( tile, layout.inner - first );
+			} else {
+				outer_idx = job * tile;
+				count = std::min( tile, layout.outer - outer_idx );
+			}
+
+			in.resize( padded * count );
+			out.resize( layout.length * count );
+			layout.transfer( outer_idx, first, count, in.data() + op.pad * count, false );
+
+			// repeat the first and the last voxel of each line into the padding
+			for( size_t p = 0; p < op.pad; p++ ) {
+				std::copy_n( in.begin() + op.pad * count, count, in.begin() + p * count );
+				std::copy_n( in.begin() + ( op.pad + layout.length - 1 ) * count, count, in.begin() + ( op.pad + layout.length + p ) * count );
+			}
+
+			op( in.data(), out.data(), layout.length, count );
+			layout.transfer( outer_idx, first, count, out.data(), true );
+		}
+	} );
+}
+
+template<typename OP> void filterAlong( data::Image &img, data::dimensions dim, const OP &op )
+{
+	const Layout layout( img, dim );
+	bool use_double = false;
+
+	for( const data::Chunk &ch : layout.chunks ) {
+		if( !ch.visit( []( auto ptr ) {return filterable<typename decltype( ptr )::element_type>;} ) ) {
+			LOG( Runtime, error ) << "Cannot filter " << img.identify( true, false ) << ", its type " << ch.typeName() << " is not supported";
+			throw std::domain_error( "Unsupported datatype" );
+		}
+
+		// float can't hold all values of 32/64bit integers
+		use_double |= ch.visit( []( auto ptr ) {
+			typedef typename decltype( ptr )::element_type T;
+			return std::is_same_v<T, double> || ( std::is_integral_v<T> && sizeof( T ) >= 4 );
+		} );
+	}
+
+	if( use_double )
+		process<double>( layout, op );
+	else
+		process<float>( layout, op );
+}
+}
+
+double fwhm2sigma( double fwhm )
+{
+	return fwhm / ( 2 * std::sqrt( 2 * std::log( 2. ) ) );
+}
+
+Kernel gaussianKernel( double sigma, double truncate )
+{
+	const size_t radius = std::max<size_t>( std::ceil( sigma * truncate ), 1 );
+	Kernel ret( radius * 2 + 1 );
+
+	for( size_t i = 0; i < ret.size(); i++ ) {
+		const double x = double( i ) - radius;
+		ret[i] = std::exp( -x * x / ( 2 * sigma * sigma ) );
+	}
+
+	const double sum = std::accumulate( ret.begin(), ret.end(), 0. );
+	for( double &w : ret )
+		w /= sum;
+
+	return ret;
+}
+
+Kernel boxKernel( size_t width )
+{
+	LOG_IF( width % 2 == 0, Runtime, warning ) << "The width of a box kernel should be odd, using " << width + 1;
+	width |= 1;
+	return Kernel( width, 1. / width );
+}
+
+void convolve( data::Image &img, data::dimensions dim, const Kernel &kernel )
+{
+	if( kernel.size() % 2 == 0 ) {
+		LOG( Runtime, error ) << "Refusing to convolve with a kernel of even length " << kernel.size();
+		throw std::invalid_argument( "Kernel length must be odd" );
+	}
+
+	filterAlong( img, dim, FIR{kernel, kernel.size() / 2} );
+}
+
+void convolve( data::Image &img, const std::array<Kernel, 3> &kernels )
+{
+	for( int d = data::rowDim; d <= data::sliceDim; d++ )
+		if( !kernels[d].empty() )
+			convolve( img, data::dimensions( d ), kernels[d] );
+}
+
+void recursiveGaussian( data::Image &img, data::dimensions dim, double sigma )
+{
+	LOG_IF( sigma < 0.5, Runtime, warning ) << "The recursive gaussian is inaccurate for sigma " << sigma << "<0.5";
+	filterAlong( img, dim, IIR( sigma ) );
+}
+
+void gaussian( data::Image &img, util::dvector3 sigma, bool physical_space, gauss_method method )
+{
+	if( physical_space ) {
+		const util::dvector3 spacing = img.getValueAs<util::dvector3>( "voxelSize" ) + img.getValueAsOr( "voxelGap", util::dvector3{0, 0, 0} );
+
+		for( int d = data::rowDim; d <= data::sliceDim; d++ )
+			sigma[d] /= spacing[d];
+	}
+
+	for( int d = data::rowDim; d <= data::sliceDim; d++ ) {
+		if( sigma[d] <= 0 || img.getDimSize( d ) < 2 )
+			continue;
+
+		const bool recursive = method == gauss_method::recursive || ( method == gauss_method::automatic && sigma[d] > 3 );
+		LOG( Debug, info ) << "Smoothing along " << data::dimensions( d ) << " with sigma " << sigma[d] << " voxels" << ( recursive ? " (recursive)" : "" );
+
+		if( recursive )
+			recursiveGaussian( img, data::dimensions( d ), sigma[d] );
+		else
+			convolve( img, data::dimensions( d ), gaussianKernel( sigma[d] ) );
+	}
+}
+}
@@ -0,0 +1,83 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2018  Enrico Reimer <reimer@cbs.mpg.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "../core/image.hpp"
+#include "common.hpp"
+
+namespace isis::math
+{
+/// a one dimensional kernel of odd length, centered at its middle element
+typedef std::vector<double> Kernel;
+
+enum class gauss_method {automatic, fir, recursive};
+
+/// convert the full width at half maximum of a gaussian into its standard deviation
+double fwhm2sigma( double fwhm );
+
+/**
+ * Create a sampled and normalized gaussian kernel.
+ * \param sigma the standard deviation in voxels
+ * \param truncate the radius of the kernel in multiples of sigma
+ */
+Kernel gaussianKernel( double sigma, double truncate = 4 );
+
+/// create a normalized box kernel (a moving average) of the given odd width
+Kernel boxKernel( size_t width );
+
+/**
+ * Convolve the voxels of an image with a kernel along one of its dimensions.
+ * The voxels of the image are replaced by the result (and thus also in all images sharing their memory).
+ * The borders are handled by repeating the first/last voxel.
+ * Rows are filtered one by one, for all other dimensions tiles of neighbouring rows are filtered at once so the
+ * memory is read in whole cache lines and the inner loops run across the tile. The tiles are processed in parallel.
+ * The computation is done in double precision for double and 32/64bit integer images and in single precision otherwise,
+ * integer results are rounded and clamped to the range of their type.
+ * \param img the image to filter (of any scalar type except bool)
+ * \param dim the dimension along which the kernel is applied
+ * \param kernel the kernel (must have an odd length)
+ * \throws std::domain_error if the type of img is not supported
+ */
+void convolve( data::Image &img, data::dimensions dim, const Kernel &kernel );
+
+/**
+ * Convolve the voxels of an image with a separable kernel.
+ * \param kernels the kernels for the row, column and slice direction (empty kernels are skipped)
+ */
+void convolve( data::Image &img, const std::array<Kernel, 3> &kernels );
+
+/**
+ * Apply a recursive gaussian filter along one of the dimensions of an image.
+ * This uses the third order IIR approximation of Young and van Vliet, so the cost per voxel does not depend on sigma.
+ * The filter is initialized with the steady state of the border voxels at both ends.
+ * Otherwise it behaves like convolve().
+ * \param sigma the standard deviation in voxels (should be at least 0.5)
+ */
+void recursiveGaussian( data::Image &img, data::dimensions dim, double sigma );
+
+/**
+ * Smooth the spatial dimensions of an image with a gaussian kernel.
+ * \param img the image to be smoothed in place
+ * \param sigma the standard deviations along the row, column and slice direction (0 to skip a direction)
+ * \param physical_space interpret sigma in mm (using the voxelSize and voxelGap of img) instead of voxels
+ * \param method use sampled kernels or the recursive filter, automatic uses the recursive filter for sigma above 3 voxels
+ */
+void gaussian( data::Image &img, util::dvector3 sigma, bool physical_space = true, gauss_method method = gauss_method::automatic );
+}
@@ -19,45 +19,198 @@
 
 #include "histogram.hpp"
 #include "common.hpp"
+#include <mutex>
 
 namespace isis::math{
+namespace{
+constexpr size_t block_size=1024*1024;
 
-std::vector<size_t> histogram(const data::ValueArray &data)
-{
-	auto do_hist = [len=data.getLength()](auto ptr)->std::vector<size_t>{
-		typedef decltype(ptr) ptr_type;
-		if constexpr(
-			std::is_integral_v<typename ptr_type::element_type> &&
-			sizeof(typename ptr_type::element_type)<=4
-		){
-			auto hist = histogram(ptr.get(),ptr.get()+len);
-			return {hist.begin(),hist.end()};
+/// a part of the data to be binned by one thread
+struct Block{
+	const data::ValueArray *data;
+	const uint8_t *mask; // already offset to begin (or nullptr)
+	size_t begin,end;
+};
+
+template<typename T> constexpr bool is_binnable=std::is_arithmetic_v<T>;
+
+bool isBinnable(const data::ValueArray &data){
+	return data.visit([](auto ptr){return is_binnable<typename decltype(ptr)::element_type>;});
+}
+
+std::vector<uint8_t> maskFlags(const data::ValueArray &mask){
+	std::vector<uint8_t> ret(mask.getLength());
+	mask.visit([&ret](auto ptr){
+		typedef typename decltype(ptr)::element_type mask_type;
+		if constexpr(is_binnable<mask_type>){
+			std::transform(ptr.get(),ptr.get()+ret.size(),ret.begin(),[](mask_type v){return v!=mask_type();});
 		} else {
-			LOG(Runtime,error) << "Can only compute histograms of integer datatypes with 32bit or less";
+			LOG(Runtime,error) << "Cannot use a mask of type " << util::typeName<mask_type>();
 			throw std::domain_error("Unsupported datatype");
 		}
-	};
-	return data.visit(do_hist);
+	});
+	return ret;
 }
-std::vector<size_t> histogram(data::Image image)
-{
-	//make sure we have a consistent type
-	image.convertToType(image.getMajorTypeID());
-	std::vector<data::Chunk> chks = image.copyChunksToVector(false);
-	if(chks[0].isInteger() && chks[0].bytesPerElem()<=4) {
-		LOG(Runtime,info) << "Creating histogram of " << chks.size() << " Chunk(s) of " << image.getMajorTypeName() << " image.";
-		std::vector<size_t> hist = histogram(chks[0]);//get histogram of first chunk
-		for (size_t i = 1; i < chks.size(); ++i) { // if there are more chunks
-			auto new_hist = histogram(chks[i]); // get their histograms
-			assert(hist.size() == new_hist.size());  // they have the same type, so the histogram is guaranteed to be of the same size
-			std::transform(hist.begin(),  hist.end(), new_hist.begin(), hist.begin(), std::plus<>());// and add them to the first histogram
+
+/// maps every possible value of an 8/16 bit type onto its bin (or onto bins if it is not counted)
+template<typename T> std::vector<uint32_t> makeLookupTable(const Histogram &layout){
+	const double scale=layout.bins.size()/(layout.max-layout.min);
+	std::vector<uint32_t> ret(size_t(std::numeric_limits<T>::max())-std::numeric_limits<T>::min()+1);
+	for(size_t i=0;i<ret.size();i++){
+		const double v=ptrdiff_t(i)+std::numeric_limits<T>::min();
+		ret[i]= v>=layout.min && v<=layout.max ?
+			std::min<size_t>((v-layout.min)*scale,layout.bins.size()-1):
+			layout.bins.size();
+	}
+	return ret;
+}
+
+/**
+ * Bins one thread's share of the blocks.
+ * counts holds 4 interleaved histograms of bins+1 entries each (the last one collects values which are not counted),
+ * so consecutive values of the 8/16 bit path don't depend on the same counter.
+ */
+class Binner{
+	const Histogram &m_layout;
+	const size_t m_bins,m_stride;
+	std::vector<size_t> m_counts;
+	std::vector<uint32_t> m_lut;
+	unsigned short m_lut_type=0;
+public:
+	explicit Binner(const Histogram &layout):m_layout(layout),m_bins(layout.bins.size()),m_stride(m_bins+1),m_counts(m_stride*4,0){}
+	template<typename T> void operator()(const T *values,const uint8_t *mask,size_t len){
+		if constexpr(std::is_integral_v<T> && sizeof(T)<=2){
+			if(m_lut_type!=util::typeID<T>()){
+				m_lut=makeLookupTable<T>(m_layout);
+				m_lut_type=util::typeID<T>();
+			}
+			const uint32_t *lut=m_lut.data()-ptrdiff_t(std::numeric_limits<T>::min());
+			size_t *counts=m_counts.data();
+			size_t i=0;
+			if(mask){
+				for(;i+4<=len;i+=4)
+					for(size_t k=0;k<4;k++)
+						counts[k*m_stride+(mask[i+k]?lut[values[i+k]]:m_bins)]++;
+				for(;i<len;i++)
+					counts[mask[i]?lut[values[i]]:m_bins]++;
+			} else {
+				for(;i+4<=len;i+=4)
+					for(size_t k=0;k<4;k++)
+						counts[k*m_stride+lut[values[i+k]]]++;
+				for(;i<len;i++)
+					counts[lut[values[i]]]++;
+			}
+		} else {
+			const double min=m_layout.min,max=m_layout.max,scale=m_bins/(max-min);
+			for(size_t i=0;i<len;i++){
+				const double v=values[i];
+				if((!mask || mask[i]) && v>=min && v<=max) // NaN fails both comparisons
+					m_counts[std::min<size_t>((v-min)*scale,m_bins-1)]++;
+			}
 		}
-		return hist;
-	} else {
-		LOG(Runtime,error) << "Can only compute histograms of integer datatypes with 32bit or less";
+	}
+	void operator()(const Block &block){
+		block.data->visit([&](auto ptr){
+			typedef typename decltype(ptr)::element_type value_type;
+			if constexpr(is_binnable<value_type>)
+				(*this)(ptr.get()+block.begin,block.mask,block.end-block.begin);
+		});
+	}
+	void mergeInto(std::vector<size_t> &bins)const{
+		for(size_t k=0;k<4;k++)
+			for(size_t b=0;b<m_bins;b++)
+				bins[b]+=m_counts[k*m_stride+b];
+	}
+};
+
+void addBlocks(std::vector<Block> &blocks, const data::ValueArray &data, const uint8_t *mask){
+	if(!isBinnable(data)){
+		LOG(Runtime,error) << "Cannot compute the histogram of " << data.typeName() << " data";
 		throw std::domain_error("Unsupported datatype");
 	}
+	for(size_t begin=0;begin<data.getLength();begin+=block_size)
+		blocks.push_back({&data, mask?mask+begin:nullptr, begin, std::min(begin+block_size,data.getLength())});
+}
+
+Histogram makeLayout(std::pair<double,double> minmax, bool integer, size_t bins, bool default_range){
+	if(!std::isfinite(minmax.first) || !std::isfinite(minmax.second) || minmax.second<minmax.first){
+		LOG(Runtime,error) << "Invalid histogram range [" << minmax.first << "," << minmax.second << "]";
+		throw std::domain_error("Invalid histogram range");
+	}
+	if(bins==0){
+		if(integer && minmax.second-minmax.first<65536){
+			bins=minmax.second-minmax.first+1;
+			if(default_range){ // center the bins on the values
+				minmax.first-=.5;
+				minmax.second+=.5;
+			}
+		} else
+			bins=256;
+	}
+	if(minmax.second==minmax.first)
+		minmax.second=std::nextafter(minmax.first,std::numeric_limits<double>::infinity());
+	return {minmax.first,minmax.second,std::vector<size_t>(bins,0)};
 }
 
+Histogram computeHistogram(Histogram layout,const std::vector<Block> &blocks){
+	std::mutex merge_lock;
+	LOG(Debug,info) << "Binning " << blocks.size() << " block(s) into " << layout.bins.size() << " bins from " << layout.min << " to " << layout.max;
+	util::parallelFor(blocks.size(),[&](size_t begin,size_t end){
+		Binner binner(layout);
+		for(size_t b=begin;b<end;b++)
+			binner(blocks[b]);
+		std::lock_guard<std::mutex> guard(merge_lock);
+		binner.mergeInto(layout.bins);
+	});
+	return layout;
+}
+std::pair<double,double> toDouble(const std::pair<util::Value, util::Value> &minmax){
+	return {minmax.first.as<double>(),minmax.second.as<double>()};
+}
+bool allInteger(const std::vector<data::Chunk> &chunks){
+	return std::all_of(chunks.begin(),chunks.end(),[](const data::Chunk &ch){return ch.isInteger();});
+}
 }
 
+Histogram histogram(const data::ValueArray &data, size_t bins, std::optional<std::pair<double,double>> range)
+{
+	std::vector<Block> blocks;
+	addBlocks(blocks,data,nullptr);
+	return computeHistogram(makeLayout(range.value_or(toDouble(data.getMinMax())),data.isInteger(),bins,!range),blocks);
+}
+Histogram histogram(const data::ValueArray &data, const data::ValueArray &mask, size_t bins, std::optional<std::pair<double,double>> range)
+{
+	LOG_IF(mask.getLength()!=data.getLength(),Runtime,error) << "The mask has " << mask.getLength() << " values, but the data has " << data.getLength();
+	if(mask.getLength()!=data.getLength())
+		throw std::invalid_argument("mask and data differ in length");
+	const std::vector<uint8_t> flags=maskFlags(mask);
+	std::vector<Block> blocks;
+	addBlocks(blocks,data,flags.data());
+	return computeHistogram(makeLayout(range.value_or(toDouble(data.getMinMax())),data.isInteger(),bins,!range),blocks);
+}
+Histogram histogram(const data::Image &image, size_t bins, std::optional<std::pair<double,double>> range)
+{
+	const std::vector<data::Chunk> chunks=image.copyChunksToVector(false);
+	std::vector<Block> blocks;
+	for(const data::Chunk &ch:chunks)
+		addBlocks(blocks,ch,nullptr);
+	return computeHistogram(makeLayout(range.value_or(toDouble(image.getMinMax())),allInteger(chunks),bins,!range),blocks);
+}
+Histogram histogram(const data::Image &image, const data::Image &mask, size_t bins, std::optional<std::pair<double,double>> range)
+{
+	LOG_IF(mask.getSizeAsVector()!=image.getSizeAsVector(),Runtime,error) << "The mask has the size " << mask.getSizeAsString() << ", but the image has " << image.getSizeAsString();
+	if(mask.getSizeAsVector()!=image.getSizeAsVector())
+		throw std::invalid_argument("mask and image differ in size");
+	// the chunks of an image are consecutive, so the flags of the whole mask can be walked alongside them
+	const std::vector<uint8_t> flags=maskFlags(mask.copyAsValueArray());
+	const std::vector<data::Chunk> chunks=image.copyChunksToVector(false);
+	std::vector<Block> blocks;
+	size_t offset=0;
+	for(const data::Chunk &ch:chunks){
+		addBlocks(blocks,ch,flags.data()+offset);
+		offset+=ch.getLength();
+	}
+	return computeHistogram(makeLayout(range.value_or(toDouble(image.getMinMax())),allInteger(chunks),bins,!range),blocks);
+}
+
+}
@@ -22,6 +22,8 @@
 #include <type_traits>
 #include <cmath>
 #include <limits>
+#include <numeric>
+#include <optional>
 
 namespace isis::math{
 namespace _internal{
@@ -31,17 +33,16 @@ template<typename IType> using iter_value_t = typename std::iterator_traits<std:
 /// Compute histogram of a given range.
 /// \param begin iterator pointing to the begin of the value range
 /// \param end iterator pointing to the begin of the value range
-/// \note The iterators must resolve to integer types of up to 32 bit
-/// \returns a histogram with the absolute amount of values inside the range (the sum is the distance between begin and end).
-template<typename IType> auto histogram(IType begin,IType end) requires (std::is_integral_v<_internal::iter_value_t<IType>> && sizeof(_internal::iter_value_t<IType>)<=4)
+/// \note The iterators must resolve to integer types of up to 16 bit (use math::histogram(const data::ValueArray &) for anything else)
+/// \returns a histogram with the absolute amount of each possible value inside the range (the sum is the distance between begin and end).
+template<typename IType> std::vector<size_t> histogram(IType begin,IType end) requires (std::is_integral_v<_internal::iter_value_t<IType>> && sizeof(_internal::iter_value_t<IType>)<=2)
 {
 	typedef _internal::iter_value_t<IType> value_type;
-	constexpr size_t min = std::numeric_limits<value_type>::min();
-	constexpr size_t max = std::numeric_limits<value_type>::max();
-	std::array<size_t,max-min> ret;
-	ret.fill(0);
+	constexpr ptrdiff_t min = std::numeric_limits<value_type>::min();
+	constexpr ptrdiff_t max = std::numeric_limits<value_type>::max();
+	std::vector<size_t> ret(max-min+1,0);
 	for(auto it=begin;it!=end;++it)
-		ret[(*it)-min]++;
+		ret[ptrdiff_t(*it)-min]++;
 	return ret;
 }
 
@@ -50,16 +51,44 @@ template<typename IType> auto histogram(IType begin,IType end) requires (std::is
 /// \param end iterator pointing to the begin of the histogram
 /// \param sum of all values in the histogram. Will be automatically computed if 0
 /// \returns a normalized histogram where the summ of all values is 1
-template<typename IType> auto normalize_histogram(IType &&begin, IType &&end, size_t sum=0){
-	if(sum==0)sum=std::accumulate(begin,end,0);
-	std::array<double,std::distance(begin,end)> ret;
+template<typename IType> std::vector<double> normalize_histogram(IType begin, IType end, size_t sum=0){
+	if(sum==0)sum=std::accumulate(begin,end,size_t(0));
+	std::vector<double> ret(std::distance(begin,end));
 	std::transform(begin,end,ret.begin(),[sum](size_t v){return double(v)/sum;});
 	return ret;
 }
 
-std::vector<size_t> histogram(const data::ValueArray &data);
-std::vector<size_t> histogram(data::Image &image);
-
-}
+/**
+ * A histogram of equally wide bins spanning [min,max].
+ * A value v is counted in bin floor((v-min)/binWidth()), values equal to max in the last bin.
+ * Values outside of [min,max] and NaN are not counted.
+ */
+struct Histogram{
+	double min=0,max=0;
+	std::vector<size_t> bins;
+	[[nodiscard]] double binWidth()const{return (max-min)/bins.size();}
+	[[nodiscard]] double binCenter(size_t idx)const{return min+(idx+.5)*binWidth();}
+	/// \returns the amount of values counted in all bins
+	[[nodiscard]] size_t total()const{return std::accumulate(bins.begin(),bins.end(),size_t(0));}
+	/// \returns the relative frequency of each bin (the sum is 1)
+	[[nodiscard]] std::vector<double> normalized()const{return normalize_histogram(bins.begin(),bins.end());}
+};
 
+/**
+ * Compute the histogram of the values in data.
+ * The data is split into blocks which are binned in parallel, each thread counting into its own histogram.
+ * Data of 8 and 16 bit is binned through a lookup table.
+ * \param bins the amount of bins, 0 selects one bin per value for integer data (up to 65536 bins) and 256 bins otherwise
+ * \param range the lower bound of the first and the upper bound of the last bin, defaults to the value range of data
+ * (widened by half a bin on each side if there is one bin per value, so the bin centers are the values)
+ * \throws std::domain_error if data is not of a scalar numeric type
+ */
+Histogram histogram(const data::ValueArray &data, size_t bins=0, std::optional<std::pair<double,double>> range={});
+/// Compute the histogram of the values in data where the value in mask is not zero (mask must have the same length as data).
+Histogram histogram(const data::ValueArray &data, const data::ValueArray &mask, size_t bins=0, std::optional<std::pair<double,double>> range={});
+/// Compute the histogram of all voxels of image (without converting it to one type).
+Histogram histogram(const data::Image &image, size_t bins=0, std::optional<std::pair<double,double>> range={});
+/// Compute the histogram of all voxels of image where the voxel in mask is not zero (mask must have the same size as image).
+Histogram histogram(const data::Image &image, const data::Image &mask, size_t bins=0, std::optional<std::pair<double,double>> range={});
 
+}
@@ -0,0 +1,503 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2018  Enrico Reimer <reimer@cbs.mpg.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "morphology.hpp"
+#include <thread>
+#include <mutex>
+
+namespace isis::math
+{
+namespace
+{
+constexpr uint32_t no_voxel = std::numeric_limits<uint32_t>::max();
+
+typedef std::vector<uint8_t> Mask;
+
+bool inShape( ptrdiff_t dx, ptrdiff_t dy, ptrdiff_t dz, ptrdiff_t radius, connectivity conn )
+{
+	switch( conn ) {
+	case connectivity::faces:
+		return std::abs( dx ) + std::abs( dy ) + std::abs( dz ) <= radius;
+	case connectivity::edges:
+		return dx * dx + dy * dy + dz * dz <= 2 * radius * radius;
+	default:
+		return true;
+	}
+}
+
+void checkType( const data::Image &img )
+{
+	for( const data::Chunk &ch : img.copyChunksToVector( false ) )
+		if( !ch.visit( []( auto ptr ) {return std::is_arithmetic_v<typename decltype( ptr )::element_type>;} ) ) {
+			LOG( Runtime, error ) << "Cannot use " << img.identify( true, false ) << " as a mask, its type " << ch.typeName() << " is not supported";
+			throw std::domain_error( "Unsupported datatype" );
+		}
+}
+
+Mask toMask( const data::Image &img )
+{
+	checkType( img );
+	const std::vector<data::Chunk> chunks = img.copyChunksToVector( false );
+	const size_t chunk_volume = chunks.front().getVolume();
+	Mask ret( img.getVolume() );
+
+	util::parallelFor( chunks.size(), [&]( size_t begin, size_t end ) {
+		for( size_t c = begin; c < end; c++ )
+			chunks[c].visit( [&]( auto ptr ) {
+				if constexpr( std::is_arithmetic_v<typename decltype( ptr )::element_type> )
+					std::transform( ptr.get(), ptr.get() + chunk_volume, ret.begin() + c * chunk_volume, []( auto v ) {return v != 0;} );
+			} );
+	} );
+	return ret;
+}
+
+/// a deep copy of src converted to type with the voxels replaced by values
+template<typename V> data::Image fromValues( const data::Image &src, unsigned short type, const std::vector<V> &values )
+{
+	data::Image ret = src.copyByID( type );
+	const std::vector<data::Chunk> chunks = ret.copyChunksToVector( false );
+	const size_t chunk_volume = chunks.front().getVolume();
+
+	util::parallelFor( chunks.size(), [&]( size_t begin, size_t end ) {
+		for( size_t c = begin; c < end; c++ )
+			chunks[c].visit( [&]( auto ptr ) {
+				typedef typename decltype( ptr )::element_type value_type;
+
+				if constexpr( std::is_arithmetic_v<value_type> )
+					std::transform( values.begin() + c * chunk_volume, values.begin() + ( c + 1 ) * chunk_volume, ptr.get(), []( V v ) {return static_cast<value_type>( v );} );
+			} );
+	} );
+	return ret;
+}
+
+/// union-find on voxel indices, the root of a set is always its first voxel
+struct UnionFind {
+	std::vector<uint32_t> parent;
+	uint32_t find( uint32_t i ) {
+		while( parent[i] != i ) {
+			parent[i] = parent[parent[i]]; // path halving
+			i = parent[i];
+		}
+
+		return i;
+	}
+	uint32_t root( uint32_t i )const { // without compression, for concurrent use after all unions are done
+		while( parent[i] != i )
+			i = parent[i];
+
+		return i;
+	}
+	void unite( uint32_t a, uint32_t b ) {
+		a = find( a );
+		b = find( b );
+
+		if( a < b )
+			parent[b] = a;
+		else if( b < a )
+			parent[a] = b;
+	}
+};
+
+/**
+ * Label the nonzero voxels of mask with consecutive labels starting at 1 (0 is background).
+ * The volumes are handled as a stack of planes (the slices of all timesteps) which is split into slabs.
+ */
+std::vector<uint32_t> labelVoxels( const Mask &mask, const util::vector4<size_t> &size, connectivity conn, bool across_time )
+{
+	if( mask.size() >= no_voxel ) {
+		LOG( Runtime, error ) << "Cannot label images with more than " << no_voxel - 1 << " voxels";
+		throw std::length_error( "Image too big for labelling" );
+	}
+
+	// offsets of the neighbours which come before a voxel in memory
+	std::vector<std::array<ptrdiff_t, 4>> offsets;
+
+	for( ptrdiff_t dz = -1; dz <= 0; dz++ )
+		for( ptrdiff_t dy = -1; dy <= ( dz < 0 ? 1 : 0 ); dy++ )
+			for( ptrdiff_t dx = -1; dx <= ( dz < 0 || dy < 0 ? 1 : -1 ); dx++ )
+				if( inShape( dx, dy, dz, 1, conn ) )
+					offsets.push_back( {dx, dy, dz, 0} );
+
+	if( across_time )
+		offsets.push_back( {0, 0, 0, -1} );
+
+	const size_t planes = size[2] * size[3], plane_volume = size[0] * size[1];
+	const size_t slabs = std::min<size_t>( planes, std::max( std::thread::hardware_concurrency(), 1u ) );
+	auto slab_begin = [&]( size_t s ) {return s * planes / slabs;};
+
+	UnionFind uf{std::vector<uint32_t>( mask.size(), no_voxel )};
+
+	// connect voxel i (at pos) to its previous neighbours in planes at or above min_plane
+	auto connect = [&]( uint32_t i, const util::vector4<size_t> &pos, size_t min_plane ) {
+		for( const std::array<ptrdiff_t, 4> &o : offsets ) {
+			ptrdiff_t n[4];
+
+			for( int d = 0; d < 4; d++ )
+				n[d] = ptrdiff_t( pos[d] ) + o[d];
+
+			if( n[0] < 0 || n[0] >= ptrdiff_t( size[0] ) || n[1] < 0 || n[1] >= ptrdiff_t( size[1] ) || n[2] < 0 || n[3] < 0 )
+				continue;
+
+			const size_t plane = n[2] + size[2] * n[3];
+
+			if( plane < min_plane )
+				continue;
+
+			const size_t j = n[0] + size[0] * ( n[1] + size[1] * plane );
+
+			if( mask[j] )
+				uf.unite( i, j );
+		}
+	};
+	auto forPlane = [&]( size_t p, auto &&op ) {
+		util::vector4<size_t> pos{0, 0, p % size[2], p / size[2]};
+		uint32_t i = p * plane_volume;
+
+		for( pos[1] = 0; pos[1] < size[1]; pos[1]++ )
+			for( pos[0] = 0; pos[0] < size[0]; pos[0]++, i++ )
+				if( mask[i] )
+					op( i, pos );
+	};
+
+	// label the slabs on their own
+	util::parallelFor( slabs, [&]( size_t begin, size_t end ) {
+		for( size_t s = begin; s < end; s++ )
+			for( size_t p = slab_begin( s ); p < slab_begin( s + 1 ); p++ )
+				forPlane( p, [&]( uint32_t i, const util::vector4<size_t> &pos ) {
+					uf.parent[i] = i;
+					connect( i, pos, slab_begin( s ) );
+				} );
+	} );
+
+	// merge the slabs, only planes with neighbours in previous slabs are needed
+	for( size_t s = 1; s < slabs; s++ ) {
+		const size_t first = slab_begin( s );
+
+		for( size_t p = first; p < slab_begin( s + 1 ); p++ ) {
+			if( p > first && ( !across_time || p >= first + size[2] ) )
+				continue;
+
+			forPlane( p, [&]( uint32_t i, const util::vector4<size_t> &pos ) {connect( i, pos, 0 );} );
+		}
+	}
+
+	// number the roots in memory order, first count them per slab
+	std::vector<uint32_t> ret( mask.size(), 0 ), first_label( slabs + 1, 1 );
+
+	util::parallelFor( slabs, [&]( size_t begin, size_t end ) {
+		for( size_t s = begin; s < end; s++ ) {
+			uint32_t roots = 0;
+
+			for( size_t i = slab_begin( s ) * plane_volume; i < slab_begin( s + 1 ) * plane_volume; i++ )
+				roots += uf.parent[i] == i;
+
+			first_label[s + 1] = roots;
+		}
+	} );
+	std::partial_sum( first_label.begin(), first_label.end(), first_label.begin() );
+
+	util::parallelFor( slabs, [&]( size_t begin, size_t end ) {
+		for( size_t s = begin; s < end; s++ ) {
+			uint32_t next = first_label[s];
+
+			for( size_t i = slab_begin( s ) * plane_volume; i < slab_begin( s + 1 ) * plane_volume; i++ )
+				if( uf.parent[i] == i )
+					ret[i] = next++;
+		}
+	} );
+	util::parallelFor( mask.size(), [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; i++ )
+			if( uf.parent[i] != no_voxel && uf.parent[i] != i )
+				ret[i] = ret[uf.root( i )];
+	} );
+
+	LOG( Debug, info ) << "Found " << first_label.back() - 1 << " clusters in " << slabs << " slabs";
+	return ret;
+}
+
+struct Run {
+	uint32_t begin, end;
+};
+typedef std::vector<Run> Runs;
+
+/// a row of the structuring element with its half width
+struct SERow {
+	ptrdiff_t dy, dz, width;
+};
+
+/**
+ * Run length encoded binary morphology.
+ * The mask is encoded as runs of foreground voxels for each row, the result of a row is computed from the runs
+ * of the rows covered by the structuring element.
+ */
+class Morphology
+{
+	util::vector4<size_t> size;
+	std::vector<SERow> element;
+	std::vector<Runs> rows;
+
+	[[nodiscard]] const Runs *neighbour( size_t row, const SERow &e )const {
+		const ptrdiff_t y = row % size[1] + e.dy, z = ( row / size[1] ) % size[2] + e.dz;
+		if( y < 0 || y >= ptrdiff_t( size[1] ) || z < 0 || z >= ptrdiff_t( size[2] ) )
+			return nullptr;
+
+		return &rows[row + e.dy + e.dz * ptrdiff_t( size[1] )];
+	}
+	static Runs intersect( const Runs &a, const Runs &b ) {
+		Runs ret;
+
+		for( auto ia = a.begin(), ib = b.begin(); ia != a.end() && ib != b.end(); ) {
+			const uint32_t begin = std::max( ia->begin, ib->begin ), end = std::min( ia->end, ib->end );
+
+			if( begin < end )
+				ret.push_back( {begin, end} );
+
+			if( ia->end < ib->end )
+				++ia;
+			else
+				++ib;
+		}
+
+		return ret;
+	}
+	[[nodiscard]] Runs dilateRow( size_t row )const {
+		Runs grown;
+
+		for( const SERow &e : element )
+			if( const Runs *runs = neighbour( row, e ) )
+				for( const Run &r : *runs )
+					grown.push_back( {uint32_t( std::max<ptrdiff_t>( ptrdiff_t( r.begin ) - e.width, 0 ) ), uint32_t( std::min<size_t>( r.end + e.width, size[0] ) )} );
+
+		std::sort( grown.begin(), grown.end(), []( const Run &a, const Run &b ) {return a.begin < b.begin;} );
+		Runs ret;
+
+		for( const Run &r : grown ) {
+			if( !ret.empty() && r.begin <= ret.back().end )
+				ret.back().end = std::max( ret.back().end, r.end );
+			else
+				ret.push_back( r );
+		}
+
+		return ret;
+	}
+	[[nodiscard]] Runs erodeRow( size_t row )const {
+		Runs ret{{0, uint32_t( size[0] )}};
+
+		for( const SERow &e : element ) {
+			const Runs *runs = neighbour( row, e );
+
+			if( !runs ) // outside of the image is background
+				return {};
+
+			Runs shrunk;
+
+			for( const Run &r : *runs )
+				if( r.begin + 2 * e.width < r.end )
+					shrunk.push_back( {uint32_t( r.begin + e.width ), uint32_t( r.end - e.width )} );
+
+			ret = intersect( ret, shrunk );
+
+			if( ret.empty() )
+				break;
+		}
+
+		return ret;
+	}
+public:
+	Morphology( const util::vector4<size_t> &_size, unsigned short radius, connectivity conn ): size( _size ) {
+		// dimensions of size 1 are not covered by the structuring element
+		const ptrdiff_t r[3] = {size[0] > 1 ? radius : 0, size[1] > 1 ? radius : 0, size[2] > 1 ? radius : 0};
+
+		for( ptrdiff_t dz = -r[2]; dz <= r[2]; dz++ )
+			for( ptrdiff_t dy = -r[1]; dy <= r[1]; dy++ ) {
+				ptrdiff_t width = -1;
+
+				for( ptrdiff_t dx = 0; dx <= r[0]; dx++ )
+					if( inShape( dx, dy, dz, radius, conn ) )
+						width = dx;
+
+				if( width >= 0 )
+					element.push_back( {dy, dz, width} );
+			}
+	}
+	Mask operator()( const Mask &mask, bool erosion ) {
+		rows.resize( size[1] * size[2] * size[3] );
+
+		util::parallelFor( rows.size(), [&]( size_t begin, size_t end ) {
+			for( size_t row = begin; row < end; row++ ) {
+				const uint8_t *const voxels = mask.data() + row * size[0];
+				Runs &runs = rows[row];
+				runs.clear();
+
+				for( uint32_t x = 0; x < size[0]; ) {
+					for( ; x < size[0] && !voxels[x]; x++ );
+					const uint32_t begin = x;
+					for( ; x < size[0] && voxels[x]; x++ );
+
+					if( begin < x )
+						runs.push_back( {begin, x} );
+				}
+			}
+		} );
+
+		Mask ret( mask.size(), 0 );
+		util::parallelFor( rows.size(), [&]( size_t begin, size_t end ) {
+			for( size_t row = begin; row < end; row++ )
+				for( const Run &r : erosion ? erodeRow( row ) : dilateRow( row ) )
+					std::fill( ret.begin() + row * size[0] + r.begin, ret.begin() + row * size[0] + r.end, 1 );
+		} );
+		return ret;
+	}
+};
+
+data::Image morph( const data::Image &mask, unsigned short radius, connectivity conn, std::initializer_list<bool> erosions )
+{
+	Mask voxels = toMask( mask );
+	Morphology op( mask.getSizeAsVector(), radius, conn );
+
+	for( bool erosion : erosions )
+		voxels = op( voxels, erosion );
+
+	return fromValues( mask, mask.getMajorTypeID(), voxels );
+}
+}
+
+data::TypedImage<uint32_t> label( const data::Image &mask, connectivity conn, bool across_time )
+{
+	const std::vector<uint32_t> labels = labelVoxels( toMask( mask ), mask.getSizeAsVector(), conn, across_time );
+	return data::TypedImage<uint32_t>( fromValues( mask, util::typeID<uint32_t>(), labels ) );
+}
+
+std::vector<Cluster> clusterStats( const data::TypedImage<uint32_t> &labels )
+{
+	struct Accumulator {
+		size_t voxels = 0;
+		util::dvector4 sum{0, 0, 0, 0};
+	};
+	const util::vector4<size_t> size = labels.getSizeAsVector();
+	const std::vector<data::Chunk> chunks = labels.copyChunksToVector( false );
+	const size_t chunk_volume = chunks.front().getVolume();
+	std::vector<Accumulator> total;
+	std::mutex total_lock;
+
+	util::parallelFor( chunks.size(), [&]( size_t begin, size_t end ) {
+		std::vector<Accumulator> acc;
+
+		for( size_t c = begin; c < end; c++ ) {
+			const uint32_t *const voxels = std::static_pointer_cast<const uint32_t>( chunks[c].getRawAddress() ).get();
+
+			for( size_t i = 0; i < chunk_volume; i++ ) {
+				if( !voxels[i] )
+					continue;
+
+				if( voxels[i] > acc.size() )
+					acc.resize( voxels[i] );
+
+				Accumulator &a = acc[voxels[i] - 1];
+				const std::array<size_t, 4> pos = labels.getCoordsFromLinIndex( c * chunk_volume + i );
+				a.voxels++;
+
+				for( int d = 0; d < 4; d++ )
+					a.sum[d] += pos[d];
+			}
+		}
+
+		const std::lock_guard<std::mutex> guard( total_lock );
+
+		if( acc.size() > total.size() )
+			total.resize( acc.size() );
+
+		for( size_t l = 0; l < acc.size(); l++ ) {
+			total[l].voxels += acc[l].voxels;
+			total[l].sum += acc[l].sum;
+		}
+	} );
+
+	// the geometry of the image for the physical centroid
+	const data::Chunk first = labels.getChunk( 0, 0, 0, 0 );
+	const util::fvector3 origin = first.getValueAsOr( "indexOrigin", util::fvector3{0, 0, 0} );
+	const util::fvector3 voxel_size = first.getValueAsOr( "voxelSize", util::fvector3{1, 1, 1} ) + first.getValueAsOr( "voxelGap", util::fvector3{0, 0, 0} );
+	const util::fvector3 axes[3] = {
+		first.getValueAsOr( "rowVec", util::fvector3{1, 0, 0} ),
+		first.getValueAsOr( "columnVec", util::fvector3{0, 1, 0} ),
+		first.getValueAsOr( "sliceVec", util::fvector3{0, 0, 1} )
+	};
+	LOG_IF( size[data::timeDim] > 1 && total.size(), Debug, verbose_info ) << "Computing the centroids of " << total.size() << " clusters of " << size;
+
+	std::vector<Cluster> ret( total.size() );
+
+	for( size_t l = 0; l < total.size(); l++ ) {
+		Cluster &cl = ret[l];
+		cl.label = l + 1;
+		cl.voxels = total[l].voxels;
+		cl.centroid = cl.voxels ? total[l].sum / double( cl.voxels ) : util::dvector4{0, 0, 0, 0};
+		cl.physical_centroid = origin;
+
+		for( int d = 0; d < 3; d++ )
+			cl.physical_centroid += axes[d] * float( cl.centroid[d] * voxel_size[d] );
+	}
+
+	return ret;
+}
+
+data::Image dilate( const data::Image &mask, unsigned short radius, connectivity conn )
+{
+	return morph( mask, radius, conn, {false} );
+}
+data::Image erode( const data::Image &mask, unsigned short radius, connectivity conn )
+{
+	return morph( mask, radius, conn, {true} );
+}
+data::Image open( const data::Image &mask, unsigned short radius, connectivity conn )
+{
+	return morph( mask, radius, conn, {true, false} );
+}
+data::Image close( const data::Image &mask, unsigned short radius, connectivity conn )
+{
+	return morph( mask, radius, conn, {false, true} );
+}
+
+data::Image fillHoles( const data::Image &mask, connectivity conn )
+{
+	const util::vector4<size_t> size = mask.getSizeAsVector();
+	Mask voxels = toMask( mask ), background( voxels.size() );
+	std::transform( voxels.begin(), voxels.end(), background.begin(), []( uint8_t v ) {return !v;} );
+
+	const std::vector<uint32_t> labels = labelVoxels( background, size, conn, false );
+	const uint32_t count = labels.empty() ? 0 : *std::max_element( labels.begin(), labels.end() );
+	std::vector<bool> outside( count + 1, false ); // background clusters touching the border (ignoring dimensions of size 1)
+
+	for( size_t i = 0; i < labels.size(); i++ ) {
+		if( !labels[i] )
+			continue;
+
+		const std::array<size_t, 4> pos = mask.getCoordsFromLinIndex( i );
+
+		for( int d = 0; d < 3; d++ )
+			if( size[d] > 1 && ( pos[d] == 0 || pos[d] == size[d] - 1 ) )
+				outside[labels[i]] = true;
+	}
+
+	for( size_t i = 0; i < labels.size(); i++ )
+		if( labels[i] && !outside[labels[i]] )
+			voxels[i] = 1;
+
+	return fromValues( mask, mask.getMajorTypeID(), voxels );
+}
+}
@@ -0,0 +1,85 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2018  Enrico Reimer <reimer@cbs.mpg.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "../core/image.hpp"
+#include "common.hpp"
+
+namespace isis::math
+{
+/**
+ * The neighbourhood of a voxel.
+ * For structuring elements with a radius r this becomes
+ * - faces: all offsets with |dx|+|dy|+|dz| <= r
+ * - edges: all offsets with dx²+dy²+dz² <= 2r²
+ * - corners: all offsets with max(|dx|,|dy|,|dz|) <= r
+ */
+enum class connectivity {faces = 6, edges = 18, corners = 26};
+
+struct Cluster {
+	uint32_t label;
+	size_t voxels;
+	util::dvector4 centroid; ///< the mean voxel index of the cluster
+	util::fvector3 physical_centroid; ///< the centroid in scanner space (mm)
+};
+
+/**
+ * Label the connected components of the nonzero voxels of an image.
+ * The image is split into slabs of slices which are labelled in parallel using a union-find on the voxel indices.
+ * The labels of neighbouring slabs are merged afterwards.
+ * \param mask the image to be labelled (of any scalar type), all voxels which are not 0 are foreground
+ * \param conn the neighbourhood within a volume
+ * \param across_time also connect voxels to the same voxel in the next volume (otherwise each volume is labelled on its own)
+ * \returns an image with the geometry of mask containing 0 for the background
+ * and the labels 1 to n for the clusters (numbered by the order of their first voxel in memory)
+ * \throws std::domain_error if the type of mask is not scalar
+ */
+data::TypedImage<uint32_t> label( const data::Image &mask, connectivity conn = connectivity::corners, bool across_time = false );
+
+/**
+ * Compute size and centroid of the clusters of a label image.
+ * \returns a table with one entry for each label from 1 to the highest label in labels (so entry i is label i+1)
+ */
+std::vector<Cluster> clusterStats( const data::TypedImage<uint32_t> &labels );
+
+/**
+ * Binary morphology.
+ * The nonzero voxels of mask are foreground. The rows of the mask are run-length encoded, so the cost depends on
+ * the number of runs rather than on the number of voxels. Voxels outside of the image are background.
+ * Dimensions of size 1 are ignored by the structuring element (so 2D images are handled as such), and each volume
+ * of a 4D image is processed on its own.
+ * The result is a new image of the type of mask containing 0 and 1.
+ * \param radius the radius of the structuring element in voxels
+ * \param conn the shape of the structuring element
+ * \throws std::domain_error if the type of mask is not scalar
+ */
+data::Image dilate( const data::Image &mask, unsigned short radius = 1, connectivity conn = connectivity::faces );
+/// \copydoc dilate
+data::Image erode( const data::Image &mask, unsigned short radius = 1, connectivity conn = connectivity::faces );
+/// erode and then dilate (see dilate)
+data::Image open( const data::Image &mask, unsigned short radius = 1, connectivity conn = connectivity::faces );
+/// dilate and then erode (see dilate)
+data::Image close( const data::Image &mask, unsigned short radius = 1, connectivity conn = connectivity::faces );
+/**
+ * Set all background voxels to 1 which are not connected to the border of the image (per volume).
+ * \param conn the connectivity of the background
+ */
+data::Image fillHoles( const data::Image &mask, connectivity conn = connectivity::faces );
+}
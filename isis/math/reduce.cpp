@@ -0,0 +1,190 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2018  Enrico Reimer <reimer@cbs.mpg.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "reduce.hpp"
+
+namespace isis::math
+{
+namespace
+{
+constexpr size_t tile_size = 4096; // voxels accumulated at once (the accumulators stay in the L1 cache)
+constexpr size_t gather_size = 1024 * 1024; // values collected at most per job for percentiles
+
+/// The voxels of an image as seen from the reduced dimension: index = inner_idx + inner * (k + length * outer_idx)
+struct Layout {
+	size_t inner, length, outer;
+	const std::vector<data::Chunk> &chunks;
+	size_t chunk_volume;
+
+	/// call op(ptr,pos,count) for the pieces of the voxels [pos,pos+count) at k and outer_idx that are contiguous in a chunk
+	template<typename OP> void forPieces( size_t outer_idx, size_t k, size_t begin, size_t count, OP &&op )const {
+		size_t start = begin + inner * ( k + length * outer_idx );
+
+		for( size_t pos = 0; pos < count; ) {
+			const size_t c = start / chunk_volume, offset = start - c * chunk_volume;
+			const size_t n = std::min( count - pos, chunk_volume - offset );
+			chunks[c].visit( [&]( auto ptr ) {
+				typedef typename decltype( ptr )::element_type value_type;
+
+				if constexpr( std::is_arithmetic_v<value_type> )
+					op( ptr.get() + offset, pos, n );
+			} );
+			pos += n;
+			start += n;
+		}
+	}
+};
+
+void accumulate( const Layout &layout, reduction stat, size_t outer_idx, size_t begin, size_t count, float *out )
+{
+	std::vector<double> a( count ), b( count ); // sum, min, max or mean and sum of squared deviations
+
+	if( stat == reduction::min )
+		std::fill( a.begin(), a.end(), std::numeric_limits<double>::infinity() );
+	else if( stat == reduction::max )
+		std::fill( a.begin(), a.end(), -std::numeric_limits<double>::infinity() );
+
+	for( size_t k = 0; k < layout.length; k++ ) {
+		const double inv_n = 1. / ( k + 1 );
+		layout.forPieces( outer_idx, k, begin, count, [&]( const auto *x, size_t pos, size_t n ) {
+			double *__restrict acc = a.data() + pos, *__restrict sq = b.data() + pos;
+
+			switch( stat ) {
+			case reduction::sum:
+				for( size_t i = 0; i < n; i++ )
+					acc[i] += x[i];
+				break;
+			case reduction::min:
+				for( size_t i = 0; i < n; i++ )
+					acc[i] = std::min<double>( acc[i], x[i] );
+				break;
+			case reduction::max:
+				for( size_t i = 0; i < n; i++ )
+					acc[i] = std::max<double>( acc[i], x[i] );
+				break;
+			default: // Welford's update with the same n for all voxels
+				for( size_t i = 0; i < n; i++ ) {
+					const double delta = x[i] - acc[i];
+					acc[i] += delta * inv_n;
+					sq[i] += delta * ( x[i] - acc[i] );
+				}
+			}
+		} );
+	}
+
+	for( size_t i = 0; i < count; i++ ) {
+		const double variance = b[i] / layout.length;
+
+		switch( stat ) {
+		case reduction::variance:
+			out[i] = variance;
+			break;
+		case reduction::stddev:
+			out[i] = std::sqrt( variance );
+			break;
+		case reduction::tsnr:
+			out[i] = variance > 0 ? a[i] / std::sqrt( variance ) : 0;
+			break;
+		default:
+			out[i] = a[i];
+		}
+	}
+}
+
+void gather( const Layout &layout, double percentile, size_t outer_idx, size_t begin, size_t count, float *out )
+{
+	std::vector<double> values( count * layout.length ); // the values of each voxel are consecutive
+
+	for( size_t k = 0; k < layout.length; k++ )
+		layout.forPieces( outer_idx, k, begin, count, [&]( const auto *x, size_t pos, size_t n ) {
+			for( size_t i = 0; i < n; i++ )
+				values[( pos + i ) * layout.length + k] = x[i];
+		} );
+
+	const double rank = percentile / 100 * ( layout.length - 1 );
+	const size_t lower = std::floor( rank );
+	const double fraction = rank - lower;
+
+	for( size_t i = 0; i < count; i++ ) {
+		const auto first = values.begin() + i * layout.length, last = first + layout.length;
+		std::nth_element( first, first + lower, last );
+		double result = first[lower];
+
+		if( fraction > 0 ) // the next rank is the smallest of the values above
+			result += ( *std::min_element( first + lower + 1, last ) - result ) * fraction;
+
+		out[i] = result;
+	}
+}
+}
+
+data::Image reduce( const data::Image &src, data::dimensions dim, reduction stat, double percentile )
+{
+	const std::vector<data::Chunk> chunks = src.copyChunksToVector( false );
+
+	for( const data::Chunk &ch : chunks ) {
+		if( !ch.visit( []( auto ptr ) {return std::is_arithmetic_v<typename decltype( ptr )::element_type>;} ) ) {
+			LOG( Runtime, error ) << "Cannot compute statistics of " << src.identify( true, false ) << ", its type " << ch.typeName() << " is not supported";
+			throw std::domain_error( "Unsupported datatype" );
+		}
+	}
+
+	if( stat == reduction::median )
+		percentile = 50;
+
+	LOG_IF( stat == reduction::percentile && ( percentile < 0 || percentile > 100 ), Runtime, error ) << "Invalid percentile " << percentile << ", clamping it to [0,100]";
+	percentile = std::clamp( percentile, 0., 100. );
+
+	const util::vector4<size_t> size = src.getSizeAsVector();
+	Layout layout{1, size[dim], 1, chunks, chunks.front().getVolume()};
+
+	for( int d = 0; d < dim; d++ )
+		layout.inner *= size[d];
+
+	for( int d = dim + 1; d < 4; d++ )
+		layout.outer *= size[d];
+
+	util::vector4<size_t> dst_size = size;
+	dst_size[dim] = 1;
+	data::MemChunk<float> dst( dst_size[0], dst_size[1], dst_size[2], dst_size[3] );
+	float *const out = dst.beginTyped<float>();
+
+	const bool gathering = stat == reduction::median || stat == reduction::percentile;
+	const size_t tile = gathering ? std::clamp<size_t>( gather_size / layout.length, 1, tile_size ) : tile_size;
+	const size_t tiles = ( layout.inner + tile - 1 ) / tile;
+
+	LOG( Debug, info ) << "Reducing " << size << " along " << dim << " in " << tiles * layout.outer << " tiles of " << tile << " voxels";
+	util::parallelFor( tiles * layout.outer, [&]( size_t begin, size_t end ) {
+		for( size_t job = begin; job < end; job++ ) {
+			const size_t outer_idx = job / tiles, first = ( job % tiles ) * tile, count = std::min( tile, layout.inner - first );
+			float *const dst_ptr = out + outer_idx * layout.inner + first;
+
+			if( gathering )
+				gather( layout, percentile, outer_idx, first, count, dst_ptr );
+			else
+				accumulate( layout, stat, outer_idx, first, count, dst_ptr );
+		}
+	} );
+
+	static_cast<util::PropertyMap &>( dst ) = src;
+	if( !dst.hasProperty( "acquisitionNumber" ) )
+		dst.setValueAs( "acquisitionNumber", uint32_t( 1 ) );
+	return data::Image( dst );
+}
+}
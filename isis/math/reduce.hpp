@@ -0,0 +1,45 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2018  Enrico Reimer <reimer@cbs.mpg.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "../core/image.hpp"
+#include "common.hpp"
+
+namespace isis::math
+{
+enum class reduction {sum, mean, variance, stddev, min, max, median, percentile, tsnr};
+
+/**
+ * Compute a statistic of the voxels of an image along one of its dimensions.
+ * E.g. the standard deviation along data::timeDim gives the temporal standard deviation of each voxel.
+ * The image is traversed in tiles of voxels which are contiguous in memory, and the tiles are processed in parallel.
+ * The moments are accumulated with Welford's algorithm in double precision.
+ * - variance and stddev are the population statistics (divided by the number of values)
+ * - tsnr is mean / stddev (0 where stddev is 0)
+ * - percentile interpolates linearly between the closest ranks, median is the 50th percentile
+ * \param src the image to be reduced (of any scalar type)
+ * \param dim the dimension along which the statistic is computed
+ * \param stat the statistic to compute
+ * \param percentile the percentile (between 0 and 100) to compute for reduction::percentile
+ * \returns a float image with the metadata of src and the size of src, except for dim which is 1
+ * \throws std::domain_error if the type of src is not scalar
+ */
+data::Image reduce( const data::Image &src, data::dimensions dim, reduction stat, double percentile = 50 );
+}
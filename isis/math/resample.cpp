@@ -0,0 +1,431 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2016  Enrico Reimer <reimer@cbs.mpg.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "resample.hpp"
+
+namespace isis::math
+{
+namespace _internal
+{
+namespace
+{
+constexpr unsigned short kernelWidth( interpolation method )
+{
+	switch( method ) {
+	case interpolation::nearest:
+		return 1;
+	case interpolation::linear:
+		return 2;
+	case interpolation::bspline:
+		return 4;
+	case interpolation::sinc:
+		return 6;
+	}
+	return 1;
+}
+constexpr unsigned short max_kernel_width = 6;
+
+/**
+ * Compute the source indices and weights for sampling at position c of an axis with n voxels.
+ * Taps beyond the border are clamped (or mirrored for bspline, as that's what the prefilter assumes).
+ * \returns false if c is outside of the axis (more than half a voxel away from its first/last voxel)
+ */
+template<typename W> bool computeTaps( interpolation method, double c, size_t n, size_t *idx, W *w )
+{
+	if( c < -.5 || c > n - .5 )
+		return false;
+
+	const auto border = [n, method]( ptrdiff_t i ) -> size_t {
+		if( method == interpolation::bspline ) {
+			if( n < 2 )
+				return 0;
+			const ptrdiff_t period = 2 * ( n - 1 );
+			i = std::abs( i ) % period;
+			return i < ptrdiff_t( n ) ? i : period - i;
+		}
+		return std::clamp<ptrdiff_t>( i, 0, n - 1 );
+	};
+	const double first = std::floor( c );
+
+	switch( method ) {
+	case interpolation::nearest:
+		idx[0] = border( std::lround( c ) );
+		w[0] = 1;
+		break;
+	case interpolation::linear:
+		idx[0] = border( first );
+		idx[1] = border( first + 1 );
+		w[1] = c - first;
+		w[0] = 1 - w[1];
+		break;
+	case interpolation::bspline:
+		for( int k = 0; k < 4; k++ ) {
+			const double x = std::abs( c - ( first + k - 1 ) );
+			idx[k] = border( first + k - 1 );
+			w[k] = x < 1 ? 2. / 3 - x * x + x * x * x / 2 : std::pow( 2 - x, 3 ) / 6;
+		}
+		break;
+	case interpolation::sinc: { // Lanczos windowed sinc with a radius of 3
+		W sum = 0;
+		for( int k = 0; k < 6; k++ ) {
+			const double x = c - ( first + k - 2 );
+			idx[k] = border( first + k - 2 );
+			w[k] = std::abs( x ) < 1e-6 ? 1 : 3 * std::sin( M_PI * x ) * std::sin( M_PI * x / 3 ) / ( M_PI * M_PI * x * x );
+			sum += w[k];
+		}
+		for( int k = 0; k < 6; k++ )
+			w[k] /= sum;
+	}
+	break;
+	}
+	return true;
+}
+
+/**
+ * Replace the samples along dim by cubic B-spline coefficients (mirrored borders).
+ * The recursive filter runs on whole blocks of the lower dimensions at once, so the inner loops are contiguous.
+ */
+template<typename W> void bsplinePrefilter( W *data, const std::array<size_t, 4> &size, unsigned short dim )
+{
+	const size_t n = size[dim];
+	if( n < 2 )
+		return;
+
+	const W z = std::sqrt( 3. ) - 2, lambda = ( 1 - z ) * ( 1 - 1 / z );
+	const size_t horizon = std::min<size_t>( n, 16 ); // z^16 < 1e-9
+	size_t stride = 1, outer = 1;
+	for( unsigned short d = 0; d < dim; d++ )stride *= size[d];
+	for( unsigned short d = dim + 1; d < 4; d++ )outer *= size[d];
+
+	util::parallelFor( outer, [=]( size_t begin, size_t end ) {
+		std::vector<W> init( stride );
+		for( size_t o = begin; o < end; o++ ) {
+			const auto line = [=]( size_t j ) {return data + ( o * n + j ) * stride;};
+
+			for( size_t j = 0; j < n; j++ ) {
+				W *l = line( j );
+				for( size_t i = 0; i < stride; i++ )l[i] *= lambda;
+			}
+
+			// causal filter
+			std::fill( init.begin(), init.end(), 0 );
+			W zk = 1;
+			for( size_t k = 0; k < horizon; k++, zk *= z ) {
+				const W *l = line( k );
+				for( size_t i = 0; i < stride; i++ )init[i] += zk * l[i];
+			}
+			std::copy( init.begin(), init.end(), line( 0 ) );
+			for( size_t j = 1; j < n; j++ ) {
+				W *l = line( j );
+				const W *p = line( j - 1 );
+				for( size_t i = 0; i < stride; i++ )l[i] += z * p[i];
+			}
+
+			// anti-causal filter
+			{
+				W *l = line( n - 1 );
+				const W *p = line( n - 2 );
+				for( size_t i = 0; i < stride; i++ )l[i] = z / ( z * z - 1 ) * ( l[i] + z * p[i] );
+			}
+			for( size_t j = n - 1; j-- > 0; ) {
+				W *l = line( j );
+				const W *p = line( j + 1 );
+				for( size_t i = 0; i < stride; i++ )l[i] = z * ( p[i] - l[i] );
+			}
+		}
+	} );
+}
+
+/**
+ * Resample the data along dim to newlen samples at the positions scale*j+offset.
+ * For all dimensions but the first the taps are applied to whole contiguous blocks of the lower dimensions.
+ */
+template<typename W> std::vector<W> separablePass(
+	const std::vector<W> &in, const std::array<size_t, 4> &size, unsigned short dim, double scale, double offset, size_t newlen, interpolation method
+)
+{
+	const unsigned short width = kernelWidth( method );
+	std::vector<size_t> idx( newlen * width, 0 );
+	std::vector<W> weights( newlen * width, 0 );
+
+	for( size_t j = 0; j < newlen; j++ )
+		computeTaps<W>( method, scale * j + offset, size[dim], &idx[j * width], &weights[j * width] );
+
+	size_t stride = 1, outer = 1;
+	for( unsigned short d = 0; d < dim; d++ )stride *= size[d];
+	for( unsigned short d = dim + 1; d < 4; d++ )outer *= size[d];
+
+	std::vector<W> out( stride * newlen * outer );
+	util::parallelFor( outer * newlen, [&]( size_t begin, size_t end ) {
+		for( size_t job = begin; job < end; job++ ) {
+			const size_t o = job / newlen, j = job % newlen;
+			W *dst = out.data() + job * stride;
+			const W *src = in.data() + o * size[dim] * stride;
+			std::fill( dst, dst + stride, 0 );
+
+			for( unsigned short k = 0; k < width; k++ ) {
+				const W w = weights[j * width + k];
+				if( w == 0 )
+					continue;
+				const W *s = src + idx[j * width + k] * stride;
+				for( size_t i = 0; i < stride; i++ )
+					dst[i] += w * s[i];
+			}
+		}
+	} );
+	return out;
+}
+
+template<typename W> struct VolumeView {
+	const W *data;
+	std::array<size_t, 4> size;
+	W operator()( size_t x, size_t y, size_t z, size_t t )const {
+		return data[x + size[0] * ( y + size[1] * ( z + size[2] * t ) )];
+	}
+};
+
+/// sample src at the positions given by the (not axis aligned) mapping, parallel over the slices and timesteps of the output
+template<typename W, typename T, typename SRC, typename CONV> void sampleAffine(
+	const SRC &src, const std::array<size_t, 4> &in_size, const IndexMapping &mapping, interpolation method, T *dst, const CONV &convert
+)
+{
+	const unsigned short width = kernelWidth( method );
+	const auto &size = mapping.size;
+	const auto &m = mapping.matrix;
+
+	util::parallelFor( size[2] * size[3], [&]( size_t begin, size_t end ) {
+		std::array<std::array<size_t, max_kernel_width>, 3> idx;
+		std::array<std::array<W, max_kernel_width>, 3> w;
+
+		for( size_t job = begin; job < end; job++ ) {
+			const size_t z = job % size[2], t = job / size[2];
+			T *out = dst + job * size[0] * size[1];
+
+			for( size_t y = 0; y < size[1]; y++ ) {
+				for( size_t x = 0; x < size[0]; x++, out++ ) {
+					bool inside = true;
+					for( int d = 0; d < 3 && inside; d++ ) {
+						const double c = m[d][0] * x + m[d][1] * y + m[d][2] * z + mapping.offset[d];
+						inside = computeTaps<W>( method, c, in_size[d], idx[d].data(), w[d].data() );
+					}
+					if( !inside ) {
+						*out = convert( 0 );
+						continue;
+					}
+
+					W sum = 0;
+					for( unsigned short k = 0; k < width; k++ )
+						for( unsigned short j = 0; j < width; j++ ) {
+							const W wjk = w[2][k] * w[1][j];
+							for( unsigned short i = 0; i < width; i++ )
+								sum += wjk * w[0][i] * src( idx[0][i], idx[1][j], idx[2][k], t );
+						}
+					*out = convert( sum );
+				}
+			}
+		}
+	} );
+}
+
+template<typename T> data::Chunk reslice_impl( const data::Image &image, const IndexMapping &mapping, interpolation method )
+{
+	// type used for the computation, float can't hold all values of 32/64bit integers
+	typedef std::conditional_t<std::is_same_v<T, double> || ( std::is_integral_v<T> && sizeof( T ) >= 4 ), double, float> W;
+	const auto convert = []( W v ) -> T {
+		if constexpr( std::is_integral_v<T> )
+			return static_cast<T>( std::clamp<double>( std::round( v ), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max() ) );
+		else
+			return static_cast<T>( v );
+	};
+
+	const data::TypedImage<T> src( image );
+	const std::array<size_t, 4> in_size = src.getSizeAsVector();
+	const auto &size = mapping.size;
+	data::MemChunk<T> dst( size[0], size[1], size[2], size[3] );
+	T *out = &dst.template voxel<T>( 0 );
+
+	std::vector<W> buffer;
+	if( mapping.isAxisAligned() || method == interpolation::bspline ) {
+		buffer.resize( src.getVolume() );
+		image.copyToMem<W>( buffer.data(), buffer.size() );
+	}
+
+	if( mapping.isAxisAligned() ) {
+		std::array<size_t, 4> bsize = in_size;
+		for( unsigned short d = 0; d < 4; d++ ) {
+			const double scale = d < 3 ? mapping.matrix[d][d] : mapping.time_scale, offset = d < 3 ? mapping.offset[d] : 0;
+			if( scale == 1 && offset == 0 && bsize[d] == size[d] )
+				continue; // nothing to do in this dimension
+			if( method == interpolation::bspline )
+				bsplinePrefilter( buffer.data(), bsize, d );
+			buffer = separablePass( buffer, bsize, d, scale, offset, size[d], method );
+			bsize[d] = size[d];
+		}
+		util::parallelFor( buffer.size(), [&]( size_t begin, size_t end ) {
+			std::transform( buffer.begin() + begin, buffer.begin() + end, out + begin, convert );
+		} );
+	} else {
+		LOG_IF( mapping.time_scale != 1 || in_size[3] != size[3], Debug, error ) << "Non axis aligned resampling cannot change the number of timesteps";
+
+		if( method == interpolation::bspline ) {
+			for( unsigned short d = 0; d < 3; d++ )
+				bsplinePrefilter( buffer.data(), in_size, d );
+			sampleAffine<W>( VolumeView<W>{buffer.data(), in_size}, in_size, mapping, method, out, convert );
+		} else {
+			const auto access = src.getAccessor();
+			const auto view = [&access]( size_t x, size_t y, size_t z, size_t t ) -> W {return access( x, y, z, t );};
+			sampleAffine<W>( view, in_size, mapping, method, out, convert );
+		}
+	}
+
+	static_cast<util::PropertyMap &>( dst ) = image;
+	if( !dst.hasProperty( "acquisitionNumber" ) )
+		dst.setValueAs( "acquisitionNumber", uint32_t( 1 ) );
+	return dst;
+}
+
+util::dvector3 getSpacing( const data::Image &img )
+{
+	util::dvector3 ret = img.getValueAs<util::dvector3>( "voxelSize" );
+	if( img.hasProperty( "voxelGap" ) )
+		ret += img.getValueAs<util::dvector3>( "voxelGap" );
+	return ret;
+}
+}
+
+bool IndexMapping::isAxisAligned()const
+{
+	for( int r = 0; r < 3; r++ )
+		for( int c = 0; c < 3; c++ )
+			if( r != c && matrix[r][c] != 0 )
+				return false;
+	return true;
+}
+
+std::optional<data::Chunk> reslice( const data::Image &src, const IndexMapping &mapping, interpolation method )
+{
+	switch( src.getMajorTypeID() ) {
+	case util::typeID<int8_t>():
+		return reslice_impl<int8_t>( src, mapping, method );
+	case util::typeID<uint8_t>():
+		return reslice_impl<uint8_t>( src, mapping, method );
+	case util::typeID<int16_t>():
+		return reslice_impl<int16_t>( src, mapping, method );
+	case util::typeID<uint16_t>():
+		return reslice_impl<uint16_t>( src, mapping, method );
+	case util::typeID<int32_t>():
+		return reslice_impl<int32_t>( src, mapping, method );
+	case util::typeID<uint32_t>():
+		return reslice_impl<uint32_t>( src, mapping, method );
+	case util::typeID<float>():
+		return reslice_impl<float>( src, mapping, method );
+	case util::typeID<double>():
+		return reslice_impl<double>( src, mapping, method );
+	default:
+		LOG( Runtime, error ) << "Cannot resample " << src.identify( true, false ) << ", its type " << src.getMajorTypeName() << " is not supported";
+		return {};
+	}
+}
+}
+
+data::Image resample( const data::Image &src, util::vector4<size_t> newsize, interpolation method )
+{
+	const util::vector4<size_t> oldsize = src.getSizeAsVector();
+	_internal::IndexMapping mapping;
+	mapping.size = newsize;
+	for( int i = 0; i < 3; i++ )
+		mapping.matrix[i][i] = double( oldsize[i] ) / newsize[i];
+	mapping.time_scale = double( oldsize[3] ) / newsize[3];
+
+	std::optional<data::Chunk> resliced = _internal::reslice( src, mapping, method );
+	if( !resliced )
+		return src;
+	data::Chunk &ret = *resliced;
+
+	util::fvector3 &voxelSize = ret.refValueAs<util::fvector3>( "voxelSize" );
+	for( int i = 0; i < 3; i++ )
+		voxelSize[i] *= mapping.matrix[i][i];
+	if( ret.hasProperty( "voxelGap" ) ) {
+		util::fvector3 &voxelGap = ret.refValueAs<util::fvector3>( "voxelGap" );
+		for( int i = 0; i < 3; i++ )
+			voxelGap[i] *= mapping.matrix[i][i];
+	}
+	if( mapping.time_scale != 1 && ret.hasProperty( "repetitionTime" ) )
+		ret.setValueAs( "repetitionTime", ret.getValueAs<double>( "repetitionTime" ) * mapping.time_scale );
+
+	LOG( Runtime, info ) << "resampled image to " << newsize << " voxels, new voxelsize is " << voxelSize;
+	return data::Image( ret );
+}
+
+data::Image rotate( const data::Image &src, std::pair<int, int> rotation_plane, float angle, bool pix_center, interpolation method )
+{
+	const util::vector4<size_t> size = src.getSizeAsVector();
+	const util::dvector3 spacing = _internal::getSpacing( src );
+
+	// the rotation happens in image space, so get the origin in image space
+	std::array<double, 3> origin;
+	if( pix_center ) {
+		for( int i = 0; i < 3; i++ )
+			origin[i] = ( 1 - double( size[i] ) ) * spacing[i] / 2;
+	} else {
+		const util::Matrix3x3<double> inverse_orientation{ // rows are the image axes
+			src.getValueAs<util::dvector3>( "rowVec" ),
+			src.getValueAs<util::dvector3>( "columnVec" ),
+			src.getValueAs<util::dvector3>( "sliceVec" )
+		};
+		origin = inverse_orientation * std::array<double, 3>( src.getValueAs<util::dvector3>( "indexOrigin" ) );
+	}
+
+	// maps the physical position of a voxel in the result onto the position it's sampled from
+	auto rotation = util::identityMatrix<double, 3>();
+	rotation[rotation_plane.first][rotation_plane.first] = std::cos( angle );
+	rotation[rotation_plane.first][rotation_plane.second] = std::sin( angle );
+	rotation[rotation_plane.second][rotation_plane.first] = -std::sin( angle );
+	rotation[rotation_plane.second][rotation_plane.second] = std::cos( angle );
+
+	// source_index = S^-1 * (R * (origin + S*index) - origin)
+	_internal::IndexMapping mapping;
+	mapping.size = size;
+	const auto rotated_origin = rotation * origin;
+	for( int r = 0; r < 3; r++ ) {
+		for( int c = 0; c < 3; c++ )
+			mapping.matrix[r][c] = rotation[r][c] * spacing[c] / spacing[r];
+		mapping.offset[r] = ( rotated_origin[r] - origin[r] ) / spacing[r];
+	}
+
+	LOG( Runtime, info )
+		<< "rotating image by " << util::MSubject( std::to_string( angle ) + "rad" ) << " on the "
+		<< char( 'x' + rotation_plane.first ) << "/" << char( 'x' + rotation_plane.second ) << " plane around the " << ( pix_center ? "image center" : "scanner isocenter" );
+	const std::optional<data::Chunk> ret = _internal::reslice( src, mapping, method );
+	return ret ? data::Image( *ret ) : src;
+}
+
+data::Image translate( const data::Image &src, util::fvector3 translation, interpolation method )
+{
+	const util::dvector3 spacing = _internal::getSpacing( src );
+	_internal::IndexMapping mapping;
+	mapping.size = src.getSizeAsVector();
+	for( int i = 0; i < 3; i++ )
+		mapping.offset[i] = translation[i] / spacing[i];
+
+	LOG( Runtime, info ) << "translating image by " << translation;
+	const std::optional<data::Chunk> ret = _internal::reslice( src, mapping, method );
+	return ret ? data::Image( *ret ) : src;
+}
+}
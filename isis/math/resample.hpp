@@ -0,0 +1,84 @@
+/*
+ * <one line to give the program's name and a brief idea of what it does.>
+ * Copyright (C) 2016  Enrico Reimer <reimer@cbs.mpg.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "../core/image.hpp"
+#include "../core/matrix.hpp"
+#include "common.hpp"
+
+namespace isis::math
+{
+enum class interpolation {nearest, linear, bspline, sinc};
+
+API_EXCLUDE_BEGIN;
+/// @cond _internal
+namespace _internal
+{
+/**
+ * Maps the voxel index of the output onto a (continuous) voxel index in the source.
+ * source_index = matrix * output_index + offset (for the spatial dimensions)
+ * source_timestep = time_scale * output_timestep
+ */
+struct IndexMapping {
+	util::Matrix3x3<double> matrix = util::identityMatrix<double, 3>();
+	std::array<double, 3> offset{};
+	double time_scale = 1;
+	util::vector4<size_t> size; // size of the output
+	[[nodiscard]] bool isAxisAligned()const;
+};
+/**
+ * Resample the voxels of src according to the mapping.
+ * \returns a chunk with the type and the metadata of src, or nothing if the type of src is not supported
+ */
+std::optional<data::Chunk> reslice( const data::Image &src, const IndexMapping &mapping, interpolation method );
+}
+/// @endcond _internal
+API_EXCLUDE_END;
+
+/**
+ * Resample an image to a new size while keeping its field of view.
+ * The first voxel of the result stays at the position of the first voxel of the source,
+ * the voxelSize (and repetitionTime if the number of timesteps changes) are scaled accordingly.
+ * Axis aligned resampling is done in separate passes for each dimension.
+ * \param src the image to be resampled
+ * \param newsize the amount of voxels the result shall have
+ * \param method the interpolation to use
+ * \returns a new image of the same type as src (or src itself if its type is not supported)
+ */
+data::Image resample( const data::Image &src, util::vector4<size_t> newsize, interpolation method = interpolation::linear );
+
+/**
+ * Rotate the voxel data of an image within a plane of its image space.
+ * The content is rotated by angle from the first axis of rotation_plane towards the second.
+ * The geometry of the image is not changed.
+ * \param rotation_plane the axes (0 for x to 2 for z) spanning the plane of rotation
+ * \param angle the angle in rad
+ * \param pix_center rotate around the center of the image instead of around the scanner isocenter
+ */
+data::Image rotate( const data::Image &src, std::pair<int, int> rotation_plane, float angle, bool pix_center = false, interpolation method = interpolation::linear );
+
+/**
+ * Translate the sampling grid of an image along its image axes.
+ * The voxel at x of the result is sampled from x+translation in the source (so the content moves by -translation).
+ * The geometry of the image is not changed.
+ * \param translation the translation in mm along the row, column and slice direction
+ */
+data::Image translate( const data::Image &src, util::fvector3 translation, interpolation method = interpolation::linear );
+}
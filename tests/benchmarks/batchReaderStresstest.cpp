@@ -0,0 +1,80 @@
+#include <isis/core/batch_reader.hpp>
+#include <isis/core/fileptr.hpp>
+#include <chrono>
+#include <fstream>
+#include <numeric>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace isis;
+
+// a directory full of small files, like a DICOM series with one slice per file
+const size_t files = 2000, file_size = 256 * 1024;
+
+// drop the files from the page cache, so the next access has to go to the disk
+void evict( const std::vector<std::filesystem::path> &paths )
+{
+	for( const std::filesystem::path &file : paths ) {
+		const int fd = open( file.c_str(), O_RDONLY );
+		posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED );
+		close( fd );
+	}
+}
+
+// sum up the file, so all of it has to be there
+uint64_t touch( const data::ByteArray &data )
+{
+	const uint64_t *const start = reinterpret_cast<const uint64_t *>( data.getRawAddress().get() );
+	return std::accumulate( start, start + data.getLength() / sizeof( uint64_t ), uint64_t( 0 ) );
+}
+template<typename OP> void measure( const std::string &what, const std::vector<std::filesystem::path> &paths, OP op )
+{
+	evict( paths );
+	const auto start = std::chrono::steady_clock::now();
+	const uint64_t sum = op();
+	const std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+	std::cout << "\t" << what << " in " << took.count() << " seconds (" << paths.size() / took.count() << " files/s, checksum " << sum << ")" << std::endl;
+}
+
+void run( const std::filesystem::path &dir )
+{
+	std::filesystem::create_directories( dir );
+	std::vector<std::filesystem::path> paths;
+	std::vector<uint64_t> block( file_size / sizeof( uint64_t ) );
+
+	for( size_t i = 0; i < files; i++ ) {
+		paths.push_back( dir / ( std::to_string( i ) + ".raw" ) );
+		std::iota( block.begin(), block.end(), i );
+		std::ofstream( paths.back(), std::ios::binary ).write( reinterpret_cast<const char *>( block.data() ), file_size );
+	}
+
+	std::cout << "Reading " << files << " files of " << file_size / 1024 << "KB from " << dir << std::endl;
+	measure( "FilePtr one after another", paths, [&]() {
+		uint64_t sum = 0;
+		for( const std::filesystem::path &file : paths )
+			sum += touch( data::FilePtr( file ) );
+		return sum;
+	} );
+
+	for( size_t depth : {8, 64} ) {
+		auto batched = [&]( data::BatchReader::backend use ) {
+			uint64_t sum = 0;
+			data::BatchReader::read( paths, [&]( const std::filesystem::path &, data::ByteArray &&data ) {sum += touch( data );}, SIZE_MAX, depth, use );
+			return sum;
+		};
+		measure( "BatchReader using threads, " + std::to_string( depth ) + " files in flight", paths, [&]() {return batched( data::BatchReader::threads );} );
+		if( data::BatchReader::hasUring() )
+			measure( "BatchReader using io_uring, " + std::to_string( depth ) + " files in flight", paths, [&]() {return batched( data::BatchReader::uring );} );
+	}
+
+	std::filesystem::remove_all( dir );
+}
+
+int main( int argc, char *argv[] )
+{
+	// local disk (or wherever the temp dir is) and tmpfs
+	run( argc > 1 ? std::filesystem::path( argv[1] ) : std::filesystem::temp_directory_path() / "isis_batch_reader_test" );
+	if( std::filesystem::is_directory( "/dev/shm" ) )
+		run( "/dev/shm/isis_batch_reader_test" );
+	return 0;
+}
@@ -2,22 +2,47 @@
 #include <isis/core/valuearray.hpp>
 #include <boost/timer.hpp>
 #include <isis/core/valuearray_typed.hpp>
+#include <isis/core/bytearray.hpp>
 
 using namespace isis;
 
+// run op a few times (so all memory is already mapped) and report the best time
+template<typename OP> void report( const std::string &what, size_t bytes, OP op )
+{
+	double best = std::numeric_limits<double>::max();
+
+	for( int run = 0; run < 3; run++ ) {
+		boost::timer timer;
+		op();
+		best = std::min( best, timer.elapsed() );
+	}
+
+	std::cout << "\t" << what << " in " << best << " seconds (" << bytes / best / ( 1024 * 1024 * 1024 ) << " GB/s)" << std::endl;
+}
+
 template<typename T> void testEndianSwap( size_t size )
 {
 	const data::TypedArray<T> source( size );
 	data::TypedArray<T> target( size );
+	std::cout << "byteswapping " << size << " elements " << util::typeName<T>() << std::endl;
 
-	boost::timer timer;
-	data::endianSwapArray( source.begin(), source.end(), target.begin() );
+	// the iterators of TypedArray are no pointers, so this takes the element wise path
+	report( "scalar", size * sizeof( T ), [&] {data::endianSwapArray( source.begin(), source.end(), target.begin() );} );
+	report( "vectorised", size * sizeof( T ), [&] {
+		data::endianSwapArray( source.template beginTyped<T>(), source.template beginTyped<T>() + size, target.template beginTyped<T>() );
+	} );
+	report( "in place", size * sizeof( T ), [&] {target.endianSwap();} );
+}
 
-	std::cout
-			<< "byteswapped " << size << " elements " << util::typeName<T>()
-			<< " in " << timer.elapsed() << " seconds " << std::endl;
+template<typename T> void testSwapConvert( size_t size )
+{
+	data::ByteArray source( size * sizeof( T ) );
+	std::cout << "byteswapping and converting " << size << " elements " << util::typeName<T>() << " to float" << std::endl;
 
+	report( "swap, then convert", size * sizeof( T ), [&] {data::TypedArray<float>( source.at<T>( 0, size, true ) );} );
+	report( "fused", size * sizeof( T ), [&] {source.convertAt<float>( util::typeID<T>(), 0, size, true );} );
 }
+
 int main()
 {
 	testEndianSwap<uint8_t>( 1024 * 1024 * 1024 / sizeof( uint8_t ) );
@@ -26,5 +51,9 @@ int main()
 	testEndianSwap<float>( 1024 * 1024 * 1024 / sizeof( float ) );
 	testEndianSwap<double>( 1024 * 1024 * 1024 / sizeof( double ) );
 	testEndianSwap<util::color48>( 1024 * 1024 * 1024 / sizeof( util::color48 ) );
+	testEndianSwap<std::complex<float>>( 1024 * 1024 * 1024 / sizeof( std::complex<float> ) );
+
+	testSwapConvert<int16_t>( 1024 * 1024 * 1024 / sizeof( int16_t ) );
+	testSwapConvert<int32_t>( 1024 * 1024 * 1024 / sizeof( int32_t ) );
 	return 0;
 }
@@ -0,0 +1,78 @@
+#include "../../io_plugins/dicom/imageFormat_Dicom.hpp"
+#include <openjpeg.h>
+#include <chrono>
+#include <thread>
+
+using namespace isis;
+
+// a multi-frame j2k dicom (e.g. a CT series or an angiography run)
+const uint32_t width = 512, height = 512, frames = 64;
+
+// encode a frame of 12bit noise on a gradient losslessly as j2k codestream
+data::ValueArray encodeJ2k( uint32_t frame )
+{
+	opj_image_cmptparm_t param{};
+	param.dx = param.dy = 1;
+	param.w = width;
+	param.h = height;
+	param.prec = 12;
+	opj_image_t *image = opj_image_create( 1, &param, OPJ_CLRSPC_GRAY );
+	image->x1 = width;
+	image->y1 = height;
+
+	for( uint32_t i = 0; i < width * height; i++ )
+		image->comps[0].data[i] = ( i % width + i / width + frame * 16 + ( i * 2654435761u >> 28 ) ) % 4096;
+
+	opj_cparameters_t parameters;
+	opj_set_default_encoder_parameters( &parameters );
+	opj_codec_t *codec = opj_create_compress( OPJ_CODEC_J2K );
+	opj_setup_encoder( codec, &parameters, image );
+
+	std::vector<uint8_t> out;
+	opj_stream_t *stream = opj_stream_create( OPJ_J2K_STREAM_CHUNK_SIZE, false );
+	opj_stream_set_user_data( stream, &out, nullptr );
+	opj_stream_set_write_function( stream, []( void *buffer, OPJ_SIZE_T bytes, void *data ) -> OPJ_SIZE_T {
+		std::vector<uint8_t> &dst = *static_cast<std::vector<uint8_t> *>( data );
+		dst.insert( dst.end(), static_cast<uint8_t *>( buffer ), static_cast<uint8_t *>( buffer ) + bytes );
+		return bytes;
+	} );
+
+	if( !( opj_start_compress( codec, image, stream ) && opj_encode( codec, stream ) && opj_end_compress( codec, stream ) ) )
+		std::cerr << "Failed to encode frame " << frame << std::endl;
+
+	opj_stream_destroy( stream );
+	opj_destroy_codec( codec );
+	opj_image_destroy( image );
+
+	data::ValueArray ret = data::ValueArray::make<uint8_t>( out.size() );
+	std::copy( out.begin(), out.end(), ret.beginTyped<uint8_t>() );
+	return ret;
+}
+
+template<typename OP> void measure( const std::string &what, OP op )
+{
+	const auto start = std::chrono::steady_clock::now();
+	op();
+	const std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+	std::cout << "\t" << what << " in " << took.count() << " seconds (" << frames / took.count() << " frames/s)" << std::endl;
+}
+
+int main()
+{
+	std::list<data::ValueArray> items;
+	size_t bytes = 0;
+
+	for( uint32_t f = 0; f < frames; f++ ) {
+		items.push_back( encodeJ2k( f ) );
+		bytes += items.back().getLength();
+	}
+
+	std::cout << "Decoding " << frames << " j2k frames of " << width << "x" << height << " (" << bytes / 1024 << "KB) using " << std::thread::hardware_concurrency() << " threads" << std::endl;
+
+	measure( "frame by frame (openjpeg threads only)", [&]() {
+		for( const data::ValueArray &item : items )
+			image_io::_internal::getj2k( {item} );
+	} );
+	measure( "all frames at once (frames in parallel)", [&]() {image_io::_internal::getj2k( items );} );
+	return 0;
+}
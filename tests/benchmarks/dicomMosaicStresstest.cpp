@@ -0,0 +1,70 @@
+#include "../../io_plugins/dicom/imageFormat_Dicom.hpp"
+#include <chrono>
+#include <numeric>
+
+using namespace isis;
+
+// a multiband fMRI run: one 8x8 mosaic of 104x104 slices per volume
+const size_t tile = 104, images = 64, matrix = 8, volumes = 300;
+
+data::Chunk makeMosaic( size_t frames )
+{
+	data::MemChunk<int16_t> ret( tile * matrix, tile * matrix, frames );
+	std::iota( ret.beginTyped<int16_t>(), ret.beginTyped<int16_t>() + ret.getVolume(), 0 );
+	ret.setValueAs( "DICOM/ImageType", util::slist{"ORIGINAL", "PRIMARY", "M", "MOSAIC"} );
+	ret.setValueAs( "DICOM/SiemensNumberOfImagesInMosaic", uint16_t( images ) );
+	ret.setValueAs( "DICOM/SIEMENS CSA HEADER/MosaicRefAcqTimes", util::dlist( images, 12.5 ) );
+	ret.setValueAs( "acquisitionTime", util::timestamp( std::chrono::hours( 10 ) ) );
+	ret.setValueAs( "voxelSize", util::fvector3( {2, 2, 2} ) );
+	ret.setValueAs( "rowVec", util::fvector3( {1, 0, 0} ) );
+	ret.setValueAs( "columnVec", util::fvector3( {0, 1, 0} ) );
+	ret.setValueAs( "indexOrigin", util::fvector3( {-100, -100, 10} ) );
+	return ret;
+}
+
+// how the mosaic was decomposed before: line by line through Chunk::copyRange and a copy of all properties
+data::Chunk lineByLine( const data::Chunk &source )
+{
+	const util::vector4<size_t> tSize = source.getSizeAsVector();
+	data::Chunk dest = source.cloneToNew( tile, tile, images );
+	static_cast<util::PropertyMap &>( dest ) = static_cast<const util::PropertyMap &>( source );
+
+	for ( size_t slice = 0; slice < images; slice++ ) {
+		for ( size_t line = 0; line < tile; line++ ) {
+			const std::array<size_t, 4> sstart{slice % matrix * tile, slice / matrix * tile + line, 0, 0};
+			source.copyRange( sstart, {sstart[0] + tile - 1, sstart[1], 0, 0}, dest, {0, line, slice, 0} );
+		}
+	}
+
+	return dest;
+}
+
+template<typename OP> void measure( const std::string &what, OP op )
+{
+	const auto start = std::chrono::steady_clock::now();
+	op();
+	const std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+	std::cout << "\t" << what << " in " << took.count() << " seconds (" << volumes / took.count() << " volumes/s)" << std::endl;
+}
+
+int main()
+{
+	std::cout << "Decomposing " << volumes << " mosaics of " << images << " slices of " << tile << "x" << tile << std::endl;
+	std::vector<data::Chunk> mosaics;
+
+	for( size_t v = 0; v < volumes; v++ )
+		mosaics.push_back( makeMosaic( 1 ) );
+
+	measure( "line by line (as before)", [&]() {
+		for( const data::Chunk &m : mosaics )
+			lineByLine( m );
+	} );
+	measure( "readMosaic, one file per volume", [&]() {
+		for( const data::Chunk &m : mosaics )
+			image_io::ImageFormat_Dicom::readMosaic( m );
+	} );
+
+	const data::Chunk frames = makeMosaic( volumes );
+	measure( "readMosaic, all volumes as frames of one file", [&]() {image_io::ImageFormat_Dicom::readMosaic( frames );} );
+	return 0;
+}
@@ -0,0 +1,101 @@
+#include <isis/core/fileptr.hpp>
+#include <isis/core/tmpfile.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace isis;
+
+const size_t file_size = size_t( 1024 ) * 1024 * 1024, tile_size = 256 * 1024;
+
+// drop the file from the page cache, so the next access has to go to the disk
+void evict( const std::filesystem::path &file )
+{
+	const int fd = open( file.c_str(), O_RDONLY );
+	posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED );
+	close( fd );
+}
+
+// sum up a range, so all of its pages have to be there (wall clock time, as most of it is waiting for the disk)
+uint64_t touch( const data::ByteArray &data, size_t offset, size_t length )
+{
+	const uint64_t *const start = reinterpret_cast<const uint64_t *>( static_cast<const uint8_t *>( data.getRawAddress().get() ) + offset );
+	return std::accumulate( start, start + length / sizeof( uint64_t ), uint64_t( 0 ) );
+}
+template<typename OP> void measure( const std::string &what, const std::filesystem::path &file, OP op )
+{
+	evict( file );
+	data::FilePtr mapped( file );
+	const auto start = std::chrono::steady_clock::now();
+	const uint64_t sum = op( mapped );
+	const std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+	std::cout << "\t" << what << " in " << took.count() << " seconds (" << file_size / took.count() / ( 1024 * 1024 ) << " MB/s, checksum " << sum << ")" << std::endl;
+}
+
+int main()
+{
+	util::TmpFile file( ".raw" );
+	{
+		std::ofstream out( file, std::ios::binary );
+		std::vector<uint64_t> block( tile_size / sizeof( uint64_t ) );
+
+		for( size_t written = 0; written < file_size; written += tile_size ) {
+			std::iota( block.begin(), block.end(), written );
+			out.write( reinterpret_cast<const char *>( block.data() ), tile_size );
+		}
+	}
+
+	// whole volume loads (like NIfTI), front to back
+	std::cout << "Reading " << file_size / ( 1024 * 1024 ) << "MB front to back from a cold cache" << std::endl;
+	measure( "without hints", file, []( const data::FilePtr &f ) {return touch( f, 0, file_size );} );
+	measure( "sequential", file, []( const data::FilePtr &f ) {
+		f.advise( data::ByteArray::Access::sequential );
+		return touch( f, 0, file_size );
+	} );
+	measure( "willneed", file, []( const data::FilePtr &f ) {
+		f.prefetch();
+		return touch( f, 0, file_size );
+	} );
+	measure( "sequential and willneed", file, []( const data::FilePtr &f ) {
+		f.advise( data::ByteArray::Access::sequential );
+		f.prefetch();
+		return touch( f, 0, file_size );
+	} );
+
+	// tiled files (like TIFF or ZISRAW), where the tiles are needed in a different order than they are stored
+	std::vector<size_t> tiles( file_size / tile_size );
+	std::iota( tiles.begin(), tiles.end(), 0 );
+	std::shuffle( tiles.begin(), tiles.end(), std::mt19937( 42 ) );
+
+	std::cout << "Reading " << tiles.size() << " tiles of " << tile_size / 1024 << "KB in random order from a cold cache" << std::endl;
+	auto read_tiles = [&]( const data::FilePtr &f, size_t ahead ) {
+		uint64_t sum = 0;
+
+		for( size_t i = 0; i < ahead && i < tiles.size(); i++ )
+			f.prefetch( tiles[i] * tile_size, tile_size );
+
+		for( size_t i = 0; i < tiles.size(); i++ ) {
+			if( ahead && i + ahead < tiles.size() ) // ask for the tile we'll need a few tiles from now
+				f.prefetch( tiles[i + ahead] * tile_size, tile_size );
+
+			sum += touch( f, tiles[i] * tile_size, tile_size );
+		}
+
+		return sum;
+	};
+	measure( "without hints", file, [&]( const data::FilePtr &f ) {return read_tiles( f, 0 );} );
+	measure( "random", file, [&]( const data::FilePtr &f ) {
+		f.advise( data::ByteArray::Access::random );
+		return read_tiles( f, 0 );
+	} );
+	measure( "prefetching 8 tiles ahead", file, [&]( const data::FilePtr &f ) {return read_tiles( f, 8 );} );
+	measure( "random and prefetching 8 tiles ahead", file, [&]( const data::FilePtr &f ) {
+		f.advise( data::ByteArray::Access::random );
+		return read_tiles( f, 8 );
+	} );
+	return 0;
+}
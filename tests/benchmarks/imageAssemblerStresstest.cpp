@@ -0,0 +1,76 @@
+#include <isis/core/io_factory.hpp>
+#include <isis/core/image_assembler.hpp>
+#include <boost/timer.hpp>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace isis;
+
+// a synthetic series as it would come from a directory of DICOM files: one slice per file, series after series
+const size_t series = 20, volumes = 20, slices = 32, size = 128;
+
+data::Chunk makeSlice( size_t s, size_t v, size_t z )
+{
+	data::MemChunk<int16_t> ch( size, size );
+	ch.setValueAs( "indexOrigin", util::fvector3( {0, 0, float( z )} ) );
+	ch.setValueAs( "acquisitionNumber", uint32_t( v * slices + z ) );
+	ch.setValueAs( "rowVec", util::fvector3( {1, 0} ) );
+	ch.setValueAs( "columnVec", util::fvector3( {0, 1} ) );
+	ch.setValueAs( "voxelSize", util::fvector3( {1, 1, 1} ) );
+	ch.setValueAs( "sequenceNumber", uint16_t( s ) );
+	return ch;
+}
+template<typename OP> void forSlices( OP op )
+{
+	for( size_t s = 0; s < series; s++ )
+		for( size_t v = 0; v < volumes; v++ )
+			for( size_t z = 0; z < slices; z++ )
+				op( makeSlice( s, v, z ) );
+}
+
+// run op in its own process so its peak memory can be measured separately
+template<typename OP> void measure( const std::string &what, OP op )
+{
+	if( fork() == 0 ) {
+		boost::timer timer;
+		double first = -1;
+		size_t images = 0;
+		op( [&]( data::Image &&image ) { // "use" and drop the images
+			if( first < 0 )
+				first = timer.elapsed();
+			images++;
+		} );
+
+		rusage usage;
+		getrusage( RUSAGE_SELF, &usage );
+		std::cout << what << ": " << images << " images, first after " << first << "s, all after " << timer.elapsed() << "s, peak RSS " << usage.ru_maxrss / 1024 << "MB" << std::endl;
+		_exit( 0 );
+	}
+
+	wait( nullptr );
+}
+
+int main()
+{
+	std::cout << "Assembling " << series << " series of " << volumes << " volumes with " << slices << " slices of " << size << "x" << size << std::endl;
+
+	measure( "chunk list", []( const data::ImageAssembler::image_sink &sink ) {
+		std::list<data::Chunk> chunks;
+		forSlices( [&]( data::Chunk &&ch ) {chunks.push_back( ch );} );
+
+		for( data::Image &image : data::IOFactory::chunkListToImageList( chunks ) )
+			sink( std::move( image ) );
+	} );
+	measure( "streamed", []( const data::ImageAssembler::image_sink &sink ) {
+		data::ImageAssembler assembler( sink );
+		forSlices( [&]( data::Chunk &&ch ) {assembler.push( ch );} );
+		assembler.flush();
+	} );
+	measure( "streamed, emitting early", []( const data::ImageAssembler::image_sink &sink ) {
+		data::ImageAssembler assembler( sink, 1 );
+		forSlices( [&]( data::Chunk &&ch ) {assembler.push( ch );} );
+		assembler.flush();
+	} );
+	return 0;
+}
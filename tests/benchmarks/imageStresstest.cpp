@@ -43,5 +43,18 @@ int main()
 				}
 
 	std::cout << tsteps *slices *slice_size *slice_size << " voxel set to 42 in " << timer.elapsed() << " sec" << std::endl;
+
+	data::TypedImage<short> typed( img );
+	timer.restart();
+	const auto access = typed.getAccessor();
+
+	for ( size_t tstep = 0; tstep < tsteps; tstep++ )
+		for ( size_t slice = 0; slice < slices; slice++ )
+			for ( size_t column = 0; column < slice_size; column++ )
+				for ( size_t row = 0; row < slice_size; row++ ) {
+					access( row, column, slice, tstep ) = 23;
+				}
+
+	std::cout << tsteps *slices *slice_size *slice_size << " voxel set to 23 through the accessor in " << timer.elapsed() << " sec" << std::endl;
 	return 0;
 }
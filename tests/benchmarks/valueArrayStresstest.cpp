@@ -16,6 +16,27 @@ template<typename T> void testMinMax( size_t size )
 			<< " in " << timer.elapsed() << " seconds " << std::endl;
 
 }
+
+// allocate, convert and free the same sizes over and over again (like reading a series of images does)
+void testChurn( size_t size, size_t repetitions )
+{
+	for( size_t limit : {0, 1024} ) {
+		data::MemoryPool::setLimit( limit * 1024 * 1024 );
+		boost::timer timer;
+
+		for( size_t i = 0; i < repetitions; i++ ) {
+			const data::TypedArray<int16_t> array( size );
+			const data::ValueArray converted = array.copyAs<float>( data::scaling_pair( 1, 0 ) );
+		}
+
+		const data::MemoryPool::Stats stats = data::MemoryPool::getStats();
+		std::cout
+				<< "allocated and converted " << repetitions << " times " << size * sizeof( int16_t ) / 1024 << "KB of int16_t "
+				<< ( limit ? "with" : "without" ) << " pooling in " << timer.elapsed() << " seconds "
+				<< "(" << stats.reused << " reused, " << stats.fresh << " fresh allocations so far)" << std::endl;
+	}
+}
+
 int main()
 {
 	data::enableLog<util::DefaultMsgPrint>( verbose_info ); //set to "verbose_info" to see which alg is used
@@ -30,5 +51,9 @@ int main()
 
 	testMinMax< float>( 1024 * 1024 * 512 );
 	testMinMax<double>( 1024 * 1024 * 512 );
+
+	testChurn( 128 * 1024, 2000 );
+	testChurn( 64 * 64 * 32, 2000 );
+	testChurn( 1024 * 1024 * 32, 50 );
 	return 0;
 }
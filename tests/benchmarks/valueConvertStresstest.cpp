@@ -0,0 +1,50 @@
+#include <isis/core/value.hpp>
+#include <boost/timer.hpp>
+#include <iomanip>
+
+using namespace isis;
+
+// property strings as they are found in DICOM and Vista headers
+const std::vector<std::string> numbers{"0.9765625", "128", "-12.5", " 3000", "2.2e-3", "1.0000001", "64", "0"};
+const std::vector<std::string> dates{"20010925", "19700101", "2021-03-14", "25.09.2001"};
+const std::vector<std::string> times{"150918.123456", "083000", "12:00:00", "20010925150918.000000", "25.09.2001 15:09:18"};
+
+// the stream based parsing as it was done before
+util::timestamp streamParse( const std::string &src, const char *format )
+{
+	std::tm t = {0, 0, 0, 1, 0, 70, 0, 0, -1, 0, nullptr};
+	std::istringstream ss( src );
+	ss >> std::get_time( &t, format );
+	return std::chrono::time_point_cast<util::duration>( std::chrono::system_clock::from_time_t( mktime( &t ) ) );
+}
+
+template<typename OP> void report( const std::string &what, size_t count, OP op )
+{
+	boost::timer timer;
+
+	for( size_t i = 0; i < count; i++ )
+		op( i );
+
+	std::cout << what << ": " << count / timer.elapsed() / 1e6 << " million conversions per second" << std::endl;
+}
+
+int main()
+{
+	const size_t count = 1000000;
+	double dsum = 0;
+	int64_t isum = 0;
+	util::timestamp::rep tsum = 0;
+
+	report( "string to double", count, [&]( size_t i ) {dsum += util::Value( numbers[i % numbers.size()] ).as<double>();} );
+	report( "string to int32", count, [&]( size_t i ) {isum += util::Value( numbers[i % numbers.size()] ).as<int32_t>();} );
+	report( "std::stod (reference)", count, [&]( size_t i ) {dsum += std::stod( numbers[i % numbers.size()] );} );
+	report( "double to string", count, [&]( size_t i ) {isum += util::Value( i * 0.1 ).as<std::string>().size();} );
+	report( "int32 to string", count, [&]( size_t i ) {isum += util::Value( int32_t( i ) ).as<std::string>().size();} );
+	report( "string to date", count, [&]( size_t i ) {tsum += util::Value( dates[i % dates.size()] ).as<util::date>().time_since_epoch().count();} );
+	report( "string to timestamp", count, [&]( size_t i ) {tsum += util::Value( times[i % times.size()] ).as<util::timestamp>().time_since_epoch().count();} );
+	report( "parseTimestamp", count, [&]( size_t i ) {tsum += util::parseTimestamp( "20010925150918" )->time_since_epoch().count();} );
+	report( "get_time+mktime (reference)", count, [&]( size_t i ) {tsum += streamParse( "20010925150918", "%Y%m%d%H%M%S" ).time_since_epoch().count();} );
+
+	std::cout << "(checksums " << dsum << " " << isum << " " << tsum << ")" << std::endl;
+	return 0;
+}
@@ -0,0 +1,90 @@
+#define BOOST_TEST_MODULE BitArrayTest
+#define NOMINMAX 1
+#include <boost/test/unit_test.hpp>
+#include <isis/core/bitarray.hpp>
+
+namespace isis::test
+{
+BOOST_AUTO_TEST_CASE ( bitarray_pack_test )
+{
+	data::TypedArray<int16_t> values( 1003 );
+	for( size_t i = 0; i < values.getLength(); i++ )
+		values[i] = i % 3 ? 0 : -int16_t( i );
+
+	const data::BitArray bits( values );
+	BOOST_REQUIRE_EQUAL( bits.getLength(), 1003 );
+	BOOST_CHECK_EQUAL( bits.bytes().getLength(), 126 );
+	BOOST_CHECK_EQUAL( bits.count(), 334 ); // 0 is not set
+
+	// bits are stored msb first
+	BOOST_CHECK_EQUAL( bits.bytes()[0], 0b00010010 );
+
+	for( size_t i = 0; i < values.getLength(); i++ )
+		BOOST_REQUIRE_EQUAL( bits[i], values[i] != 0 );
+
+	// unpack into all kinds of types
+	const data::TypedArray<float> floats = bits.unpack<float>();
+	const data::TypedArray<bool> bools = bits.unpack<bool>();
+	const data::ValueArray bytes = bits.unpack( util::typeID<uint8_t>() );
+
+	for( size_t i = 0; i < values.getLength(); i++ ) {
+		BOOST_REQUIRE_EQUAL( floats[i], values[i] ? 1 : 0 );
+		BOOST_REQUIRE_EQUAL( bools[i], values[i] != 0 );
+		BOOST_REQUIRE_EQUAL( bytes.beginTyped<uint8_t>()[i], values[i] ? 1 : 0 );
+	}
+
+	BOOST_CHECK_THROW( data::BitArray( data::TypedArray<std::complex<float>>( 8 ) ), std::domain_error );
+}
+
+BOOST_AUTO_TEST_CASE ( bitarray_ops_test )
+{
+	// big enough to be processed in parallel
+	const size_t length = 20 * 1024 * 1024 + 5;
+	data::BitArray a( length ), b( length );
+
+	for( size_t i = 0; i < length; i += 2 )
+		a[i] = true;
+	for( size_t i = 0; i < length; i += 3 )
+		b[i] = true;
+
+	BOOST_CHECK_EQUAL( a.count(), length / 2 + 1 );
+	BOOST_CHECK_EQUAL( ( a & b ).count(), length / 6 + 1 );
+	BOOST_CHECK_EQUAL( ( a | b ).count(), length / 2 + 1 + length / 3 + 1 - ( length / 6 + 1 ) );
+	BOOST_CHECK_EQUAL( ( a ^ b ).count(), ( a | b ).count() - ( a & b ).count() );
+	BOOST_CHECK_EQUAL( ( ~a ).count(), length - a.count() ); // the padding bits are not counted
+	BOOST_CHECK( ~~a == a );
+	BOOST_CHECK( !( a == b ) );
+
+	// copies share memory
+	data::BitArray shared = a, deep = a.copy();
+	shared[1] = true;
+	BOOST_CHECK( a[1] );
+	BOOST_CHECK( !deep[1] );
+
+	BOOST_CHECK_THROW( a &= data::BitArray( 5 ), std::invalid_argument );
+	BOOST_CHECK( data::BitArray( 9 ).none() );
+}
+
+BOOST_AUTO_TEST_CASE ( bitarray_iterator_test )
+{
+	data::BitArray bits( 21 );
+	std::fill( bits.begin() + 3, bits.begin() + 10, true );
+	BOOST_CHECK_EQUAL( bits.count(), 7 );
+	BOOST_CHECK_EQUAL( std::count( bits.begin(), bits.end(), true ), 7 );
+	BOOST_CHECK_EQUAL( std::find( bits.begin(), bits.end(), true ) - bits.begin(), 3 );
+
+	const data::BitArray &cbits = bits;
+	BOOST_CHECK_EQUAL( std::distance( cbits.begin(), cbits.end() ), 21 );
+	BOOST_CHECK_EQUAL( *( cbits.begin() + 9 ), true );
+	BOOST_CHECK_EQUAL( cbits.begin()[10], false );
+
+	// wrap existing bytes without copying
+	data::TypedArray<uint8_t> raw( 2 );
+	raw[0] = 0x81;
+	raw[1] = 0xFF;
+	data::BitArray wrapped( raw, 10 );
+	BOOST_CHECK_EQUAL( wrapped.count(), 4 );
+	wrapped[1] = true;
+	BOOST_CHECK_EQUAL( raw[0], 0xC1 );
+}
+}
@@ -8,6 +8,9 @@
 #define BOOST_TEST_MODULE byteswapTest
 #include <boost/test/unit_test.hpp>
 #include <isis/core/endianess.hpp>
+#include <isis/core/bytearray.hpp>
+#include <bit>
+#include <random>
 
 namespace isis
 {
@@ -29,5 +32,110 @@ BOOST_AUTO_TEST_CASE ( byteswap_test )//Copy chunks
 	BOOST_CHECK_EQUAL( data::endianSwap( fone ), finv );
 	BOOST_CHECK_EQUAL( data::endianSwap( done ), dinv );
 }
+
+// reference swap of a single scalar
+template<typename T> T byteswap( T value )
+{
+#ifdef __cpp_lib_byteswap
+	return std::byteswap( value );
+#else
+	std::reverse( reinterpret_cast<uint8_t *>( &value ), reinterpret_cast<uint8_t *>( &value ) + sizeof( T ) );
+	return value;
+#endif
+}
+
+// swap arrays of all lengths up to 200 (plus a big one) of type T made of UNIT and compare with the reference
+template<typename T, typename UNIT> void checkArraySwap()
+{
+	constexpr size_t units = sizeof( T ) / sizeof( UNIT );
+	std::mt19937_64 gen( 42 );
+
+	for( size_t len : {0, 1, 2, 3, 5, 7, 8, 15, 16, 17, 31, 33, 63, 64, 65, 100, 199, 200, 10007} ) {
+		std::vector<UNIT> raw( len * units ), expected( len * units );
+
+		for( size_t i = 0; i < raw.size(); i++ ) {
+			raw[i] = UNIT( gen() );
+			expected[i] = byteswap( raw[i] );
+		}
+
+		std::vector<UNIT> target( raw.size() );
+		const T *const begin = reinterpret_cast<const T *>( raw.data() );
+		data::endianSwapArray( begin, begin + len, reinterpret_cast<T *>( target.data() ) );
+		BOOST_REQUIRE( target == expected );
+
+		// in place
+		data::endianSwapArray( reinterpret_cast<T *>( raw.data() ), reinterpret_cast<T *>( raw.data() ) + len, reinterpret_cast<T *>( raw.data() ) );
+		BOOST_REQUIRE( raw == expected );
+	}
+}
+
+BOOST_AUTO_TEST_CASE ( byteswap_array_test )
+{
+	checkArraySwap<uint16_t, uint16_t>();
+	checkArraySwap<int32_t, int32_t>();
+	checkArraySwap<uint64_t, uint64_t>();
+	checkArraySwap<util::color48, uint16_t>();
+	checkArraySwap<std::complex<float>, uint32_t>();
+	checkArraySwap<std::complex<double>, uint64_t>();
+	checkArraySwap<util::fvector3, uint32_t>();
+	checkArraySwap<util::dvector4, uint64_t>();
+
+	// unaligned data
+	std::vector<uint8_t> bytes( 8 * 101 + 1 );
+	std::iota( bytes.begin(), bytes.end(), 0 );
+	std::vector<uint64_t> swapped( 101 );
+	data::endianSwapArray( reinterpret_cast<const uint64_t *>( bytes.data() + 1 ), reinterpret_cast<const uint64_t *>( bytes.data() + 1 ) + 101, swapped.data() );
+
+	for( size_t i = 0; i < swapped.size(); i++ ) {
+		uint64_t value;
+		memcpy( &value, bytes.data() + 1 + i * 8, 8 );
+		BOOST_REQUIRE_EQUAL( swapped[i], byteswap( value ) );
+	}
+
+	// single values of compound types
+	const std::complex<float> c( 1.5, 2 );
+	BOOST_CHECK_EQUAL( data::endianSwap( data::endianSwap( c ) ), c );
+	BOOST_CHECK_EQUAL( data::endianSwap( util::fvector3{1, 2, 3} )[1], byteswap( 2.f ) );
+}
+
+BOOST_AUTO_TEST_CASE ( bytearray_swap_convert_test )
+{
+	data::ByteArray bytes( 1000 * sizeof( int16_t ) + 1 );
+	int16_t *const values = reinterpret_cast<int16_t *>( bytes.beginTyped<uint8_t>() + 1 ); // also test unaligned access
+
+	for( int16_t i = 0; i < 1000; i++ )
+		values[i] = byteswap<int16_t>( i * 67 - 30000 );
+
+	const data::TypedArray<int16_t> swapped = bytes.at<int16_t>( 1, 1000, true );
+	const data::TypedArray<float> converted = bytes.convertAt<float>( util::typeID<int16_t>(), 1, 0, true, data::scaling_pair( 0.5, 10 ) );
+	const data::TypedArray<uint8_t> clamped = bytes.convertAt<uint8_t>( util::typeID<int16_t>(), 1, 1000, true );
+	BOOST_REQUIRE_EQUAL( converted.getLength(), 1000 );
+
+	for( int16_t i = 0; i < 1000; i++ ) {
+		const int16_t value = i * 67 - 30000;
+		BOOST_REQUIRE_EQUAL( swapped[i], value );
+		BOOST_REQUIRE_EQUAL( converted[i], value * 0.5f + 10 );
+		BOOST_REQUIRE_EQUAL( clamped[i], std::clamp<int16_t>( value, 0, 255 ) );
+	}
+
+	// vectors read with swapping
+	data::ByteArray vec_bytes( 3 * sizeof( float ) );
+	const float *const floats = reinterpret_cast<const float *>( vec_bytes.beginTyped<uint8_t>() );
+	vec_bytes.beginTyped<uint8_t>()[0] = 0x3f; // 1.0f in big endian
+	vec_bytes.beginTyped<uint8_t>()[1] = 0x80;
+	BOOST_CHECK_EQUAL( vec_bytes.at<util::fvector3>( 0, 1, true )[0], ( util::fvector3{1, 0, 0} ) );
+	BOOST_CHECK_EQUAL( floats[0], byteswap( 1.f ) );
+
+	// NaN becomes 0 when converted into integers
+	data::ByteArray nan_bytes( 2 * sizeof( float ) );
+	float *const nan_floats = reinterpret_cast<float *>( nan_bytes.beginTyped<uint8_t>() );
+	nan_floats[0] = std::numeric_limits<float>::quiet_NaN();
+	nan_floats[1] = 1e10;
+	const data::TypedArray<int32_t> from_nan = nan_bytes.convertAt<int32_t>( util::typeID<float>(), 0 );
+	BOOST_CHECK_EQUAL( from_nan[0], 0 );
+	BOOST_CHECK_EQUAL( from_nan[1], std::numeric_limits<int32_t>::max() );
+
+	BOOST_CHECK_THROW( bytes.convertByID( util::typeID<util::color24>(), util::typeID<float>(), 0, 10 ), std::domain_error );
+}
 }
 }
@@ -413,6 +413,37 @@ BOOST_AUTO_TEST_CASE ( chunk_swap_test )
 	}
 }
 
+BOOST_AUTO_TEST_CASE ( chunk_flip_roll_test )
+{
+	// big enough to be done in parallel
+	data::MemChunk<int16_t> ch( 64, 64, 32, 16 );
+	ch.foreachVoxel( []( int16_t &vox, const util::vector4<size_t> &pos ) {vox = pos[0] + pos[1] * 3 + pos[2] * 7 + pos[3] * 11;} );
+	const data::MemChunk<int16_t> orig = ch;
+	const util::vector4<size_t> size = ch.getSizeAsVector();
+
+	for( int dim = data::rowDim; dim <= data::timeDim; dim++ ) {
+		ch.flipAlong( data::dimensions( dim ) );
+		ch.foreachVoxel( [&]( int16_t &vox, const util::vector4<size_t> &pos ) {
+			util::vector4<size_t> opos = pos;
+			opos[dim] = size[dim] - 1 - opos[dim];
+			BOOST_REQUIRE_EQUAL( orig.voxel<int16_t>( opos[0], opos[1], opos[2], opos[3] ), vox );
+		} );
+		ch.flipAlong( data::dimensions( dim ) );
+		BOOST_REQUIRE_EQUAL( ch.compare( orig ), 0 );
+
+		for( const ptrdiff_t shift : {ptrdiff_t( 3 ), ptrdiff_t( -5 ), ptrdiff_t( size[dim] - 1 )} ) {
+			ch.rollAlong( data::dimensions( dim ), shift );
+			ch.foreachVoxel( [&]( int16_t &vox, const util::vector4<size_t> &pos ) {
+				util::vector4<size_t> opos = pos;
+				opos[dim] = ( opos[dim] + size[dim] * 2 - shift ) % size[dim];
+				BOOST_REQUIRE_EQUAL( orig.voxel<int16_t>( opos[0], opos[1], opos[2], opos[3] ), vox );
+			} );
+			ch.rollAlong( data::dimensions( dim ), -shift );
+			BOOST_REQUIRE_EQUAL( ch.compare( orig ), 0 );
+		}
+	}
+}
+
 BOOST_AUTO_TEST_CASE ( chunk_copySlice_Test )
 {
 	size_t rows = 13;
@@ -0,0 +1,86 @@
+/*
+ * concurrencyTest.cpp
+ *
+ * Use the type tables, conversions and the plugin registry from many threads at once.
+ * Best run in a build with ISIS_TSAN enabled.
+ */
+
+#define BOOST_TEST_MODULE ConcurrencyTest
+#include <boost/test/unit_test.hpp>
+#include <isis/core/io_factory.hpp>
+#include <isis/core/valuearray_typed.hpp>
+#include <isis/core/singletons.hpp>
+#include <thread>
+
+namespace isis::test
+{
+
+// run op(thread number) on a bunch of threads which all start at the same time
+template<typename OP> void hammer( OP op )
+{
+	const unsigned threads = std::max( std::thread::hardware_concurrency(), 8u );
+	std::atomic<bool> go = false;
+	std::vector<std::thread> pool;
+
+	for( unsigned t = 0; t < threads; t++ )
+		pool.emplace_back( [&, t]() {
+			while( !go ); // spin, so all threads really run into it at once
+
+			op( t );
+		} );
+
+	go = true;
+
+	for( std::thread &t : pool )
+		t.join();
+}
+
+// must be the first test, so the tables are created concurrently
+BOOST_AUTO_TEST_CASE( concurrent_conversion_test )
+{
+	std::atomic<size_t> failed = 0;
+	hammer( [&failed]( unsigned t ) {
+		for( int i = 0; i < 200; i++ ) {
+			if( util::Value( int16_t( i ) ).as<float>() != float( i ) )
+				failed++;
+			if( util::Value( std::to_string( i + t ) ).as<uint32_t>() != uint32_t( i + t ) )
+				failed++;
+
+			data::TypedArray<int16_t> shorts( 16 );
+			shorts.begin()[3] = i;
+			const data::ValueArray floats = shorts.copyAs<float>( data::scaling_pair( 1, 0 ) );
+			if( floats.beginTyped<float>()[3] != float( i ) )
+				failed++;
+
+			data::ByteArray bytes( 8 );
+			if( bytes.atByID( util::typeID<uint16_t>(), 0, 4 ).getLength() != 4 )
+				failed++;
+			if( !data::ValueArray::getConverterFromTo( util::typeID<double>(), util::typeID<uint8_t>() ) )
+				failed++;
+
+			data::IOFactory::getFileFormatList( {"nii"} );
+		}
+	} );
+	BOOST_CHECK_EQUAL( failed, 0 );
+}
+
+struct Counted {
+	static std::atomic<int> created;
+	Counted() {
+		created++;
+		std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) ); // make sure the others come in while this is still being created
+	}
+};
+std::atomic<int> Counted::created = 0;
+
+BOOST_AUTO_TEST_CASE( concurrent_singleton_test )
+{
+	std::vector<Counted *> got( std::max( std::thread::hardware_concurrency(), 8u ) );
+	hammer( [&got]( unsigned t ) {got[t] = &util::Singletons::get<Counted>();} );
+
+	BOOST_CHECK_EQUAL( Counted::created, 1 );
+	for( Counted *ptr : got )
+		BOOST_CHECK_EQUAL( ptr, got.front() );
+}
+
+}
@@ -3,8 +3,11 @@
 
 #include <isis/core/tmpfile.hpp>
 #include <isis/core/fileptr.hpp>
+#include <isis/core/batch_reader.hpp>
 #include <filesystem>
 #include <fstream>
+#include <numeric>
+#include <unistd.h>
 
 namespace isis
 {
@@ -117,5 +120,165 @@ BOOST_AUTO_TEST_CASE( FilePtr_at_test )
 
 }
 
+BOOST_AUTO_TEST_CASE( FilePtr_advise_test )
+{
+	util::TmpFile testfile;
+	{
+		data::FilePtr fptr( testfile, 1024 * 1024, true );
+		BOOST_REQUIRE( fptr.good() );
+		std::iota( fptr.begin(), fptr.end(), 0 );
+	}
+
+	const size_t threshold = data::FilePtr::getMapThreshold();
+	data::FilePtr::setMapThreshold( 0 ); // so the file will be mapped
+	BOOST_CHECK_EQUAL( data::FilePtr::getMapThreshold(), 0 );
+	data::FilePtr fptr( testfile );
+	data::FilePtr::setMapThreshold( threshold );
+	BOOST_REQUIRE( fptr.good() );
+
+	BOOST_CHECK( fptr.advise( data::ByteArray::Access::sequential ) );
+	BOOST_CHECK( fptr.advise( data::ByteArray::Access::random, 12345, 4096 ) ); // the range doesn't have to be aligned
+	BOOST_CHECK( fptr.prefetch( 1000 ) );
+	BOOST_CHECK( !fptr.prefetch( fptr.getLength() ) ); // nothing there
+	BOOST_CHECK( fptr.advise( data::ByteArray::Access::normal ) );
+
+	// it's only a hint, the data is still the same
+	BOOST_CHECK_EQUAL( fptr[12345], uint8_t( 12345 ) );
+}
+
+BOOST_AUTO_TEST_CASE( FilePtr_scratch_test )
+{
+	data::FilePtr fptr = data::FilePtr::scratch( 1024 * 1024 );
+	BOOST_REQUIRE( fptr.good() );
+	BOOST_REQUIRE_EQUAL( fptr.getLength(), 1024 * 1024 );
+
+	// it's zeroed and writable
+	auto ptr = fptr.at<uint32_t>( 0 );
+	BOOST_CHECK( std::all_of( ptr.beginTyped<uint32_t>(), ptr.endTyped<uint32_t>(), []( uint32_t v ) {return v == 0;} ) );
+	std::iota( ptr.beginTyped<uint32_t>(), ptr.endTyped<uint32_t>(), 0 );
+	BOOST_CHECK_EQUAL( ptr.beginTyped<uint32_t>()[1000], 1000 );
+
+	// and stays valid while being used (even if the FilePtr itself is gone)
+	fptr.release();
+	BOOST_CHECK_EQUAL( ptr.beginTyped<uint32_t>()[ptr.getLength() - 1], ptr.getLength() - 1 );
+
+	// scratch files don't keep their file descriptor
+	const auto open_files = []() {return std::distance( std::filesystem::directory_iterator( "/proc/self/fd" ), std::filesystem::directory_iterator() );};
+	const auto before = open_files();
+	std::list<data::FilePtr> many;
+
+	for( size_t i = 0; i < 20; i++ )
+		BOOST_REQUIRE( many.emplace_back( data::FilePtr::scratch( 4096 ) ).good() );
+
+	BOOST_CHECK_EQUAL( open_files(), before );
+}
+
+BOOST_AUTO_TEST_CASE( FilePtr_scratch_dir_test )
+{
+	const std::filesystem::path previous = data::FilePtr::getScratchDir();
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / ( "isis_scratch_test_" + std::to_string( getpid() ) );
+	std::filesystem::create_directory( dir );
+	data::FilePtr::setScratchDir( dir );
+	BOOST_CHECK_EQUAL( data::FilePtr::getScratchDir(), dir );
+
+	{
+		const data::FilePtr fptr = data::FilePtr::scratch( 1024 * 1024 );
+		BOOST_REQUIRE( fptr.good() );
+
+		// the file is in the scratch dir, but has no name there
+		const uintptr_t address = reinterpret_cast<uintptr_t>( fptr.getRawAddress().get() );
+		std::ifstream maps( "/proc/self/maps" );
+		std::string mapping;
+
+		for( std::string line; std::getline( maps, line ); )
+			if( std::stoull( line, nullptr, 16 ) == address )
+				mapping = line;
+
+		BOOST_CHECK_MESSAGE( mapping.find( dir.native() + '/' ) != std::string::npos, mapping );
+		BOOST_CHECK( std::filesystem::is_empty( dir ) );
+	}
+
+	// there are no scratch files in a directory that doesn't exist
+	std::filesystem::remove( dir );
+	BOOST_CHECK( !data::FilePtr::scratch( 4096 ).good() );
+
+	data::FilePtr::setScratchDir( previous );
+}
+
+BOOST_AUTO_TEST_CASE( BatchReader_test )
+{
+	std::list<util::TmpFile> tmpfiles;
+	std::vector<std::filesystem::path> files;
+	for( size_t i = 0; i < 100; i++ ) {
+		std::ofstream( tmpfiles.emplace_back( ".raw" ), std::ios::binary ) << std::string( i * 100, char( i ) );
+		files.push_back( tmpfiles.back() );
+	}
+	files.push_back( "/this/file/does/not/exist" );
+
+	for( data::BatchReader::backend use : {data::BatchReader::threads, data::BatchReader::uring} ) {
+		if( use == data::BatchReader::uring && !data::BatchReader::hasUring() )
+			continue;
+
+		// files bigger than 5000 bytes are not read, the first one is empty and the last one does not exist
+		std::map<std::filesystem::path, data::ByteArray> got;
+		const size_t read = data::BatchReader::read( files, [&]( const std::filesystem::path &file, data::ByteArray &&data ) {
+			BOOST_CHECK( got.emplace( file, data ).second ); // every file is handed over once
+		}, 5000, 8, use );
+
+		BOOST_CHECK_EQUAL( read, 50 );
+		BOOST_REQUIRE_EQUAL( got.size(), files.size() );
+		for( size_t i = 0; i < 100; i++ ) {
+			const data::ByteArray &data = got[files[i]];
+			if( i == 0 || i > 50 ) {
+				BOOST_CHECK( !data.isValid() );
+			} else {
+				BOOST_REQUIRE( data.isValid() );
+				BOOST_REQUIRE_EQUAL( data.getLength(), i * 100 );
+				BOOST_CHECK( std::all_of( data.begin(), data.end(), [i]( uint8_t v ) {return v == uint8_t( i );} ) );
+			}
+		}
+		BOOST_CHECK( !got[files.back()].isValid() );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( BatchReader_fetch_test )
+{
+	// the first two workers fail to connect, the others have to fetch their items as well
+	std::atomic<size_t> connects = 0;
+	const auto connect = [&]() -> data::BatchReader::fetcher {
+		if( connects++ < 2 )
+			throw std::runtime_error( "connection refused" );
+
+		return []( size_t index ) {
+			if( index == 42 )
+				throw std::runtime_error( "no such item" );
+
+			data::ByteArray ret( 1 );
+			ret[0] = uint8_t( index );
+			return ret;
+		};
+	};
+
+	std::map<size_t, data::ByteArray> got;
+	const size_t fetched = data::BatchReader::fetch( 100, 4, connect, [&]( size_t index, data::ByteArray &&data ) {
+		BOOST_CHECK( got.emplace( index, data ).second ); // every item is handed over once
+	} );
+
+	BOOST_CHECK_EQUAL( connects, 4 );
+	BOOST_CHECK_EQUAL( fetched, 99 );
+	BOOST_REQUIRE_EQUAL( got.size(), 100 );
+
+	for( const auto &[index, data] : got ) {
+		BOOST_REQUIRE_EQUAL( data.isValid(), index != 42 );
+		BOOST_CHECK( index == 42 || data[0] == uint8_t( index ) );
+	}
+
+	// if no worker can connect, that's an error
+	BOOST_CHECK_THROW(
+		data::BatchReader::fetch( 10, 3, []() -> data::BatchReader::fetcher {throw std::runtime_error( "connection refused" );}, []( size_t, data::ByteArray && ) {} ),
+		std::runtime_error
+	);
+}
+
 }
 }
@@ -9,6 +9,7 @@
 #include <boost/test/unit_test.hpp>
 #include <isis/core/image.hpp>
 #include <isis/core/io_factory.hpp>
+#include <isis/core/image_assembler.hpp>
 
 namespace isis
 {
@@ -64,5 +65,68 @@ BOOST_AUTO_TEST_CASE ( imageList_chunk_test )
 	}
 }
 
+data::Chunk makeListChunk( size_t image, size_t timestep )
+{
+	data::MemChunk<float> ch( 3, 3, 3 );
+	ch.setValueAs( "indexOrigin", util::fvector3( ) );
+	ch.setValueAs( "acquisitionNumber",  ( uint32_t )timestep );
+	ch.setValueAs( "rowVec", util::fvector3( {1, 0} ) );
+	ch.setValueAs( "columnVec", util::fvector3( {0, 1} ) );
+	ch.setValueAs( "voxelSize", util::fvector3( {1, 1, 1} ) );
+	ch.setValueAs( "sequenceNumber", ( uint16_t )0 );
+	ch.voxel<float>( 0, 0, 0 ) = image + timestep;
+	return ch;
+}
+
+/* put images together while chunks come in*/
+BOOST_AUTO_TEST_CASE ( imageAssembler_test )
+{
+	const size_t images = 5;
+	const size_t timesteps = 10;
+	std::list<data::Image> list;
+
+	// interleaved chunks end up in the same images as with chunkListToImageList
+	data::ImageAssembler interleaved( [&list]( data::Image &&img ) {list.push_back( img );} );
+	for ( size_t i = 0; i < timesteps; i++ )
+		for ( size_t c = 0; c < images; c++ )
+			BOOST_CHECK( interleaved.push( makeListChunk( c, i ) ) );
+
+	BOOST_CHECK_EQUAL( interleaved.pending(), images );
+	BOOST_CHECK( list.empty() );
+	BOOST_CHECK_EQUAL( interleaved.flush(), images );
+	BOOST_REQUIRE_EQUAL( list.size(), images );
+
+	size_t cnt = 0;
+	for( data::Image & ref : list ) {
+		BOOST_CHECK_EQUAL( ref.getSizeAsVector(), ( util::vector4<size_t>{3, 3, 3, timesteps} ) );
+		for ( size_t i = 0; i < timesteps; i++ )
+			BOOST_CHECK_EQUAL( ref.voxel<float>( 0, 0, 0, i ), i + cnt );
+		cnt++;
+	}
+
+	// with sorted chunks each image is done as soon as the next one starts
+	list.clear();
+	data::ImageAssembler sorted( [&list]( data::Image &&img ) {list.push_back( img );}, 1 );
+	for ( size_t c = 0; c < images; c++ ) {
+		for ( size_t i = 0; i < timesteps; i++ ) {
+			sorted.push( makeListChunk( c, i ) );
+			BOOST_CHECK_EQUAL( list.size(), c ); // the previous image was handed on with the first chunk of this one
+		}
+		BOOST_CHECK_EQUAL( sorted.pending(), 1 );
+	}
+	sorted.flush();
+	BOOST_REQUIRE_EQUAL( list.size(), images );
+	BOOST_CHECK_EQUAL( list.back().voxel<float>( 0, 0, 0, timesteps - 1 ), images - 1 + timesteps - 1 );
+
+	// invalid chunks are rejected
+	util::slist rejected;
+	data::ImageAssembler rejecting( []( data::Image && ) {}, 0, &rejected );
+	data::MemChunk<float> invalid( 3, 3, 3 );
+	invalid.setValueAs( "source", std::string( "nowhere" ) );
+	BOOST_CHECK( !rejecting.push( invalid ) );
+	BOOST_CHECK_EQUAL( rejected, util::slist{"nowhere"} );
+	BOOST_CHECK_EQUAL( rejecting.flush(), 0 );
+}
+
 }
 }
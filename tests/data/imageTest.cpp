@@ -12,6 +12,11 @@
 #include <isis/core/image.hpp>
 #include <isis/core/io_factory.hpp>
 #include <isis/math/transform.hpp>
+#include <isis/core/memorypool.hpp>
+#include <fstream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -188,6 +193,51 @@ BOOST_AUTO_TEST_CASE ( copy_image_test )
 	data::Image copy = img.copy();
 	BOOST_CHECK( img.compare( copy ) == 0 );
 }
+BOOST_AUTO_TEST_CASE ( image_diff_test )
+{
+	std::list<data::Chunk> chunks;
+
+	for( uint32_t t = 0; t < 3; t++ ) {
+		chunks.push_back( genSlice<float>( 4, 4, 0, t ) );
+		std::fill( chunks.back().beginTyped<float>(), chunks.back().endTyped<float>(), float( t ) );
+	}
+
+	const data::Image img( chunks );
+	data::Image other( img.copyAsMemChunk<double>() ); // other type and only one chunk
+	BOOST_REQUIRE_EQUAL( other.copyChunksToVector().size(), 1 );
+	BOOST_CHECK_EQUAL( img.compare( other ), 0 );
+
+	other.voxel<double>( 1, 2, 0, 2 ) = 2.25;
+	const data::DiffStats stats = img.diff( other );
+	BOOST_CHECK_EQUAL( stats.differing, 1 );
+	BOOST_CHECK_EQUAL( stats.compared, img.getVolume() );
+	BOOST_CHECK_EQUAL( img.getCoordsFromLinIndex( stats.first ), ( util::vector4<size_t>{1, 2, 0, 2} ) );
+	BOOST_CHECK_CLOSE( stats.max_abs, 0.25, 1e-5 );
+	BOOST_CHECK_EQUAL( img.diff( other, 0.3 ).differing, 0 );
+}
+BOOST_AUTO_TEST_CASE ( image_hash_test )
+{
+	std::list<data::Chunk> chunks;
+
+	for( uint32_t t = 0; t < 3; t++ ) {
+		chunks.push_back( genSlice<float>( 4, 4, 0, t ) );
+		std::fill( chunks.back().beginTyped<float>(), chunks.back().endTyped<float>(), float( t ) );
+	}
+
+	const data::Image img( chunks );
+	const data::MemChunk<float> whole = img.copyAsMemChunk<float>();
+	data::Image other( whole ); // same data, other chunk layout
+
+	BOOST_CHECK_EQUAL( img.contentHash(), other.contentHash() );
+	BOOST_CHECK_EQUAL( img.contentHash(), whole.hash() );
+	BOOST_CHECK_NE( img.contentHash(), chunks.front().hash() );
+
+	other.voxel<float>( 1, 2, 0, 2 ) = 2.25;
+	BOOST_CHECK_NE( img.contentHash(), other.contentHash() );
+
+	// the type is part of the hash
+	BOOST_CHECK_NE( whole.hash(), whole.copyAs<double>( {1, 0} ).hash() );
+}
 BOOST_AUTO_TEST_CASE ( ident_image_test )
 {
 	data::Chunk ch = genSlice<float>( 4, 4 );
@@ -937,6 +987,60 @@ BOOST_AUTO_TEST_CASE( typediamge_test )
 	}
 } // END typedimage_test
 
+BOOST_AUTO_TEST_CASE( typedimage_accessor_test )
+{
+	const size_t nrX = 5, nrY = 4, nrS = 3, nrT = 2;
+	std::list<data::Chunk> chunks;
+
+	for ( size_t t = 0; t < nrT; t++ )
+		for ( size_t s = 0; s < nrS; s++ )
+			chunks.push_back( genSlice<int16_t>( nrX, nrY, s, s + t * nrS ) );
+
+	data::TypedImage<int16_t> img{data::Image( chunks )};
+	BOOST_REQUIRE( img.isClean() );
+	BOOST_REQUIRE_EQUAL( img.getSizeAsVector(), ( util::vector4<size_t>{nrX, nrY, nrS, nrT} ) );
+
+	const auto access = img.getAccessor();
+	BOOST_CHECK_EQUAL( access.getSize()[2], nrS );
+
+	for ( size_t x = 0; x < nrX; x++ )
+		for ( size_t y = 0; y < nrY; y++ )
+			for ( size_t s = 0; s < nrS; s++ )
+				for ( size_t t = 0; t < nrT; t++ )
+					access( x, y, s, t ) = x + y * 10 + s * 100 + t * 1000;
+
+	// writes through the accessor end up in the image
+	for ( size_t x = 0; x < nrX; x++ )
+		for ( size_t y = 0; y < nrY; y++ )
+			for ( size_t s = 0; s < nrS; s++ )
+				for ( size_t t = 0; t < nrT; t++ ) {
+					BOOST_REQUIRE_EQUAL( img.voxel<int16_t>( x, y, s, t ), x + y * 10 + s * 100 + t * 1000 );
+					BOOST_REQUIRE_EQUAL( &img.voxel<int16_t>( x, y, s, t ), &access( x, y, s, t ) );
+				}
+
+	// lines within a chunk and across chunks
+	const auto row = access.line( data::rowDim, 3, 2, 1, 1 );
+	BOOST_REQUIRE_EQUAL( row.size(), nrX );
+	for ( size_t x = 0; x < nrX; x++ )
+		BOOST_CHECK_EQUAL( row[x], x + 2 * 10 + 100 + 1000 );
+
+	const auto slice = access.line( data::sliceDim, 3, 2, 1, 1 );
+	BOOST_REQUIRE_EQUAL( slice.size(), nrS );
+	for ( size_t s = 0; s < nrS; s++ )
+		BOOST_CHECK_EQUAL( slice[s], 3 + 2 * 10 + s * 100 + 1000 );
+
+	// clamped access repeats the border
+	BOOST_CHECK_EQUAL( access.clamped( -1, 0, 0, 0 ), access( 0, 0, 0, 0 ) );
+	BOOST_CHECK_EQUAL( access.clamped( nrX + 3, nrY, -2, nrT ), access( nrX - 1, nrY - 1, 0, nrT - 1 ) );
+
+	// const images give const accessors
+	const data::TypedImage<int16_t> &cimg = img;
+	const auto caccess = cimg.getAccessor();
+	static_assert( std::is_same_v<decltype( caccess( 0 ) ), const int16_t &> );
+	BOOST_CHECK_EQUAL( caccess( 1, 2, 2, 1 ), 1 + 20 + 200 + 1000 );
+	BOOST_CHECK_EQUAL( cimg.voxel<int16_t>( 1, 2, 2, 1 ), 1 + 20 + 200 + 1000 );
+}
+
 BOOST_AUTO_TEST_CASE ( image_init_test_sizes_and_values )
 {
 	unsigned int nrX = 45;
@@ -1334,4 +1438,101 @@ BOOST_AUTO_TEST_CASE ( image_swapdim_test )
 }
 
 
+BOOST_AUTO_TEST_CASE ( image_flip_roll_test )
+{
+	std::list<data::MemChunk<uint32_t> > chunks;
+	for(int i=0; i<30;i++){
+		chunks.push_back(genSlice<uint32_t>( 50, 40, i,i ));
+	}
+
+	data::Image img( chunks );
+	const data::NDimensional<4> shape=img;
+	BOOST_REQUIRE( img.isClean() );
+
+	uint32_t cnt=0;
+	for( data::Image::reference ref :  img )
+		ref = cnt++;
+
+	// rows are flipped inside the chunks, slices by moving the chunks
+	img.flipAlong(data::rowDim);
+	img.flipAlong(data::sliceDim);
+
+	for(size_t z=0;z<30;z++){
+		// metadata stays where it is
+		BOOST_CHECK_EQUAL(img.getChunk(0,0,z).getValueAs<uint32_t>("acquisitionNumber"),z);
+		for(size_t y=0;y<40;y++)
+			for(size_t x=0;x<50;x++)
+				BOOST_REQUIRE_EQUAL(img.voxel<uint32_t>(x,y,z),shape.getLinearIndex( {49-x,y,29-z} ));
+	}
+
+	img.flipAlong(data::rowDim);
+	img.flipAlong(data::sliceDim);
+	img.rollAlong(data::sliceDim,7);
+	img.rollAlong(data::columnDim,-3);
+
+	for(size_t z=0;z<30;z++)
+		for(size_t y=0;y<40;y++)
+			for(size_t x=0;x<50;x++)
+				BOOST_REQUIRE_EQUAL(img.voxel<uint32_t>(x,y,z),shape.getLinearIndex( {x,(y+3)%40,(z+30-7)%30} ));
+}
+
+BOOST_AUTO_TEST_CASE ( image_out_of_core_test )
+{
+	// do this in a child process, so the resource limit doesn't hurt the other tests
+	const pid_t child = fork();
+	BOOST_REQUIRE_GE( child, 0 );
+
+	if( child == 0 ) {
+		// limit the heap to what is in use plus 64MB (shared file mappings are not counted as data)
+		std::ifstream status( "/proc/self/status" );
+		size_t data_kb = 0;
+
+		for( std::string line; std::getline( status, line ); )
+			if( line.rfind( "VmData:", 0 ) == 0 )
+				data_kb = std::stoul( line.substr( 7 ) );
+
+		const rlimit limit{( data_kb + 64 * 1024 ) * 1024, RLIM_INFINITY};
+
+		if( data_kb == 0 || setrlimit( RLIMIT_DATA, &limit ) != 0 )
+			_exit( 2 );
+
+		if( void *too_big = malloc( 256 * 1024 * 1024 ) ) { // the limit must be effective
+			free( too_big );
+			_exit( 3 );
+		}
+
+		data::MemoryPool::setBudget( 16 * 1024 * 1024 );
+		const size_t scratch_before = data::MemoryPool::getStats().scratch;
+
+		// 64 slices of 2MB make an image of 128MB, which becomes 256MB when converted to uint16_t
+		std::list<data::Chunk> chunks;
+
+		for( uint32_t z = 0; z < 64; z++ ) {
+			chunks.push_back( genSlice<uint8_t>( 2048, 1024, z, z ) );
+			std::fill( chunks.back().beginTyped<uint8_t>(), chunks.back().endTyped<uint8_t>(), uint8_t( z ) );
+		}
+
+		data::Image img( chunks );
+
+		if( !img.isClean() || img.getVolume() != 2048 * 1024 * 64 )
+			_exit( 4 );
+
+		chunks.clear();
+
+		if( !img.convertToType( util::typeID<uint16_t>() ) )
+			_exit( 5 );
+
+		for( uint32_t z = 0; z < 64; z++ )
+			if( img.voxel<uint16_t>( 0, 0, z ) != z || img.voxel<uint16_t>( 2047, 1023, z ) != z )
+				_exit( 6 );
+
+		_exit( data::MemoryPool::getStats().scratch - scratch_before > 64 ? 0 : 7 );
+	}
+
+	int status = 0;
+	BOOST_REQUIRE_EQUAL( waitpid( child, &status, 0 ), child );
+	BOOST_REQUIRE( WIFEXITED( status ) );
+	BOOST_CHECK_EQUAL( WEXITSTATUS( status ), 0 );
+}
+
 } // END namespace isis
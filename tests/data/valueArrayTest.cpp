@@ -11,6 +11,7 @@
 #include <isis/core/valuearray.hpp>
 #include <isis/core/valuearray_typed.hpp>
 #include <cmath>
+#include <malloc.h>
 
 
 namespace isis
@@ -499,5 +500,117 @@ BOOST_AUTO_TEST_CASE( ValueArray_generic_iterator_test )
 
 	BOOST_CHECK_EQUAL( std::distance( array.begin(), array.end() ), 1024 );
 }
+
+BOOST_AUTO_TEST_CASE( ValueArray_diff_test )
+{
+	auto array1 = data::ValueArray::make<float>( 3 * 1024 * 1024 ); // more than one block
+	auto array2 = data::ValueArray::make<float>( 3 * 1024 * 1024 + 10 );
+	std::fill( array1.beginTyped<float>(), array1.endTyped<float>(), 1.f );
+	std::fill( array2.beginTyped<float>(), array2.endTyped<float>(), 1.f );
+
+	array2.beginTyped<float>()[10 + 5] = 1.5; // compared to array1[5]
+	array2.beginTyped<float>()[10 + 2000000] = 1.f + 1e-6;
+	array1.beginTyped<float>()[3000000] = array2.beginTyped<float>()[10 + 3000000] = NAN; // NaN equals NaN
+
+	const data::DiffStats stats = array1.diff( 0, array1.getLength(), array2, 10 );
+	BOOST_CHECK_EQUAL( stats.compared, array1.getLength() );
+	BOOST_CHECK_EQUAL( stats.differing, 2 );
+	BOOST_CHECK_EQUAL( stats.first, 5 );
+	BOOST_CHECK_EQUAL( stats.worst, 5 );
+	BOOST_CHECK_CLOSE( stats.max_abs, 0.5, 1e-5 );
+	BOOST_CHECK_CLOSE( stats.max_rel, 0.5 / 1.5, 1e-5 );
+	BOOST_CHECK_EQUAL( array1.compare( 0, array1.getLength(), array2, 10 ), 2 );
+
+	// the small difference is within the tolerance
+	BOOST_CHECK_EQUAL( array1.diff( 0, array1.getLength(), array2, 10, 1e-5 ).differing, 1 );
+	BOOST_CHECK_EQUAL( array1.diff( 0, array1.getLength(), array2, 10, 0, 0.5 ).differing, 0 );
+
+	// different scalar types are compared by value
+	auto shorts = data::ValueArray::make<short>( 1024 );
+	auto doubles = data::ValueArray::make<double>( 1024 );
+
+	for( int i = 0; i < 1024; i++ ) {
+		shorts.beginTyped<short>()[i] = i - 512;
+		doubles.beginTyped<double>()[i] = i - 512;
+	}
+
+	BOOST_CHECK_EQUAL( shorts.compare( 0, 1024, doubles, 0 ), 0 );
+	doubles.beginTyped<double>()[100] = 0.25;
+	const data::DiffStats mixed = shorts.diff( 0, 1024, doubles, 0 );
+	BOOST_CHECK_EQUAL( mixed.differing, 1 );
+	BOOST_CHECK_EQUAL( mixed.worst, 100 );
+	BOOST_CHECK_CLOSE( mixed.rms(), std::sqrt( 412.25 * 412.25 / 1024 ), 1e-5 );
+
+	// two NaNs and two infinities of the same sign are equal, any other pair with NaN or infinity differs (whatever the tolerance)
+	const double inf = std::numeric_limits<double>::infinity();
+	const std::tuple<double, double, size_t> specials[] = {
+		{NAN, NAN, 0}, {inf, inf, 0}, {-inf, -inf, 0},
+		{NAN, 1, 1}, {NAN, inf, 1}, {inf, 1, 1}, {inf, -inf, 1}, {-inf, 0, 1}
+	};
+
+	for( const auto &[x, y, differ] : specials ) {
+		auto a = data::ValueArray::make<double>( 1 );
+		auto b = data::ValueArray::make<float>( 1 );
+		a.beginTyped<double>()[0] = x;
+		b.beginTyped<float>()[0] = y;
+		BOOST_CHECK_EQUAL( a.compare( 0, 1, b, 0 ), differ );
+		BOOST_CHECK_EQUAL( b.compare( 0, 1, a, 0 ), differ );
+		BOOST_CHECK_EQUAL( a.diff( 0, 1, b, 0, 1e10, 1 ).differing, differ );
+		BOOST_CHECK_EQUAL( b.diff( 0, 1, a, 0, 1e10, 1 ).differing, differ );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( ValueArray_pool_test )
+{
+	data::MemoryPool::setLimit( 64 * 1024 * 1024 );
+	data::MemoryPool::trim();
+	const data::MemoryPool::Stats before = data::MemoryPool::getStats();
+	BOOST_CHECK_EQUAL( before.cached, 0 );
+
+	for( size_t length : {100 * 1000, 3 * 1024 * 1024} ) { // one size that is cached per thread and one that is mapped
+		const void *first;
+		{
+			auto array = data::ValueArray::make<float>( length );
+			first = array.getRawAddress().get();
+			std::fill( array.beginTyped<float>(), array.endTyped<float>(), 42.f );
+		}
+		BOOST_CHECK_GT( data::MemoryPool::getStats().cached, 0 );
+
+		// a slightly smaller array of the same size class gets the same memory, zeroed again
+		auto array = data::ValueArray::make<float>( length - 10 );
+		BOOST_CHECK_EQUAL( array.getRawAddress().get(), first );
+		BOOST_CHECK( std::all_of( array.beginTyped<float>(), array.endTyped<float>(), []( float v ) {return v == 0;} ) );
+	}
+
+	const data::MemoryPool::Stats after = data::MemoryPool::getStats();
+	BOOST_CHECK_EQUAL( after.reused - before.reused, 2 );
+	BOOST_CHECK_EQUAL( after.fresh - before.fresh, 2 );
+
+	// conversions use the pool as well
+	{
+		const data::TypedArray<int16_t> shorts( 1024 * 1024 );
+		auto floats = shorts.copyAs<float>();
+		BOOST_CHECK_EQUAL( floats.getLength(), shorts.getLength() );
+	}
+	BOOST_CHECK_GE( data::MemoryPool::getStats().cached, 1024 * 1024 * sizeof( float ) );
+
+	// without a limit nothing is kept
+	data::MemoryPool::setLimit( 0 );
+	BOOST_CHECK_EQUAL( data::MemoryPool::getStats().cached, 0 );
+	data::ValueArray::make<float>( 1024 * 1024 );
+	BOOST_CHECK_EQUAL( data::MemoryPool::getStats().cached, 0 );
+
+	// and the memory is not rounded up to a size class (which would be 112KB here)
+	{
+		auto array = data::ValueArray::make<uint8_t>( 100 * 1000 );
+		BOOST_CHECK_LT( malloc_usable_size( array.getRawAddress().get() ), 112 * 1024 );
+	}
+	// memory from the pool is given back properly, even if pooling was disabled in between
+	data::MemoryPool::setLimit( 64 * 1024 * 1024 );
+	auto pooled = data::ValueArray::make<float>( 3 * 1024 * 1024 );
+	data::MemoryPool::setLimit( 0 );
+	pooled = data::ValueArray();
+	BOOST_CHECK_EQUAL( data::MemoryPool::getStats().cached, 0 );
+}
 }
 }
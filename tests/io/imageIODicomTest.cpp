@@ -0,0 +1,231 @@
+/*
+ * imageIODicomTest.cpp
+ *
+ * Tests for the parts of the dicom plugin that don't need actual dicom files.
+ */
+
+#include "../../io_plugins/dicom/imageFormat_Dicom.hpp"
+
+using namespace isis;
+
+#define BOOST_TEST_MODULE "imageIODicomTest"
+#include <boost/test/unit_test.hpp>
+
+#ifdef HAVE_OPENJPEG
+#include <openjpeg.h>
+#endif
+
+namespace isis::test
+{
+// a siemens mosaic as it comes from the dicom plugin (before it's decomposed)
+data::Chunk makeMosaic( size_t tile, uint16_t images, size_t frames )
+{
+	const size_t matrix = std::ceil( std::sqrt( images ) );
+	data::MemChunk<int16_t> ret( tile * matrix, tile * matrix, frames );
+
+	for( size_t i = 0; i < ret.getVolume(); i++ )
+		ret.beginTyped<int16_t>()[i] = int16_t( i * 7 );
+
+	ret.setValueAs( "DICOM/ImageType", util::slist{"ORIGINAL", "PRIMARY", "M", "MOSAIC"} );
+	ret.setValueAs( "DICOM/SiemensNumberOfImagesInMosaic", images );
+	ret.setValueAs( "DICOM/SIEMENS CSA HEADER/MosaicRefAcqTimes", util::dlist( images, 12.5 ) );
+	ret.setValueAs( "acquisitionTime", util::timestamp( std::chrono::hours( 10 ) ) );
+	ret.setValueAs( "voxelSize", util::fvector3( {2, 2, 3} ) );
+	ret.setValueAs( "voxelGap", util::fvector3( {0, 0, 0.5} ) );
+	ret.setValueAs( "rowVec", util::fvector3( {1, 0, 0} ) );
+	ret.setValueAs( "columnVec", util::fvector3( {0, 1, 0} ) );
+	ret.setValueAs( "indexOrigin", util::fvector3( {-100, -100, 10} ) );
+	ret.setValueAs( "fov", util::fvector3( {float( tile * matrix * 2 ), float( tile * matrix * 2 ), 3} ) );
+	return ret;
+}
+
+// how the mosaic was decomposed before (line by line, and only the first frame)
+data::Chunk referenceMosaic( data::Chunk source, size_t frame )
+{
+	const uint16_t images = source.getValueAs<uint16_t>( "DICOM/SiemensNumberOfImagesInMosaic" );
+	const uint16_t matrixSize = std::ceil( std::sqrt( images ) );
+	const util::vector4<size_t> tSize = source.getSizeAsVector();
+	const util::vector3<size_t> size( {tSize[0] / matrixSize, tSize[1] / matrixSize, images} );
+	data::Chunk dest = source.cloneToNew( size[0], size[1], size[2] );
+
+	for ( size_t slice = 0; slice < images; slice++ ) {
+		for ( size_t line = 0; line < size[1]; line++ ) {
+			const size_t column = slice % matrixSize, row = slice / matrixSize;
+			const std::array<size_t, 4> sstart{column * size[0], row * size[1] + line, frame, 0};
+			const std::array<size_t, 4> send{sstart[0] + size[0] - 1, row * size[1] + line, frame, 0};
+			source.copyRange( sstart, send, dest, {0, line, slice, 0} );
+		}
+	}
+
+	return dest;
+}
+
+BOOST_AUTO_TEST_CASE( mosaicTest )
+{
+	for( uint16_t images : {1, 16, 30, 64} ) { // full and partially filled mosaics
+		const data::Chunk mosaic = makeMosaic( 13, images, 1 );
+		const data::Chunk ref = referenceMosaic( mosaic, 0 );
+		const data::Chunk volume = image_io::ImageFormat_Dicom::readMosaic( mosaic );
+
+		BOOST_REQUIRE_EQUAL( volume.getSizeAsVector(), ( util::vector4<size_t>( {13, 13, images, 1} ) ) );
+		BOOST_CHECK_EQUAL( volume.compare( ref ), 0 );
+
+		BOOST_CHECK( volume.getValueAs<util::slist>( "DICOM/ImageType" ) == ( util::slist{"ORIGINAL", "PRIMARY", "M", "WAS_MOSAIC"} ) );
+		BOOST_CHECK( !volume.hasProperty( "DICOM/SiemensNumberOfImagesInMosaic" ) );
+		BOOST_CHECK( !volume.hasProperty( "DICOM/SIEMENS CSA HEADER/MosaicRefAcqTimes" ) );
+
+		// the origin moves from the corner of the mosaic to the corner of the first tile
+		const size_t matrix = std::ceil( std::sqrt( images ) );
+		const float shift = 2 * 13 * ( matrix - 1 ) / 2.f;
+		BOOST_CHECK_EQUAL( volume.getValueAs<util::fvector3>( "indexOrigin" ), util::fvector3( {-100 + shift, -100 + shift, 10} ) );
+		BOOST_CHECK_EQUAL( volume.getValueAs<util::fvector3>( "fov" ), util::fvector3( {26, 26, 3.f * images + 0.5f * ( images - 1 )} ) );
+
+		// every slice gets its own acquisition time
+		const util::PropertyValue &acq = *volume.queryProperty( "acquisitionTime" );
+		BOOST_REQUIRE_EQUAL( acq.size(), images );
+		BOOST_CHECK( acq[images - 1].as<util::timestamp>() == util::timestamp( std::chrono::hours( 10 ) + std::chrono::milliseconds( 12 ) ) );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( multiFrameMosaicTest )
+{
+	// every frame becomes a volume (before only the first frame was used)
+	const data::Chunk mosaic = makeMosaic( 8, 20, 5 );
+	const data::Chunk volumes = image_io::ImageFormat_Dicom::readMosaic( mosaic );
+	BOOST_REQUIRE_EQUAL( volumes.getSizeAsVector(), ( util::vector4<size_t>( {8, 8, 20, 5} ) ) );
+
+	for( size_t frame = 0; frame < 5; frame++ ) {
+		const data::Chunk ref = referenceMosaic( mosaic, frame );
+
+		for( size_t z = 0; z < 20; z++ )
+			for( size_t y = 0; y < 8; y++ )
+				for( size_t x = 0; x < 8; x++ )
+					BOOST_REQUIRE_EQUAL( volumes.voxel<int16_t>( x, y, z, frame ), ref.voxel<int16_t>( x, y, z ) );
+	}
+
+	// every slice of every frame gets its own acquisition time, the frames are one repetition time apart
+	data::Chunk timed = makeMosaic( 8, 20, 5 );
+	timed.setValueAs( "DICOM/RepetitionTime", 2000.0 );
+	const data::Chunk tr_timed = image_io::ImageFormat_Dicom::readMosaic( timed );
+	const util::PropertyValue &acq = *tr_timed.queryProperty( "acquisitionTime" );
+	BOOST_REQUIRE_EQUAL( acq.size(), 20 * 5 );
+
+	for( size_t frame = 0; frame < 5; frame++ )
+		for( size_t slice = 0; slice < 20; slice++ )
+			BOOST_CHECK( acq[slice + frame * 20].as<util::timestamp>() == util::timestamp( std::chrono::hours( 10 ) + std::chrono::milliseconds( 12 + 2000 * frame ) ) );
+
+	// the frame time takes precedence over the repetition time
+	timed = makeMosaic( 8, 20, 5 );
+	timed.setValueAs( "DICOM/RepetitionTime", 2000.0 );
+	timed.setValueAs( "DICOM/FrameTime", 500.0 );
+	const data::Chunk frame_timed = image_io::ImageFormat_Dicom::readMosaic( timed );
+	BOOST_CHECK( frame_timed.queryProperty( "acquisitionTime" )->at( 20 * 4 ).as<util::timestamp>() == util::timestamp( std::chrono::hours( 10 ) + std::chrono::milliseconds( 12 + 500 * 4 ) ) );
+
+	// they end up with the right slices of the right volumes
+	const std::list<data::Chunk> slices = frame_timed.spliceAt( data::sliceDim );
+	BOOST_REQUIRE_EQUAL( slices.size(), 20 * 5 );
+	BOOST_CHECK( slices.back().getValueAs<util::timestamp>( "acquisitionTime" ) == util::timestamp( std::chrono::hours( 10 ) + std::chrono::milliseconds( 12 + 500 * 4 ) ) );
+}
+#ifdef HAVE_OPENJPEG
+// encode a frame losslessly as j2k codestream (as it would be stored in a dicom data item)
+data::ValueArray encodeJ2k( const std::vector<int32_t> &pixels, uint32_t width, uint32_t height, uint32_t prec, bool sgnd )
+{
+	opj_image_cmptparm_t param{};
+	param.dx = param.dy = 1;
+	param.w = width;
+	param.h = height;
+	param.prec = prec;
+	param.sgnd = sgnd;
+	opj_image_t *image = opj_image_create( 1, &param, OPJ_CLRSPC_GRAY );
+	image->x1 = width;
+	image->y1 = height;
+	std::copy( pixels.begin(), pixels.end(), image->comps[0].data );
+
+	opj_cparameters_t parameters;
+	opj_set_default_encoder_parameters( &parameters ); // the defaults are lossless
+	opj_codec_t *codec = opj_create_compress( OPJ_CODEC_J2K );
+	opj_setup_encoder( codec, &parameters, image );
+
+	std::vector<uint8_t> out;
+	opj_stream_t *stream = opj_stream_create( OPJ_J2K_STREAM_CHUNK_SIZE, false );
+	opj_stream_set_user_data( stream, &out, nullptr );
+	opj_stream_set_write_function( stream, []( void *buffer, OPJ_SIZE_T bytes, void *data ) -> OPJ_SIZE_T {
+		std::vector<uint8_t> &dst = *static_cast<std::vector<uint8_t> *>( data );
+		dst.insert( dst.end(), static_cast<uint8_t *>( buffer ), static_cast<uint8_t *>( buffer ) + bytes );
+		return bytes;
+	} );
+	const bool ok = opj_start_compress( codec, image, stream ) && opj_encode( codec, stream ) && opj_end_compress( codec, stream );
+	opj_stream_destroy( stream );
+	opj_destroy_codec( codec );
+	opj_image_destroy( image );
+	BOOST_REQUIRE( ok );
+
+	data::ValueArray ret = data::ValueArray::make<uint8_t>( out.size() );
+	std::copy( out.begin(), out.end(), ret.beginTyped<uint8_t>() );
+	return ret;
+}
+std::vector<int32_t> makeFrame( size_t frame, uint32_t width, uint32_t height, int32_t min, int32_t max )
+{
+	std::vector<int32_t> ret( width * height );
+
+	for( size_t i = 0; i < ret.size(); i++ )
+		ret[i] = min + int32_t( ( i * 31 + frame * 1009 + ( i * i ) % 97 ) % ( max - min + 1 ) );
+
+	return ret;
+}
+template<typename T> void checkFrame( const data::Chunk &ch, size_t frame, const std::vector<int32_t> &org )
+{
+	BOOST_REQUIRE_EQUAL( ch.getTypeID(), util::typeID<T>() );
+	const T *const voxels = ch.beginTyped<T>() + frame * org.size();
+	BOOST_CHECK( std::equal( org.begin(), org.end(), voxels, []( int32_t a, T b ) {return a == b;} ) );
+}
+
+BOOST_AUTO_TEST_CASE( j2kTypeTest )
+{
+	// the type is chosen by precision and sign of the codestream
+	const std::vector<int32_t> u8 = makeFrame( 0, 64, 48, 0, 255 ), u12 = makeFrame( 1, 64, 48, 0, 4095 ), s16 = makeFrame( 2, 64, 48, -32768, 32767 );
+
+	const data::Chunk c8 = image_io::_internal::getj2k( {encodeJ2k( u8, 64, 48, 8, false )} );
+	BOOST_REQUIRE_EQUAL( c8.getSizeAsVector(), ( util::vector4<size_t>( {64, 48, 1, 1} ) ) );
+	checkFrame<uint8_t>( c8, 0, u8 );
+
+	checkFrame<uint16_t>( image_io::_internal::getj2k( {encodeJ2k( u12, 64, 48, 12, false )} ), 0, u12 );
+	checkFrame<int16_t>( image_io::_internal::getj2k( {encodeJ2k( s16, 64, 48, 16, true )} ), 0, s16 );
+}
+
+BOOST_AUTO_TEST_CASE( j2kMultiFrameTest )
+{
+	const size_t frames = 9;
+	std::vector<std::vector<int32_t>> org;
+	std::list<data::ValueArray> items = {data::ValueArray::make<uint32_t>( frames )}; // a basic offset table (which is to be skipped)
+
+	for( size_t f = 0; f < frames; f++ ) {
+		org.push_back( makeFrame( f, 100, 70, 0, 4095 ) );
+		const data::ValueArray codestream = encodeJ2k( org.back(), 100, 70, 12, false );
+
+		if( f == 4 ) { // frames may be split into multiple fragments
+			const size_t half = codestream.getLength() / 2;
+			items.push_back( data::ValueArray::make<uint8_t>( half ) );
+			items.push_back( data::ValueArray::make<uint8_t>( codestream.getLength() - half ) );
+			codestream.copyRange( 0, half - 1, *std::prev( items.end(), 2 ), 0 );
+			codestream.copyRange( half, codestream.getLength() - 1, items.back(), 0 );
+		} else
+			items.push_back( codestream );
+	}
+
+	const data::Chunk all = image_io::_internal::getj2k( items );
+	BOOST_REQUIRE_EQUAL( all.getSizeAsVector(), ( util::vector4<size_t>( {100, 70, frames, 1} ) ) );
+
+	for( size_t f = 0; f < frames; f++ ) {
+		checkFrame<uint16_t>( all, f, org[f] );
+		// and decoding them together gives the same as decoding them one by one
+		const data::Chunk single = image_io::_internal::getj2k( {encodeJ2k( org[f], 100, 70, 12, false )} );
+		BOOST_CHECK_EQUAL( static_cast<const data::ValueArray &>( single ).compare( 0, org[f].size() - 1, all, f * org[f].size() ), 0 );
+	}
+
+	// all frames must be alike
+	items.push_back( encodeJ2k( makeFrame( 0, 50, 70, 0, 4095 ), 50, 70, 12, false ) );
+	BOOST_CHECK_THROW( image_io::_internal::getj2k( items ), std::exception );
+}
+#endif //HAVE_OPENJPEG
+}
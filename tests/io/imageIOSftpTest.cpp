@@ -0,0 +1,214 @@
+/*
+ * imageIOSftpTest.cpp
+ *
+ * Tests the sftp plugin against a local sshd (if there is one) serving "number" files.
+ */
+
+#include "numberFormat.hpp"
+#include <isis/core/tmpfile.hpp>
+
+#define BOOST_TEST_MODULE "imageIOSftpTest"
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include <set>
+#include <thread>
+#include <netinet/in.h>
+#include <pwd.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace isis::test
+{
+/// an sshd (with its own host key, config and authorized user key) running on loopback for as long as this exists
+class Sshd
+{
+	pid_t m_pid = 0;
+	uint16_t m_port = 0;
+	std::optional<std::string> m_home; // HOME before useAsHome
+	bool m_home_set = false;
+
+	static uint16_t freePort() {
+		const int fd = socket( AF_INET, SOCK_STREAM, 0 );
+		sockaddr_in addr{};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+		socklen_t len = sizeof( addr );
+		bind( fd, reinterpret_cast<sockaddr *>( &addr ), sizeof( addr ) );
+		getsockname( fd, reinterpret_cast<sockaddr *>( &addr ), &len );
+		close( fd );
+		return ntohs( addr.sin_port );
+	}
+	bool listening()const {
+		const int fd = socket( AF_INET, SOCK_STREAM, 0 );
+		sockaddr_in addr{};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+		addr.sin_port = htons( m_port );
+		const bool ret = connect( fd, reinterpret_cast<sockaddr *>( &addr ), sizeof( addr ) ) == 0;
+		close( fd );
+		return ret;
+	}
+public:
+	const std::filesystem::path dir; // serves as HOME of the client as well (the plugin takes the key from ~/.ssh/id_rsa)
+
+	Sshd( const std::filesystem::path &sshd, const std::string &extra_config = "" ):
+		dir( std::filesystem::temp_directory_path() / ( "isis_sftp_test_" + std::to_string( getpid() ) + "_" + std::to_string( freePort() ) ) ) {
+		std::filesystem::create_directories( dir / ".ssh" );
+		const std::string keygen = "ssh-keygen -q -m PEM -t rsa -b 2048 -N '' -f ";
+
+		if( system( ( keygen + ( dir / "host_key" ).native() ).c_str() ) != 0 || system( ( keygen + ( dir / ".ssh" / "id_rsa" ).native() ).c_str() ) != 0 )
+			return;
+
+		std::filesystem::copy_file( dir / ".ssh" / "id_rsa.pub", dir / ".ssh" / "authorized_keys" );
+		m_port = freePort();
+		std::ofstream( dir / "sshd_config" )
+				<< "Port " << m_port << "\nListenAddress 127.0.0.1\n"
+				<< "HostKey " << ( dir / "host_key" ).native() << "\nPidFile " << ( dir / "sshd.pid" ).native() << "\n"
+				<< "AuthorizedKeysFile " << ( dir / ".ssh" / "authorized_keys" ).native() << "\n"
+				<< "StrictModes no\nPasswordAuthentication no\nKbdInteractiveAuthentication no\nUsePAM no\n"
+				<< "Subsystem sftp internal-sftp\n" << extra_config;
+
+		m_pid = fork();
+
+		if( m_pid == 0 ) { // sshd must be started with its absolute path
+			execl( sshd.c_str(), sshd.c_str(), "-D", "-e", "-f", ( dir / "sshd_config" ).c_str(), nullptr );
+			_exit( 127 );
+		}
+
+		for( int i = 0; i < 100 && !listening(); i++ )
+			std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+	}
+	~Sshd() {
+		if( m_home_set ) {
+			if( m_home )
+				setenv( "HOME", m_home->c_str(), 1 );
+			else
+				unsetenv( "HOME" );
+		}
+
+		if( m_pid > 0 ) {
+			kill( m_pid, SIGTERM );
+			waitpid( m_pid, nullptr, 0 );
+		}
+
+		std::filesystem::remove_all( dir );
+	}
+	[[nodiscard]] bool running()const {return m_pid > 0 && listening();}
+	/// point HOME to dir (until this is destroyed), so the plugin uses the key made for this sshd
+	void useAsHome() {
+		if( const char *env = getenv( "HOME" ) )
+			m_home = env;
+
+		m_home_set = true;
+		setenv( "HOME", dir.c_str(), 1 );
+	}
+	[[nodiscard]] std::string url( const std::filesystem::path &path )const {
+		return "sftp://" + std::string( getpwuid( getuid() )->pw_name ) + "@localhost:" + std::to_string( m_port ) + path.native();
+	}
+	/// put files containing their number (and a hidden one, which is to be ignored) into a new directory
+	std::filesystem::path makeFiles( const std::string &name, size_t files )const {
+		const std::filesystem::path ret = dir / name;
+		std::filesystem::create_directory( ret );
+
+		for( size_t i = 0; i < files; i++ )
+			std::ofstream( ret / ( std::to_string( i ) + ".number" ) ) << i;
+
+		std::ofstream( ret / ".hidden.number" ) << 12345;
+		return ret;
+	}
+};
+
+struct Setup {
+	util::TmpFile manifest{".manifest"};
+	std::optional<std::string> previous;
+	Setup() {
+		if( const char *env = getenv( "ISIS_PLUGIN_MANIFEST" ) )
+			previous = env;
+
+		setenv( "ISIS_PLUGIN_MANIFEST", manifest.c_str(), 1 ); // don't touch the users manifest
+		NumberFormat::use( "number" );
+	}
+	~Setup() {
+		if( previous )
+			setenv( "ISIS_PLUGIN_MANIFEST", previous->c_str(), 1 );
+		else
+			unsetenv( "ISIS_PLUGIN_MANIFEST" );
+	}
+};
+BOOST_GLOBAL_FIXTURE( Setup );
+
+// start an sshd and point HOME to it, \returns nullptr if that isn't possible here
+std::unique_ptr<Sshd> startSshd( const std::string &extra_config = "" )
+{
+	if( data::IOFactory::getFileFormatList( {"sftp"} ).empty() ) {
+		BOOST_WARN_MESSAGE( false, "The sftp plugin was not found, cannot test it" );
+		return {};
+	}
+
+	const std::filesystem::path sshd = "/usr/sbin/sshd";
+
+	if( !std::filesystem::exists( sshd ) ) {
+		BOOST_WARN_MESSAGE( false, "There is no sshd, cannot test the sftp plugin" );
+		return {};
+	}
+
+	auto ret = std::make_unique<Sshd>( sshd, extra_config );
+
+	if( !ret->running() ) {
+		BOOST_WARN_MESSAGE( false, "Failed to start sshd, cannot test the sftp plugin" );
+		return {};
+	}
+
+	ret->useAsHome();
+	return ret;
+}
+
+std::set<uint32_t> numbers( const std::list<data::Chunk> &chunks )
+{
+	std::set<uint32_t> ret;
+
+	for( const data::Chunk &ch : chunks )
+		BOOST_CHECK( ret.insert( NumberFormat::number( ch ) ).second ); // every file is only loaded once
+
+	return ret;
+}
+
+BOOST_AUTO_TEST_CASE( sftpFileTest )
+{
+	if( const auto sshd = startSshd() ) {
+		const std::filesystem::path dir = sshd->makeFiles( "single", 10 );
+		const std::list<data::Chunk> chunks = data::IOFactory::loadChunks( std::filesystem::path( sshd->url( dir / "7.number" ) ), {"sftp"} );
+		BOOST_REQUIRE_EQUAL( chunks.size(), 1 );
+		BOOST_CHECK_EQUAL( NumberFormat::number( chunks.front() ), 7 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( sftpDirectoryTest )
+{
+	if( const auto sshd = startSshd() ) {
+		const std::filesystem::path dir = sshd->makeFiles( "series", 50 );
+
+		for( const std::list<util::istring> &dialects : {std::list<util::istring>{}, std::list<util::istring>{"serial"}} ) {
+			const std::set<uint32_t> got = numbers( data::IOFactory::loadChunks( std::filesystem::path( sshd->url( dir ) ), {"sftp"}, dialects ) );
+			BOOST_REQUIRE_EQUAL( got.size(), 50 );
+			BOOST_CHECK_EQUAL( *got.rbegin(), 49 );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( sftpRefusedConnectionsTest )
+{
+	// sshd drops handshakes beyond the first, so some of the additional connections will fail
+	// their files must be fetched by the others
+	if( const auto sshd = startSshd( "MaxStartups 1\n" ) ) {
+		const std::filesystem::path dir = sshd->makeFiles( "refused", 50 );
+		const std::set<uint32_t> got = numbers( data::IOFactory::loadChunks( std::filesystem::path( sshd->url( dir ) ), {"sftp"} ) );
+		BOOST_CHECK_EQUAL( got.size(), 50 );
+	}
+}
+}
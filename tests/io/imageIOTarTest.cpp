@@ -0,0 +1,150 @@
+/*
+ * imageIOTarTest.cpp
+ *
+ * Tests the tar plugin with archives of "number" files.
+ */
+
+#include "numberFormat.hpp"
+#include <isis/core/tmpfile.hpp>
+
+#define BOOST_TEST_MODULE "imageIOTarTest"
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <optional>
+#include <thread>
+
+namespace isis::test
+{
+// a ustar header for a member of the given name (cut to 100 characters), size and type
+std::string tarHeader( const std::string &name, size_t size, char type )
+{
+	std::string ret( 512, '\0' );
+	name.copy( &ret[0], 100 );
+	std::snprintf( &ret[100], 8, "%07o", 0644 ); // mode
+	std::snprintf( &ret[108], 8, "%07o", 0 ); // uid
+	std::snprintf( &ret[116], 8, "%07o", 0 ); // gid
+	std::snprintf( &ret[124], 12, "%011zo", size );
+	std::snprintf( &ret[136], 12, "%011o", 0 ); // mtime
+	ret[156] = type;
+	std::string( "ustar\0" "00", 8 ).copy( &ret[257], 8 );
+
+	std::fill( &ret[148], &ret[156], ' ' ); // the checksum is computed with blanks in its place
+	unsigned sum = 0;
+
+	for( char c : ret )
+		sum += uint8_t( c );
+
+	std::snprintf( &ret[148], 8, "%06o", sum );
+	return ret;
+}
+// the member (header and padded data), members with names longer than 100 characters get a GNU long name entry in front
+std::string tarMember( const std::string &name, const std::string &data, char type = '0' )
+{
+	std::string ret;
+
+	if( name.size() > 100 )
+		ret = tarMember( "././@LongLink", name + '\0', 'L' );
+
+	ret += tarHeader( name, data.size(), type ) + data;
+	ret.resize( ( ret.size() + 511 ) / 512 * 512, '\0' );
+	return ret;
+}
+
+struct Setup {
+	util::TmpFile manifest{".manifest"};
+	std::optional<std::string> previous;
+	Setup() {
+		if( const char *env = getenv( "ISIS_PLUGIN_MANIFEST" ) )
+			previous = env;
+
+		setenv( "ISIS_PLUGIN_MANIFEST", manifest.c_str(), 1 ); // don't touch the users manifest
+		NumberFormat::use( "number" );
+	}
+	~Setup() {
+		if( previous )
+			setenv( "ISIS_PLUGIN_MANIFEST", previous->c_str(), 1 );
+		else
+			unsetenv( "ISIS_PLUGIN_MANIFEST" );
+	}
+};
+BOOST_GLOBAL_FIXTURE( Setup );
+
+BOOST_AUTO_TEST_CASE( tarMemberTest )
+{
+	if( data::IOFactory::getFileFormatList( {"tar"} ).empty() ) {
+		BOOST_WARN_MESSAGE( false, "The tar plugin was not found, cannot test it" );
+		return;
+	}
+
+	// more members than are parsed in parallel, with some which are not loaded in between
+	const std::string long_name = std::string( 120, 'x' ) + "/10.number";
+	std::vector<std::string> names;
+	std::string archive;
+
+	for( size_t i = 0; i < 40; i++ ) {
+		names.push_back( i == 10 ? long_name : std::to_string( i ) + ".number" );
+		archive += tarMember( names.back(), std::to_string( i ) );
+
+		if( i == 5 ) {
+			archive += tarMember( "dir/", "", '5' );
+			archive += tarMember( "empty.number", "" );
+			archive += tarMember( "readme.txt", "99" ); // there is no plugin for txt (even if the member before was a number)
+		}
+	}
+
+	archive += std::string( 1024, '\0' ); // end of archive
+
+	util::TmpFile tar( ".tar" );
+	std::ofstream( tar, std::ios::binary ) << archive;
+
+	const auto check = [&]( const std::list<data::Chunk> &chunks ) {
+		BOOST_REQUIRE_EQUAL( chunks.size(), names.size() );
+		size_t i = 0;
+
+		for( const data::Chunk &ch : chunks ) { // in the order of the archive, with the name of the member as source
+			BOOST_CHECK_EQUAL( NumberFormat::number( ch ), i );
+			BOOST_CHECK_EQUAL( ch.getValueAs<std::string>( "source" ), names[i] );
+			i++;
+		}
+	};
+
+	check( data::IOFactory::loadChunks( std::filesystem::path( tar ) ) ); // mapped and indexed
+	std::filebuf stream;
+	stream.open( tar, std::ios::in | std::ios::binary );
+	check( data::IOFactory::loadChunks( &stream, {"tar"} ) ); // read front to back
+}
+
+BOOST_AUTO_TEST_CASE( tarStreamingTest )
+{
+	if( data::IOFactory::getFileFormatList( {"tar"} ).empty() )
+		return;
+
+	// many more members than are parsed ahead
+	const size_t members = 4 * std::max( 1u, std::thread::hardware_concurrency() ) + 8;
+	std::string archive;
+
+	for( size_t i = 0; i < members; i++ )
+		archive += tarMember( std::to_string( i ) + ".number", std::to_string( i ) );
+
+	archive += std::string( 1024, '\0' );
+	util::TmpFile tar( ".tar" );
+	std::ofstream( tar, std::ios::binary ) << archive;
+
+	// the chunks are handed over one by one while the rest of the archive is still being parsed
+	const size_t parsed_before = NumberFormat::parsed;
+	std::optional<size_t> parsed_at_first;
+	size_t got = 0;
+	const size_t loaded = data::IOFactory::loadChunksInto( std::filesystem::path( tar ), [&]( data::Chunk &&ch ) {
+		if( !parsed_at_first )
+			parsed_at_first = NumberFormat::parsed - parsed_before;
+
+		BOOST_CHECK_EQUAL( NumberFormat::number( ch ), got++ );
+	} );
+
+	BOOST_CHECK_EQUAL( loaded, members );
+	BOOST_CHECK_EQUAL( got, members );
+	BOOST_REQUIRE( parsed_at_first );
+	BOOST_CHECK_LT( *parsed_at_first, members );
+}
+}
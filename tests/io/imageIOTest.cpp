@@ -11,12 +11,70 @@
 #include <isis/core/image.hpp>
 #include <isis/core/io_factory.hpp>
 #include <isis/core/log.hpp>
+#include <isis/core/tmpfile.hpp>
+#include <fstream>
+#include <optional>
 
 namespace isis
 {
 namespace test
 {
 
+// the manifest is only read/written when the IOFactory is created, so it is set up before any test runs
+struct ManifestSetup {
+	static inline std::filesystem::path manifest;
+	util::TmpFile file{".manifest"};
+	std::optional<std::string> previous;
+	ManifestSetup() {
+		if( const char *env = getenv( "ISIS_PLUGIN_MANIFEST" ) )
+			previous = env;
+
+		manifest = file;
+		setenv( "ISIS_PLUGIN_MANIFEST", file.c_str(), 1 ); // don't touch the users manifest
+	}
+	~ManifestSetup() {
+		if( previous )
+			setenv( "ISIS_PLUGIN_MANIFEST", previous->c_str(), 1 );
+		else
+			unsetenv( "ISIS_PLUGIN_MANIFEST" );
+	}
+};
+BOOST_GLOBAL_FIXTURE( ManifestSetup );
+
+BOOST_AUTO_TEST_CASE ( pluginManifestTest )
+{
+	const std::filesystem::path &manifest = ManifestSetup::manifest;
+
+	const data::IOFactory::FileFormatList formats = data::IOFactory::getFormats();
+	if( formats.empty() ) {
+		BOOST_WARN_MESSAGE( false, "No plugins found, cannot test the plugin manifest" );
+		return;
+	}
+
+	// all found plugins must be described in the manifest
+	BOOST_REQUIRE( std::filesystem::exists( manifest ) );
+	std::ifstream in( manifest );
+	std::string line;
+	std::getline( in, line );
+	BOOST_CHECK_EQUAL( line, "#isis plugin manifest 2" );
+
+	size_t records = 0;
+	while( std::getline( in, line ) ) {
+		records++;
+		BOOST_CHECK( std::find_if( formats.begin(), formats.end(), [&line]( const data::IOFactory::FileFormatPtr &f ) {
+			return line.find( f->plugin_file.native() + '\t' ) == 0 && line.find( '\t' + f->getName() + '\t' ) != std::string::npos &&
+				   line.ends_with( f->readsFiles() ? "\t1" : "\t0" ); // must be known without opening the plugin
+		} ) != formats.end() );
+	}
+	BOOST_CHECK_EQUAL( records, formats.size() );
+
+	// the registered plugins must still be usable
+	for( const data::IOFactory::FileFormatPtr &f : formats ) {
+		BOOST_CHECK( !f->getName().empty() );
+		BOOST_CHECK( !f->getSuffixes().empty() );
+	}
+}
+
 BOOST_AUTO_TEST_CASE ( imageNameGenTest )
 {
 	data::MemChunk<uint8_t> ch( 5, 5, 5 );
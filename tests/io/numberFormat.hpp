@@ -0,0 +1,51 @@
+/*
+ * numberFormat.hpp
+ *
+ * A file format for testing the proxy plugins (archives, remote access) without any actual image data.
+ */
+
+#pragma once
+
+#include <isis/core/io_interface.h>
+#include <isis/core/io_factory.hpp>
+#include <atomic>
+#include <charconv>
+
+namespace isis::test
+{
+/**
+ * Reads files containing nothing but a number (as text) into a chunk with a single voxel of that value.
+ * So tests can tell which file ended up where.
+ */
+class NumberFormat: public image_io::FileFormat
+{
+	const util::istring m_suffix;
+protected:
+	std::list<util::istring> suffixes( io_modes /*modes*/ )const override {return {m_suffix};}
+public:
+	static inline std::atomic<size_t> parsed{0}; // amount of files loaded so far
+
+	explicit NumberFormat( util::istring suffix ): m_suffix( std::move( suffix ) ) {}
+	std::string getName()const override {return "number test format";}
+	std::list<data::Chunk> load( data::ByteArray source, std::list<util::istring> /*formatstack*/, std::list<util::istring> /*dialects*/, std::shared_ptr<util::ProgressFeedback> /*feedback*/ )override {
+		data::MemChunk<uint32_t> ret( 1, 1 );
+		const char *const text = static_cast<const char *>( source.getRawAddress().get() );
+
+		if( std::from_chars( text, text + source.getLength(), ret.voxel<uint32_t>( 0, 0 ) ).ptr != text + source.getLength() )
+			throwGenericError( "not a number" );
+
+		parsed++;
+		return {ret};
+	}
+	void write( const data::Image &/*image*/, const std::string &/*filename*/, std::list<util::istring> /*dialects*/, std::shared_ptr<util::ProgressFeedback> /*feedback*/ )override {
+		throwGenericError( "not implemented" );
+	}
+
+	/// register a NumberFormat for the given suffix, in front of all other plugins for that suffix
+	static void use( const util::istring &suffix ) {
+		data::IOFactory::registerFileFormat( std::make_shared<NumberFormat>( suffix ), true );
+	}
+	/// get the number a chunk was loaded from
+	static uint32_t number( const data::Chunk &ch ) {return ch.voxel<uint32_t>( 0, 0 );}
+};
+}
@@ -0,0 +1,166 @@
+#define BOOST_TEST_MODULE FilterTest
+#define NOMINMAX 1
+
+#include <boost/test/unit_test.hpp>
+#include <isis/math/filter.hpp>
+
+namespace isis::test
+{
+
+template<typename T> data::MemChunk<T> makeChunk( size_t xsize, size_t ysize, size_t zsize, size_t tsize = 1 )
+{
+	data::MemChunk<T> ch( xsize, ysize, zsize, tsize );
+	ch.setValueAs( "indexOrigin", util::fvector3( {0, 0, 0} ) );
+	ch.setValueAs( "rowVec", util::fvector3( {1, 0, 0} ) );
+	ch.setValueAs( "columnVec", util::fvector3( {0, 1, 0} ) );
+	ch.setValueAs( "sliceVec", util::fvector3( {0, 0, 1} ) );
+	ch.setValueAs( "voxelSize", util::fvector3( {2, 2, 2} ) );
+	ch.setValueAs( "acquisitionNumber", 0 );
+	ch.setValueAs( "sequenceNumber", 1 );
+	return ch;
+}
+
+template<typename T> data::Image makeImage( size_t xsize, size_t ysize, size_t zsize, size_t tsize = 1 )
+{
+	data::MemChunk<T> ch = makeChunk<T>( xsize, ysize, zsize, tsize );
+	ch.foreachVoxel( []( T &vox, const util::vector4<size_t> &pos ) {vox = ( pos[0] * 7 + pos[1] * 13 + pos[2] * 29 + pos[3] * 3 ) % 50;} );
+	return data::Image( ch );
+}
+
+/// straight forward convolution with repeated borders
+template<typename T> double convolved( const data::Image &img, data::dimensions dim, const math::Kernel &kernel, util::vector4<size_t> pos )
+{
+	const ptrdiff_t radius = kernel.size() / 2, center = pos[dim], length = img.getDimSize( dim );
+	double ret = 0;
+
+	for( ptrdiff_t j = -radius; j <= radius; j++ ) {
+		pos[dim] = std::clamp<ptrdiff_t>( center - j, 0, length - 1 );
+		ret += kernel[j + radius] * img.voxel<T>( pos[0], pos[1], pos[2], pos[3] );
+	}
+
+	return ret;
+}
+
+BOOST_AUTO_TEST_CASE( kernel_test )
+{
+	const math::Kernel gauss = math::gaussianKernel( 1.5 );
+	BOOST_REQUIRE_EQUAL( gauss.size(), 13 );
+	BOOST_CHECK_CLOSE( std::accumulate( gauss.begin(), gauss.end(), 0. ), 1, 1e-8 );
+
+	for( size_t i = 0; i < 6; i++ ) {
+		BOOST_CHECK_EQUAL( gauss[i], gauss[12 - i] );
+		BOOST_CHECK_LT( gauss[i], gauss[i + 1] );
+	}
+
+	BOOST_CHECK( math::boxKernel( 5 ) == math::Kernel( 5, 0.2 ) );
+	BOOST_CHECK_CLOSE( math::fwhm2sigma( 2.3548200450309493 ), 1, 1e-8 );
+}
+
+BOOST_AUTO_TEST_CASE( convolve_test )
+{
+	const math::Kernel kernel{0.5, 0.3, 0.1, 0.1, 0};
+
+	for( int dim = data::rowDim; dim <= data::timeDim; dim++ ) {
+		const data::Image src = makeImage<float>( 9, 7, 5, 4 );
+		data::Image dst = src.copyByID( util::typeID<float>() );
+		math::convolve( dst, data::dimensions( dim ), kernel );
+
+		for( size_t t = 0; t < 4; t++ )
+			for( size_t z = 0; z < 5; z++ )
+				for( size_t y = 0; y < 7; y++ )
+					for( size_t x = 0; x < 9; x++ )
+						BOOST_REQUIRE_CLOSE( dst.voxel<float>( x, y, z, t ), convolved<float>( src, data::dimensions( dim ), kernel, {x, y, z, t} ), 1e-3 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( convolve_int_test )
+{
+	data::Image img = makeImage<uint8_t>( 10, 4, 3 );
+	img.voxel<uint8_t>( 2, 1, 1 ) = 200;
+	const data::Image src = img.copyByID( util::typeID<uint8_t>() );
+
+	math::convolve( img, data::columnDim, {0, 3, 0} ); // the result is clamped to the range of uint8_t
+	math::convolve( img, data::rowDim, math::boxKernel( 3 ) ); // and rounded
+
+	BOOST_CHECK( img.getMajorTypeID() == util::typeID<uint8_t>() );
+
+	for( size_t z = 0; z < 3; z++ )
+		for( size_t y = 0; y < 4; y++ )
+			for( size_t x = 0; x < 10; x++ ) {
+				double sum = 0;
+
+				for( size_t nx : {std::max<size_t>( x, 1 ) - 1, x, std::min<size_t>( x + 1, 9 )} )
+					sum += std::min( src.voxel<uint8_t>( nx, y, z ) * 3, 255 );
+
+				BOOST_REQUIRE_EQUAL( img.voxel<uint8_t>( x, y, z ), std::round( sum / 3 ) );
+			}
+
+	// 32bit integers are filtered in double, float would lose the lower bits
+	data::Image big = makeImage<int32_t>( 5, 5, 5 );
+	for( data::Image::reference ref : big )
+		ref = int32_t( 100000001 );
+
+	math::convolve( big, data::sliceDim, math::boxKernel( 3 ) );
+	BOOST_CHECK_EQUAL( big.voxel<int32_t>( 2, 2, 2 ), 100000001 );
+
+	data::Image vectors( makeChunk<util::fvector3>( 4, 4, 4 ) );
+	BOOST_CHECK_THROW( math::convolve( vectors, data::rowDim, math::boxKernel( 3 ) ), std::domain_error );
+}
+
+BOOST_AUTO_TEST_CASE( recursive_gaussian_test )
+{
+	// the response to an impulse should be close to the sampled gaussian
+	const double sigma = 6;
+	data::Image img = makeImage<double>( 3, 101, 2 );
+	for( data::Image::reference ref : img )
+		ref = 0.;
+	img.voxel<double>( 1, 50, 1 ) = 1;
+
+	math::recursiveGaussian( img, data::columnDim, sigma );
+	const math::Kernel expected = math::gaussianKernel( sigma );
+	const size_t radius = expected.size() / 2;
+
+	for( size_t y = 50 - radius; y <= 50 + radius; y++ ) {
+		BOOST_REQUIRE_SMALL( img.voxel<double>( 1, y, 1 ) - expected[y + radius - 50], expected[radius] / 25 ); // the approximation is good to a few percent
+		BOOST_REQUIRE_EQUAL( img.voxel<double>( 1, y, 0 ), 0 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( gaussian_test )
+{
+	// a constant image stays constant
+	data::Image constant = makeImage<int16_t>( 20, 20, 20 );
+	for( data::Image::reference ref : constant )
+		ref = int16_t( 1000 );
+
+	math::gaussian( constant, {3, 3, 3}, false, math::gauss_method::fir );
+	math::gaussian( constant, {6, 6, 6}, false, math::gauss_method::recursive );
+
+	for( size_t z = 0; z < 20; z++ )
+		for( size_t y = 0; y < 20; y++ )
+			for( size_t x = 0; x < 20; x++ )
+				BOOST_REQUIRE_EQUAL( constant.voxel<int16_t>( x, y, z ), 1000 );
+
+	// sigma in mm is divided by the voxelSize (2mm)
+	const data::Image src = makeImage<float>( 16, 12, 10 );
+	data::Image in_mm = src.copyByID( util::typeID<float>() ), in_voxels = src.copyByID( util::typeID<float>() );
+	math::gaussian( in_mm, {2, 3, 4} );
+	math::convolve( in_voxels, {math::gaussianKernel( 1 ), math::gaussianKernel( 1.5 ), math::gaussianKernel( 2 )} );
+
+	for( size_t z = 0; z < 10; z++ )
+		for( size_t y = 0; y < 12; y++ )
+			for( size_t x = 0; x < 16; x++ )
+				BOOST_REQUIRE_CLOSE( in_mm.voxel<float>( x, y, z ), in_voxels.voxel<float>( x, y, z ), 1e-3 );
+
+	// with a voxelGap (1mm) the distance of the voxels is 3mm
+	data::Image gapped = src.copyByID( util::typeID<float>() );
+	gapped.setValueAs( "voxelGap", util::fvector3( {1, 1, 1} ) );
+	math::gaussian( gapped, {3, 4.5, 6} );
+
+	for( size_t z = 0; z < 10; z++ )
+		for( size_t y = 0; y < 12; y++ )
+			for( size_t x = 0; x < 16; x++ )
+				BOOST_REQUIRE_CLOSE( gapped.voxel<float>( x, y, z ), in_voxels.voxel<float>( x, y, z ), 1e-3 );
+}
+
+}
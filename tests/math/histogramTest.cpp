@@ -0,0 +1,108 @@
+#define BOOST_TEST_MODULE HistogramTest
+#define NOMINMAX 1
+
+#include <boost/test/unit_test.hpp>
+#include <isis/math/binarise.hpp>
+
+namespace isis::test
+{
+
+template<typename T> data::MemChunk<T> makeChunk( size_t xsize, size_t ysize, size_t zsize, const std::function<T( size_t )> &fill )
+{
+	data::MemChunk<T> ch( xsize, ysize, zsize );
+	ch.setValueAs( "indexOrigin", util::fvector3( {0, 0, 0} ) );
+	ch.setValueAs( "rowVec", util::fvector3( {1, 0, 0} ) );
+	ch.setValueAs( "columnVec", util::fvector3( {0, 1, 0} ) );
+	ch.setValueAs( "sliceVec", util::fvector3( {0, 0, 1} ) );
+	ch.setValueAs( "voxelSize", util::fvector3( {1, 1, 1} ) );
+	ch.setValueAs( "acquisitionNumber", 0 );
+	ch.setValueAs( "sequenceNumber", 1 );
+
+	for( size_t i = 0; i < ch.getVolume(); i++ )
+		ch.template beginTyped<T>()[i] = fill( i );
+
+	return ch;
+}
+
+BOOST_AUTO_TEST_CASE( histogram_integer_test )
+{
+	// one bin per value by default
+	const auto ch = makeChunk<int16_t>( 100, 10, 3, []( size_t i ) {return int16_t( i % 7 ) - 3;} );
+	const math::Histogram hist = math::histogram( ch );
+
+	BOOST_REQUIRE_EQUAL( hist.bins.size(), 7 );
+	BOOST_CHECK_EQUAL( hist.total(), ch.getVolume() );
+
+	for( size_t i = 0; i < 7; i++ ) {
+		BOOST_CHECK_CLOSE( hist.binCenter( i ), double( i ) - 3, 1e-9 );
+		BOOST_CHECK_EQUAL( hist.bins[i], 3000 / 7 + ( i < 3000 % 7 ? 1 : 0 ) );
+	}
+
+	// the old per-value histogram still works for small integers
+	const std::vector<size_t> full = math::histogram( ch.beginTyped<int16_t>(), ch.endTyped<int16_t>() );
+	BOOST_REQUIRE_EQUAL( full.size(), 65536 );
+	BOOST_CHECK_EQUAL( full[32768 - 3], hist.bins[0] );
+
+	// a given range and bin count drop values outside of the range
+	const math::Histogram ranged = math::histogram( ch, 2, std::pair<double, double>( 0, 2 ) );
+	BOOST_REQUIRE_EQUAL( ranged.bins.size(), 2 );
+	BOOST_CHECK_EQUAL( ranged.bins[0], hist.bins[3] );
+	BOOST_CHECK_EQUAL( ranged.bins[1], hist.bins[4] + hist.bins[5] ); // 2 is the upper bound and goes into the last bin
+}
+
+BOOST_AUTO_TEST_CASE( histogram_float_test )
+{
+	// more than one block, so several threads count
+	auto ch = makeChunk<float>( 256, 256, 40, []( size_t i ) {return float( i % 1000 ) / 1000;} );
+	ch.beginTyped<float>()[5] = std::numeric_limits<float>::quiet_NaN();
+	const math::Histogram hist = math::histogram( ch, 10, std::pair<double, double>( 0, 1 ) );
+
+	BOOST_REQUIRE_EQUAL( hist.bins.size(), 10 );
+	BOOST_CHECK_EQUAL( hist.total(), ch.getVolume() - 1 );
+	const size_t cycles = ch.getVolume() / 1000, rest = ch.getVolume() % 1000; // 100 values of every 1000 fall into each bin
+	BOOST_CHECK_EQUAL( hist.bins[1], cycles * 100 + std::clamp<size_t>( rest, 100, 200 ) - 100 );
+	BOOST_CHECK_EQUAL( hist.bins[0], cycles * 100 + std::min<size_t>( rest, 100 ) - 1 ); // minus the NaN
+}
+
+BOOST_AUTO_TEST_CASE( histogram_image_mask_test )
+{
+	std::vector<data::Chunk> chunks, masks;
+
+	for( uint32_t s = 0; s < 4; s++ ) {
+		auto ch = makeChunk<uint32_t>( 8, 8, 1, [s]( size_t i ) {return i + s * 1000;} );
+		auto mask = makeChunk<uint8_t>( 8, 8, 1, []( size_t i ) {return i < 10;} );
+		ch.setValueAs( "indexOrigin", util::fvector3( {0, 0, float( s )} ) );
+		mask.setValueAs( "indexOrigin", util::fvector3( {0, 0, float( s )} ) );
+		ch.setValueAs( "acquisitionNumber", s );
+		mask.setValueAs( "acquisitionNumber", s );
+		chunks.push_back( ch );
+		masks.push_back( mask );
+	}
+
+	const data::Image img( chunks ), mask( masks );
+	const math::Histogram hist = math::histogram( img );
+	BOOST_CHECK_EQUAL( hist.bins.size(), 3064 );
+	BOOST_CHECK_EQUAL( hist.total(), 8 * 8 * 4 );
+
+	const math::Histogram masked = math::histogram( img, mask, 4 );
+	BOOST_CHECK_EQUAL( masked.total(), 4 * 10 );
+
+	for( size_t b = 0; b < 4; b++ )
+		BOOST_CHECK_EQUAL( masked.bins[b], 10 );
+}
+
+BOOST_AUTO_TEST_CASE( otsu_test )
+{
+	// two well separated classes
+	const auto ints = makeChunk<uint16_t>( 64, 64, 2, []( size_t i ) {return i % 2 ? 1000 + i % 50 : 100 + i % 30;} );
+	const uint16_t ithres = math::otsu_thres( data::TypedChunk<uint16_t>( ints ) );
+	BOOST_CHECK_GE( ithres, 129 );
+	BOOST_CHECK_LT( ithres, 1000 );
+
+	const auto floats = makeChunk<double>( 64, 64, 2, []( size_t i ) {return i % 2 ? 5 + ( i % 50 ) / 100. : -5 + ( i % 30 ) / 100.;} );
+	const double fthres = math::otsu_thres( floats );
+	BOOST_CHECK_GE( fthres, -4.8 );
+	BOOST_CHECK_LT( fthres, 5 );
+}
+
+}
@@ -0,0 +1,205 @@
+#define BOOST_TEST_MODULE MorphologyTest
+#define NOMINMAX 1
+
+#include <boost/test/unit_test.hpp>
+#include <isis/math/morphology.hpp>
+#include <random>
+#include <deque>
+
+namespace isis::test
+{
+
+template<typename T> data::MemChunk<T> makeChunk( size_t xsize, size_t ysize, size_t zsize, size_t tsize = 1 )
+{
+	data::MemChunk<T> ch( xsize, ysize, zsize, tsize );
+	ch.setValueAs( "indexOrigin", util::fvector3( {-10, 0, 5} ) );
+	ch.setValueAs( "rowVec", util::fvector3( {1, 0, 0} ) );
+	ch.setValueAs( "columnVec", util::fvector3( {0, 1, 0} ) );
+	ch.setValueAs( "sliceVec", util::fvector3( {0, 0, 1} ) );
+	ch.setValueAs( "voxelSize", util::fvector3( {2, 2, 3} ) );
+	ch.setValueAs( "acquisitionNumber", 0 );
+	ch.setValueAs( "sequenceNumber", 1 );
+	return ch;
+}
+
+/// a mask of the given size, set where the function returns true
+template<typename T = uint8_t, typename F> data::Image makeMask( util::vector4<size_t> size, F &&func )
+{
+	data::MemChunk<T> ch = makeChunk<T>( size[0], size[1], size[2], size[3] );
+	ch.foreachVoxel( [&]( T &vox, const util::vector4<size_t> &pos ) {vox = func( pos );} );
+	return data::Image( ch );
+}
+
+size_t countVoxels( const data::Image &img )
+{
+	const data::TypedImage<uint8_t> voxels( img );
+	size_t ret = 0;
+
+	for( size_t i = 0; i < voxels.getVolume(); i++ ) {
+		const std::array<size_t, 4> pos = voxels.getCoordsFromLinIndex( i );
+		ret += voxels.voxel<uint8_t>( pos[0], pos[1], pos[2], pos[3] ) != 0;
+	}
+
+	return ret;
+}
+
+/// straight forward flood fill labelling in memory order
+std::vector<uint32_t> referenceLabels( const data::Image &mask, math::connectivity conn, bool across_time )
+{
+	const util::vector4<size_t> size = mask.getSizeAsVector();
+	std::vector<uint32_t> ret( mask.getVolume(), 0 );
+	uint32_t next = 1;
+
+	for( size_t start = 0; start < ret.size(); start++ ) {
+		if( ret[start] || mask.voxel<uint8_t>( start % size[0], start / size[0] % size[1], start / size[0] / size[1] % size[2], start / size[0] / size[1] / size[2] ) == 0 )
+			continue;
+
+		std::deque<size_t> queue{start};
+		ret[start] = next;
+
+		while( !queue.empty() ) {
+			const std::array<size_t, 4> pos = mask.getCoordsFromLinIndex( queue.front() );
+			queue.pop_front();
+
+			for( int dt = -1; dt <= 1; dt++ )
+				for( int dz = -1; dz <= 1; dz++ )
+					for( int dy = -1; dy <= 1; dy++ )
+						for( int dx = -1; dx <= 1; dx++ ) {
+							const int distance = std::abs( dx ) + std::abs( dy ) + std::abs( dz );
+
+							if( dt && ( !across_time || distance ) )
+								continue;
+							if( conn == math::connectivity::faces && distance > 1 )
+								continue;
+							if( conn == math::connectivity::edges && distance > 2 )
+								continue;
+
+							const std::array<ptrdiff_t, 4> n{ptrdiff_t( pos[0] ) + dx, ptrdiff_t( pos[1] ) + dy, ptrdiff_t( pos[2] ) + dz, ptrdiff_t( pos[3] ) + dt};
+							bool inside = true;
+
+							for( int d = 0; d < 4; d++ )
+								inside &= n[d] >= 0 && n[d] < ptrdiff_t( size[d] );
+
+							if( !inside || mask.voxel<uint8_t>( n[0], n[1], n[2], n[3] ) == 0 )
+								continue;
+
+							const size_t idx = mask.getLinearIndex( {size_t( n[0] ), size_t( n[1] ), size_t( n[2] ), size_t( n[3] )} );
+
+							if( !ret[idx] ) {
+								ret[idx] = next;
+								queue.push_back( idx );
+							}
+						}
+		}
+
+		next++;
+	}
+
+	return ret;
+}
+
+BOOST_AUTO_TEST_CASE( label_test )
+{
+	std::mt19937 gen( 42 );
+	std::bernoulli_distribution dist( 0.3 );
+	const data::Image mask = makeMask( {17, 13, 24, 3}, [&]( const util::vector4<size_t> & ) {return dist( gen );} );
+
+	for( const auto conn : {math::connectivity::faces, math::connectivity::edges, math::connectivity::corners} )
+		for( bool across_time : {false, true} ) {
+			const data::TypedImage<uint32_t> labels = math::label( mask, conn, across_time );
+			const std::vector<uint32_t> expected = referenceLabels( mask, conn, across_time );
+
+			BOOST_REQUIRE_EQUAL( labels.getSizeAsVector(), mask.getSizeAsVector() );
+
+			for( size_t i = 0; i < expected.size(); i++ ) {
+				const std::array<size_t, 4> pos = mask.getCoordsFromLinIndex( i );
+				BOOST_REQUIRE_EQUAL( labels.voxel<uint32_t>( pos[0], pos[1], pos[2], pos[3] ), expected[i] );
+			}
+		}
+}
+
+BOOST_AUTO_TEST_CASE( cluster_stats_test )
+{
+	// a 2x3x4 box and a single voxel touching its corner
+	const data::Image mask = makeMask<bool>( {10, 10, 10, 1}, []( const util::vector4<size_t> &pos ) {
+		return ( pos[0] >= 2 && pos[0] < 4 && pos[1] >= 3 && pos[1] < 6 && pos[2] >= 4 && pos[2] < 8 ) || pos == util::vector4<size_t>{4, 6, 8, 0};
+	} );
+
+	const std::vector<math::Cluster> separated = math::clusterStats( math::label( mask, math::connectivity::faces ) );
+	BOOST_REQUIRE_EQUAL( separated.size(), 2 );
+	BOOST_CHECK_EQUAL( separated[0].label, 1 );
+	BOOST_CHECK_EQUAL( separated[0].voxels, 24 );
+	BOOST_CHECK_EQUAL( separated[0].centroid, ( util::dvector4{2.5, 4, 5.5, 0} ) );
+	BOOST_CHECK_EQUAL( separated[0].physical_centroid, ( util::fvector3{-5, 8, 21.5} ) );
+	BOOST_CHECK_EQUAL( separated[1].voxels, 1 );
+	BOOST_CHECK_EQUAL( separated[1].centroid, ( util::dvector4{4, 6, 8, 0} ) );
+
+	const std::vector<math::Cluster> joined = math::clusterStats( math::label( mask, math::connectivity::corners ) );
+	BOOST_REQUIRE_EQUAL( joined.size(), 1 );
+	BOOST_CHECK_EQUAL( joined[0].voxels, 25 );
+}
+
+BOOST_AUTO_TEST_CASE( dilate_erode_test )
+{
+	const data::Image dot = makeMask<bool>( {9, 9, 9, 1}, []( const util::vector4<size_t> &pos ) {return pos == util::vector4<size_t>{4, 4, 4, 0};} );
+
+	BOOST_CHECK_EQUAL( countVoxels( math::dilate( dot, 1, math::connectivity::faces ) ), 7 );
+	BOOST_CHECK_EQUAL( countVoxels( math::dilate( dot, 1, math::connectivity::edges ) ), 19 );
+	BOOST_CHECK_EQUAL( countVoxels( math::dilate( dot, 1, math::connectivity::corners ) ), 27 );
+	BOOST_CHECK_EQUAL( countVoxels( math::dilate( dot, 2, math::connectivity::faces ) ), 25 );
+
+	const data::Image cube = math::dilate( dot, 2, math::connectivity::corners );
+	BOOST_CHECK( cube.getMajorTypeID() == util::typeID<bool>() );
+	BOOST_CHECK_EQUAL( countVoxels( cube ), 125 );
+
+	const data::Image eroded = math::erode( cube, 1, math::connectivity::corners );
+	BOOST_CHECK_EQUAL( countVoxels( eroded ), 27 );
+	BOOST_CHECK( eroded.voxel<bool>( 3, 3, 3 ) && eroded.voxel<bool>( 5, 5, 5 ) && !eroded.voxel<bool>( 6, 5, 5 ) );
+
+	// voxels outside are background
+	const data::Image full = makeMask( {6, 6, 6, 1}, []( const util::vector4<size_t> & ) {return true;} );
+	BOOST_CHECK_EQUAL( countVoxels( math::erode( full, 1 ) ), 64 );
+
+	// 2D images are handled as such
+	const data::Image square = makeMask( {8, 8, 1, 1}, []( const util::vector4<size_t> &pos ) {return pos[0] > 1 && pos[0] < 6 && pos[1] > 1 && pos[1] < 6;} );
+	BOOST_CHECK_EQUAL( countVoxels( math::erode( square, 1, math::connectivity::corners ) ), 4 );
+	BOOST_CHECK_EQUAL( countVoxels( math::dilate( square, 1, math::connectivity::corners ) ), 36 );
+}
+
+BOOST_AUTO_TEST_CASE( open_close_fill_test )
+{
+	// two bars in a single slice with a gap of one voxel in between and a single voxel of noise
+	const data::Image bars = makeMask( {12, 5, 1, 1}, []( const util::vector4<size_t> &pos ) {
+		return ( pos[0] >= 2 && pos[0] <= 9 && pos[0] != 6 && pos[1] >= 1 && pos[1] <= 3 ) || ( pos[0] == 11 && pos[1] == 4 );
+	} );
+	const data::Image closed = math::close( bars, 1, math::connectivity::corners );
+	BOOST_CHECK_EQUAL( closed.voxel<uint8_t>( 6, 2, 0 ), 1 );
+	BOOST_CHECK_EQUAL( countVoxels( closed ), 24 );
+
+	const data::Image opened = math::open( bars, 1, math::connectivity::corners );
+	BOOST_CHECK_EQUAL( opened.voxel<uint8_t>( 11, 4, 0 ), 0 );
+	BOOST_CHECK_EQUAL( countVoxels( opened ), 21 );
+
+	// a hollow cube in each of two volumes
+	const data::Image hollow = makeMask( {7, 7, 7, 2}, []( const util::vector4<size_t> &pos ) {
+		bool shell = true, inside = true;
+
+		for( int d = 0; d < 3; d++ ) {
+			shell &= pos[d] >= 1 && pos[d] <= 5;
+			inside &= pos[d] >= 2 && pos[d] <= 4;
+		}
+
+		return shell && !inside;
+	} );
+	const data::Image filled = math::fillHoles( hollow );
+	BOOST_CHECK_EQUAL( countVoxels( hollow ), 2 * ( 125 - 27 ) );
+	BOOST_CHECK_EQUAL( countVoxels( filled ), 2 * 125 );
+
+	// a ring in a single slice
+	const data::Image ring = makeMask( {5, 5, 1, 1}, []( const util::vector4<size_t> &pos ) {return pos[0] != 2 || pos[1] != 2;} );
+	BOOST_CHECK_EQUAL( countVoxels( math::fillHoles( ring ) ), 25 );
+
+	BOOST_CHECK_THROW( math::dilate( data::Image( makeChunk<std::complex<float>>( 4, 4, 4 ) ) ), std::domain_error );
+}
+
+}
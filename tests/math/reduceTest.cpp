@@ -0,0 +1,89 @@
+#define BOOST_TEST_MODULE ReduceTest
+#define NOMINMAX 1
+
+#include <boost/test/unit_test.hpp>
+#include <isis/math/reduce.hpp>
+
+namespace isis::test
+{
+
+// an image of int16 slices with value = x + y*10 + z*100 + t*1000
+data::Image makeImage( size_t xsize, size_t ysize, size_t zsize, size_t tsize )
+{
+	std::list<data::Chunk> chunks;
+
+	for( size_t t = 0; t < tsize; t++ )
+		for( size_t z = 0; z < zsize; z++ ) {
+			data::MemChunk<int16_t> ch( xsize, ysize );
+			ch.setValueAs( "indexOrigin", util::fvector3( {0, 0, float( z )} ) );
+			ch.setValueAs( "rowVec", util::fvector3( {1, 0, 0} ) );
+			ch.setValueAs( "columnVec", util::fvector3( {0, 1, 0} ) );
+			ch.setValueAs( "sliceVec", util::fvector3( {0, 0, 1} ) );
+			ch.setValueAs( "voxelSize", util::fvector3( {1, 1, 1} ) );
+			ch.setValueAs( "acquisitionNumber", uint32_t( t * zsize + z ) );
+			ch.setValueAs( "sequenceNumber", uint16_t( 1 ) );
+
+			for( size_t y = 0; y < ysize; y++ )
+				for( size_t x = 0; x < xsize; x++ )
+					ch.voxel<int16_t>( x, y ) = x + y * 10 + z * 100 + t * 1000;
+
+			chunks.push_back( ch );
+		}
+
+	return data::Image( chunks );
+}
+
+BOOST_AUTO_TEST_CASE( reduce_time_test )
+{
+	const data::Image src = makeImage( 70, 65, 3, 5 ); // more voxels per volume than one tile
+	BOOST_REQUIRE_EQUAL( src.getSizeAsVector(), ( util::vector4<size_t>{70, 65, 3, 5} ) );
+
+	const data::Image mean = math::reduce( src, data::timeDim, math::reduction::mean );
+	const data::Image std = math::reduce( src, data::timeDim, math::reduction::stddev );
+	const data::Image max = math::reduce( src, data::timeDim, math::reduction::max );
+	const data::Image median = math::reduce( src, data::timeDim, math::reduction::median );
+	const data::Image p25 = math::reduce( src, data::timeDim, math::reduction::percentile, 25 );
+	const data::Image p10 = math::reduce( src, data::timeDim, math::reduction::percentile, 10 );
+	BOOST_REQUIRE_EQUAL( mean.getSizeAsVector(), ( util::vector4<size_t>{70, 65, 3, 1} ) );
+	BOOST_CHECK( mean.getMajorTypeID() == util::typeID<float>() );
+
+	for( size_t z = 0; z < 3; z++ )
+		for( size_t y = 0; y < 65; y++ )
+			for( size_t x = 0; x < 70; x++ ) {
+				const float base = x + y * 10 + z * 100;
+				BOOST_CHECK_CLOSE( mean.voxel<float>( x, y, z ), base + 2000, 1e-4 );
+				BOOST_CHECK_CLOSE( std.voxel<float>( x, y, z ), std::sqrt( 2.f ) * 1000, 1e-4 ); // population std of 0,1000..4000
+				BOOST_CHECK_EQUAL( max.voxel<float>( x, y, z ), base + 4000 );
+				BOOST_CHECK_EQUAL( median.voxel<float>( x, y, z ), base + 2000 );
+				BOOST_CHECK_EQUAL( p25.voxel<float>( x, y, z ), base + 1000 );
+				BOOST_CHECK_CLOSE( p10.voxel<float>( x, y, z ), base + 400, 1e-4 ); // interpolated between the first two
+			}
+}
+
+BOOST_AUTO_TEST_CASE( reduce_spatial_test )
+{
+	const data::Image src = makeImage( 4, 3, 5, 2 );
+
+	const data::Image sum = math::reduce( src, data::sliceDim, math::reduction::sum );
+	const data::Image min = math::reduce( src, data::rowDim, math::reduction::min );
+	const data::Image var = math::reduce( src, data::columnDim, math::reduction::variance );
+	BOOST_REQUIRE_EQUAL( sum.getSizeAsVector(), ( util::vector4<size_t>{4, 3, 1, 2} ) );
+	BOOST_REQUIRE_EQUAL( min.getSizeAsVector(), ( util::vector4<size_t>{1, 3, 5, 2} ) );
+	BOOST_REQUIRE_EQUAL( var.getSizeAsVector(), ( util::vector4<size_t>{4, 1, 5, 2} ) );
+
+	for( size_t t = 0; t < 2; t++ )
+		for( size_t y = 0; y < 3; y++ )
+			for( size_t x = 0; x < 4; x++ )
+				BOOST_CHECK_EQUAL( sum.voxel<float>( x, y, 0, t ), 5 * ( x + y * 10 + t * 1000 ) + 1000 );
+
+	for( size_t t = 0; t < 2; t++ )
+		for( size_t z = 0; z < 5; z++ ) {
+			for( size_t y = 0; y < 3; y++ )
+				BOOST_CHECK_EQUAL( min.voxel<float>( 0, y, z, t ), y * 10 + z * 100 + t * 1000 );
+
+			for( size_t x = 0; x < 4; x++ )
+				BOOST_CHECK_CLOSE( var.voxel<float>( x, 0, z, t ), 200.f / 3, 1e-4 ); // of 0,10,20
+		}
+}
+
+}
@@ -0,0 +1,134 @@
+#define BOOST_TEST_MODULE ResampleTest
+#define NOMINMAX 1
+
+#include <boost/test/unit_test.hpp>
+#include <isis/math/resample.hpp>
+
+namespace isis::test
+{
+
+template<typename T> data::Image makeImage( size_t xsize, size_t ysize, size_t zsize, size_t tsize = 1 )
+{
+	data::MemChunk<T> ch( xsize, ysize, zsize, tsize );
+	ch.setValueAs( "indexOrigin", util::fvector3( {0, 0, 0} ) );
+	ch.setValueAs( "rowVec", util::fvector3( {1, 0, 0} ) );
+	ch.setValueAs( "columnVec", util::fvector3( {0, 1, 0} ) );
+	ch.setValueAs( "sliceVec", util::fvector3( {0, 0, 1} ) );
+	ch.setValueAs( "voxelSize", util::fvector3( {2, 2, 2} ) );
+	ch.setValueAs( "acquisitionNumber", 0 );
+	ch.setValueAs( "sequenceNumber", 1 );
+
+	for( size_t t = 0; t < tsize; t++ )
+		for( size_t z = 0; z < zsize; z++ )
+			for( size_t y = 0; y < ysize; y++ )
+				for( size_t x = 0; x < xsize; x++ )
+					ch.template voxel<T>( x, y, z, t ) = x + y * 10 + z * 100 + t * 1000;
+
+	return data::Image( ch );
+}
+
+BOOST_AUTO_TEST_CASE( resample_linear_test )
+{
+	const data::Image src = makeImage<float>( 8, 6, 4 );
+	const data::Image dst = math::resample( src, {16, 6, 4, 1} );
+
+	BOOST_REQUIRE_EQUAL( dst.getSizeAsVector(), ( util::vector4<size_t>{16, 6, 4, 1} ) );
+	BOOST_CHECK( dst.getMajorTypeID() == util::typeID<float>() );
+	BOOST_CHECK_EQUAL( dst.getValueAs<util::fvector3>( "voxelSize" ), ( util::fvector3{1, 2, 2} ) );
+
+	for( size_t z = 0; z < 4; z++ )
+		for( size_t y = 0; y < 6; y++ )
+			for( size_t x = 0; x < 16; x++ ) {
+				const float expected = std::min( x / 2.f, 7.f ) + y * 10 + z * 100; // beyond the last voxel its value is repeated
+				BOOST_CHECK_CLOSE( dst.voxel<float>( x, y, z ), expected, 1e-4 );
+			}
+}
+
+BOOST_AUTO_TEST_CASE( resample_nearest_time_test )
+{
+	const data::Image src = makeImage<int16_t>( 4, 4, 2, 4 );
+	const data::Image dst = math::resample( src, {2, 4, 2, 2}, math::interpolation::nearest );
+
+	BOOST_REQUIRE_EQUAL( dst.getSizeAsVector(), ( util::vector4<size_t>{2, 4, 2, 2} ) );
+	BOOST_CHECK( dst.getMajorTypeID() == util::typeID<int16_t>() );
+
+	for( size_t t = 0; t < 2; t++ )
+		for( size_t z = 0; z < 2; z++ )
+			for( size_t y = 0; y < 4; y++ )
+				for( size_t x = 0; x < 2; x++ )
+					BOOST_CHECK_EQUAL( dst.voxel<int16_t>( x, y, z, t ), x * 2 + y * 10 + z * 100 + t * 2 * 1000 );
+}
+
+BOOST_AUTO_TEST_CASE( resample_large_int_test )
+{
+	// float can't represent these values, nearest neighbour must still copy them exactly
+	data::Image src = makeImage<int32_t>( 6, 5, 4 );
+	for( size_t z = 0; z < 4; z++ )
+		for( size_t y = 0; y < 5; y++ )
+			for( size_t x = 0; x < 6; x++ )
+				src.voxel<int32_t>( x, y, z ) = 1000000001 + x * 3 + y * 30 + z * 300;
+
+	const data::Image resampled = math::resample( src, {3, 5, 4, 1}, math::interpolation::nearest );
+	const data::Image rotated = math::rotate( src, {0, 1}, M_PI, true, math::interpolation::nearest ); // not axis aligned
+	BOOST_REQUIRE( resampled.getMajorTypeID() == util::typeID<int32_t>() );
+	BOOST_REQUIRE( rotated.getMajorTypeID() == util::typeID<int32_t>() );
+
+	for( size_t z = 0; z < 4; z++ )
+		for( size_t y = 0; y < 5; y++ )
+			for( size_t x = 0; x < 6; x++ ) {
+				if( x < 3 )
+					BOOST_CHECK_EQUAL( resampled.voxel<int32_t>( x, y, z ), src.voxel<int32_t>( x * 2, y, z ) );
+				BOOST_CHECK_EQUAL( rotated.voxel<int32_t>( x, y, z ), src.voxel<int32_t>( 5 - x, 4 - y, z ) );
+			}
+}
+
+BOOST_AUTO_TEST_CASE( resample_interpolating_test )
+{
+	// bspline and sinc interpolate, so every second voxel of an upsampled image hits the original values
+	data::Image src = makeImage<float>( 12, 10, 3 );
+	src.voxel<float>( 5, 5, 1 ) = 500; // make it less smooth
+
+	for( const auto method : {math::interpolation::bspline, math::interpolation::sinc} ) {
+		const data::Image dst = math::resample( src, {24, 20, 3, 1}, method );
+
+		for( size_t z = 0; z < 3; z++ )
+			for( size_t y = 0; y < 10; y++ )
+				for( size_t x = 0; x < 12; x++ )
+					BOOST_CHECK_SMALL( dst.voxel<float>( x * 2, y * 2, z ) - src.voxel<float>( x, y, z ), 1e-2f );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( rotate_test )
+{
+	const size_t size = 7;
+	const data::Image src = makeImage<int32_t>( size, size, 2 );
+
+	for( const auto method : {math::interpolation::nearest, math::interpolation::linear, math::interpolation::sinc} ) {
+		const data::Image dst = math::rotate( src, {0, 1}, M_PI / 2, true, method );
+		BOOST_REQUIRE_EQUAL( dst.getSizeAsVector(), src.getSizeAsVector() );
+		BOOST_CHECK_EQUAL( dst.getValueAs<util::fvector3>( "rowVec" ), src.getValueAs<util::fvector3>( "rowVec" ) );
+
+		// the content is rotated from x towards y around the image center
+		for( size_t z = 0; z < 2; z++ )
+			for( size_t y = 0; y < size; y++ )
+				for( size_t x = 0; x < size; x++ )
+					BOOST_CHECK_EQUAL( dst.voxel<int32_t>( x, y, z ), src.voxel<int32_t>( y, size - 1 - x, z ) );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( translate_test )
+{
+	const data::Image src = makeImage<uint16_t>( 6, 5, 4 );
+	const data::Image dst = math::translate( src, {2, 0, -4} ); // one voxel along x, two against z
+
+	for( size_t z = 0; z < 4; z++ )
+		for( size_t y = 0; y < 5; y++ )
+			for( size_t x = 0; x < 6; x++ ) {
+				if( x == 5 || z < 2 ) // outside of the source
+					BOOST_CHECK_EQUAL( dst.voxel<uint16_t>( x, y, z ), 0 );
+				else
+					BOOST_CHECK_EQUAL( dst.voxel<uint16_t>( x, y, z ), src.voxel<uint16_t>( x + 1, y, z - 2 ) );
+			}
+}
+
+}
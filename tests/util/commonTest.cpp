@@ -63,4 +63,20 @@ BOOST_AUTO_TEST_CASE( string_to_list_test )
 	BOOST_CHECK_EQUAL(util::stringToList<std::string>("Hello\rthere\nworld  (how are you)"s,std::regex("[[.newline.][.carriage-return.]]")),multiline);
 }
 
+BOOST_AUTO_TEST_CASE( parallel_for_test )
+{
+	std::vector<int> done( 1000, 0 );
+	util::parallelFor( done.size(), [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; i++ )
+			done[i]++;
+	} );
+	BOOST_CHECK( std::all_of( done.begin(), done.end(), []( int d ) {return d == 1;} ) ); // every index is done exactly once
+
+	// exceptions thrown by op are passed on, no matter which thread ran into it
+	BOOST_CHECK_THROW( util::parallelFor( done.size(), []( size_t begin, size_t end ) {
+		if( begin <= 999 && 999 < end )
+			throw std::out_of_range( "the end" );
+	} ), std::out_of_range );
+}
+
 }
@@ -0,0 +1,62 @@
+#define BOOST_TEST_MODULE HashTest
+#define NOMINMAX 1
+#include <boost/test/unit_test.hpp>
+#include <isis/core/hash.hpp>
+#include <isis/core/propmap.hpp>
+
+namespace isis::test
+{
+
+BOOST_AUTO_TEST_CASE( xxh64_test )
+{
+	// reference values of XXH64 with seed 0
+	BOOST_CHECK_EQUAL( util::Hasher().digest(), "ef46db3751d8e999" );
+	BOOST_CHECK_EQUAL( util::Hasher().update( "abc", 3 ).digest(), "44bc2cf5ad770999" );
+
+	// the result does not depend on how the data is fed
+	std::string data;
+
+	for( int i = 0; i < 1000; i++ )
+		data += char( i * 7 );
+
+	const std::string whole = util::Hasher().update( data.data(), data.size() ).digest();
+	util::Hasher pieces;
+
+	for( size_t i = 0, len = 1; i < data.size(); i += len, len = len * 3 % 37 + 1 )
+		pieces.update( data.data() + i, std::min( len, data.size() - i ) );
+
+	BOOST_CHECK_EQUAL( pieces.digest(), whole );
+	data[500]++;
+	BOOST_CHECK_NE( util::Hasher().update( data.data(), data.size() ).digest(), whole );
+}
+
+BOOST_AUTO_TEST_CASE( sha256_test )
+{
+	if( util::Hasher::isAvailable( util::Hasher::sha256 ) ) {
+		BOOST_CHECK_EQUAL(
+			util::Hasher( util::Hasher::sha256 ).update( "abc", 3 ).digest(),
+			"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"
+		);
+	} else
+		BOOST_CHECK_THROW( util::Hasher( util::Hasher::sha256 ), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( property_hash_test )
+{
+	util::PropertyMap map1, map2;
+	map1.setValueAs( "a/b", 1 );
+	map1.setValueAs( "c", std::string( "text" ) );
+	map1.setValueAs( "d", 2.5 );
+	map2.setValueAs( "d", 2.5 );
+	map2.setValueAs( "c", std::string( "text" ) );
+	map2.setValueAs( "a/b", 1 );
+
+	BOOST_CHECK_EQUAL( map1.propertyHash(), map2.propertyHash() );
+
+	map2.setValueAs( "d", 3.5 );
+	BOOST_CHECK_NE( map1.propertyHash(), map2.propertyHash() );
+	BOOST_CHECK_EQUAL( map1.propertyHash( {"a/b", "c"} ), map2.propertyHash( {"a/b", "c"} ) );
+	BOOST_CHECK_NE( map1.propertyHash( {"a/b", "c"} ), map1.propertyHash( {"a/b", "c", "e"} ) ); // a missing property changes the hash
+}
+
+}
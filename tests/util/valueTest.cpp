@@ -18,6 +18,7 @@
 #include <isis/core/value.hpp>
 #include <isis/core/vector.hpp>
 #include <chrono>
+#include <iomanip>
 #include <boost/numeric/conversion/converter.hpp>
 
 #include <complex>
@@ -262,15 +263,8 @@ BOOST_AUTO_TEST_CASE( time_conversion_test )
 {
 	util::timestamp the_day_after(std::chrono::hours(24)+std::chrono::milliseconds(1));
 	
-	std::time_t current_time;
-	std::time(&current_time);
-	struct std::tm *timeinfo = std::localtime(&current_time);
-	
-	// strings are parsed in local time - so we need an offset
-	BOOST_CHECK_EQUAL(
-		util::Value("19700102000000.001"s).as<util::timestamp>(),
-		the_day_after-std::chrono::seconds(timeinfo->tm_gmtoff)+std::chrono::hours(timeinfo->tm_isdst)
-	);
+	// strings are parsed as they are (no timezone)
+	BOOST_CHECK_EQUAL(util::Value("19700102000000.001"s).as<util::timestamp>(), the_day_after);
 	
 	BOOST_CHECK_EQUAL(util::Value("19700102"s).as<util::date>(), util::date()+std::chrono::days(1));
 
@@ -289,4 +283,76 @@ BOOST_AUTO_TEST_CASE( time_conversion_test )
 	}
 }
 
+BOOST_AUTO_TEST_CASE( time_parser_test )
+{
+	using namespace std::chrono;
+	const util::date sep25 = sys_days( year( 2001 ) / 9 / 25 );
+	const util::timestamp afternoon = sep25 + hours( 15 ) + minutes( 9 ) + seconds( 18 );
+
+	for( const char *str : {"20010925", "2001-09-25", "2001.09.25", "010925", "25.09.2001", " 20010925 "} )
+		BOOST_CHECK_EQUAL( util::parseDate( str ).value_or( util::date() ), sep25 );
+
+	for( const char *str : {
+		"20010925150918", "20010925150918&+0200", "20010925T150918", "2001-09-25T15:09:18", "25.09.2001 15:09:18",
+		"15:09:18 25 Sep 2001", "20010925150918.000000 "
+	} )
+		BOOST_CHECK_EQUAL( util::parseTimestamp( str ).value_or( util::timestamp() ), afternoon );
+
+	BOOST_CHECK_EQUAL( util::parseTimestamp( "20010925" ).value_or( util::timestamp() ), util::timestamp( sep25 ) );
+	BOOST_CHECK_EQUAL( util::parseTimestamp( "20010925 1509" ).value_or( util::timestamp() ), sep25 + hours( 15 ) + minutes( 9 ) );
+	BOOST_CHECK_EQUAL( util::parseTimestamp( "150918.123456" ).value_or( util::timestamp() ), util::timestamp( hours( 15 ) + minutes( 9 ) + seconds( 18 ) + microseconds( 123456 ) ) );
+	BOOST_CHECK_EQUAL( util::parseTimestamp( "7:05:00" ).value_or( util::timestamp() ), util::timestamp( hours( 7 ) + minutes( 5 ) ) );
+
+	// bare numbers which might as well be a year, and trailing garbage
+	for( const char *str : {
+		"", "2001", "1509", "15", "20010231", "20011325", "256000", "25:00:00", "yesterday",
+		"150918x", "150918.", "15:09:18 +", "20010925150918Z", "20010925150918&", "2001-09-25T", "20010925 junk", "15:09:18 25 Sep 2001 x"
+	} )
+		BOOST_CHECK_MESSAGE( !util::parseTimestamp( str ), '"' << str << "\" is no timestamp" );
+	for( const char *str : {
+		"", "2001", "1509", "20010231", "20011325", "2001-9-25", "25.09.01", "2001-09-25 12", "20010925x", "2001-09-25T", "25.09.2001."
+	} )
+		BOOST_CHECK_MESSAGE( !util::parseDate( str ), '"' << str << "\" is no date" );
+
+	// the results of the old locale based conversion (as it was in UTC)
+	std::tm t = {0, 0, 0, 1, 0, 70, 0, 0, -1, 0, nullptr};
+	std::istringstream ss( "20010925150918" );
+	ss >> std::get_time( &t, "%Y%m%d%H%M%S" );
+	BOOST_REQUIRE( !ss.fail() );
+	BOOST_CHECK_EQUAL( util::Value( "20010925150918"s ).as<util::timestamp>(), util::timestamp( system_clock::from_time_t( timegm( &t ) ) ) );
+
+	BOOST_CHECK_EQUAL( util::Value( "01:00:30"s ).as<util::duration>(), hours( 1 ) + seconds( 30 ) );
+	BOOST_CHECK_EQUAL( util::Value( "1000"s ).as<util::duration>(), util::duration( 1000 ) );
+}
+
+BOOST_AUTO_TEST_CASE( number_parser_test )
+{
+	// round trip through strings compared to the stream based conversion
+	for( double value : {0., 1.5, -1.25e-7, 3.14159265358979, 1e300, 123456789., -0.1} ) {
+		std::ostringstream ref;
+		ref << value;
+		BOOST_CHECK_EQUAL( Value( value ).as<std::string>(), ref.str() );
+		BOOST_CHECK_EQUAL( Value( ref.str() ).as<double>(), std::stod( ref.str() ) );
+	}
+	for( float value : {0.f, 1.5f, -3.25f, 1e-20f} ) {
+		std::ostringstream ref;
+		ref << value;
+		BOOST_CHECK_EQUAL( Value( value ).as<std::string>(), ref.str() );
+	}
+	for( int64_t value : {int64_t( 0 ), int64_t( -42 ), std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::lowest()} ) {
+		BOOST_CHECK_EQUAL( Value( value ).as<std::string>(), std::to_string( value ) );
+		BOOST_CHECK_EQUAL( Value( std::to_string( value ) ).as<int64_t>(), value ); // does not go through double
+	}
+	BOOST_CHECK_EQUAL( Value( std::numeric_limits<uint64_t>::max() ).as<std::string>(), std::to_string( std::numeric_limits<uint64_t>::max() ) );
+	BOOST_CHECK_EQUAL( Value( true ).as<std::string>(), "1" );
+
+	// like std::stod leading whitespace and "+" are skipped, text behind the number is ignored
+	BOOST_CHECK_EQUAL( Value( " +12.5"s ).as<float>(), 12.5f );
+	BOOST_CHECK_EQUAL( Value( "3mm"s ).as<int16_t>(), 3 );
+	BOOST_CHECK_EQUAL( Value( "2.6"s ).as<int16_t>(), 3 ); // rounded
+	BOOST_CHECK_EQUAL( Value( "1e3"s ).as<int32_t>(), 1000 );
+	BOOST_CHECK_EQUAL( Value( "-1"s ).as<int8_t>(), -1 );
+	BOOST_CHECK_EQUAL( Value( "abc"s ).as<int32_t>(), 0 ); // failed
+}
+
 }
@@ -103,7 +103,7 @@ std::list<data::Image> findFitting( const data::Image& reference, std::list<data
 	return images;
 }
 
-bool diff( const data::Image &img1, const data::Image &img2, const util::slist &ignore )
+bool diff( const data::Image &img1, const data::Image &img2, const util::slist &ignore, double abs_eps, double rel_eps )
 {
 	bool ret = false;
 	util::PropertyMap::DiffMap diff = img1.getDifference( img2 );
@@ -128,12 +128,23 @@ bool diff( const data::Image &img1, const data::Image &img2, const util::slist &
 				<< img1.getSizeAsString() << "/" << img2.getSizeAsString() << std::endl;
 		ret = true;
 	} else {
-		size_t voxels = img1.compare( img2 );
+		// No shortcut through Image::contentHash here. Equal hashes don't prove equal voxels. Differing hashes only show that
+		// the bytes differ (which they also do for equal values of different types), and the statistics below need the full
+		// comparison anyway. ValueArray::diff already skips identical parts with memcmp.
+		const data::DiffStats stats = img1.diff( img2, abs_eps, rel_eps );
 
-		if ( voxels != 0 ) {
-			std::cout << voxels * 100. / img1.getVolume() << "% of the voxels in " << std::endl << name1 << " and " << std::endl << name2 << " differ" << std::endl;
+		if ( stats.differing != 0 ) {
+			std::cout << stats.differing * 100. / img1.getVolume() << "% of the voxels in " << std::endl << name1 << " and " << std::endl << name2 << " differ" << std::endl;
+
+			if( stats.worst != data::DiffStats::npos )
+				std::cout
+						<< "max abs error: " << stats.max_abs << " at " << img1.getCoordsFromLinIndex( stats.worst )
+						<< ", max rel error: " << stats.max_rel << ", rms error: " << stats.rms() << std::endl;
+
+			std::cout << "first difference at " << img1.getCoordsFromLinIndex( stats.first ) << std::endl;
 			ret = true;
-		}
+		} else
+			LOG_IF( stats.worst != data::DiffStats::npos, DiffLog, info ) << "All voxels are within the tolerance, the max abs error is " << stats.max_abs;
 	}
 
 	return ret;
@@ -162,6 +173,14 @@ int main( int argc, char *argv[] )
 	app.parameters["selectwith"].setNeeded(false);
 	app.parameters["selectwith"].setDescription( "List of properties which should be used to select images for comparison" );
 	
+	app.parameters["abseps"] = 0.;
+	app.parameters["abseps"].setNeeded(false);
+	app.parameters["abseps"].setDescription( "Absolute difference up to which voxel values are considered equal" );
+
+	app.parameters["releps"] = 0.;
+	app.parameters["releps"].setNeeded(false);
+	app.parameters["releps"].setDescription( "Difference relative to the bigger magnitude up to which voxel values are considered equal" );
+
 	app.parameters["np"] = false;
 	app.parameters["np"].setNeeded(false);
 	app.parameters["np"].setDescription( "suppress progress bar" );
@@ -179,6 +198,9 @@ int main( int argc, char *argv[] )
 	app.addExample( "-in1 dicom_dataset:3 -in2 :4",
 					"Check for differences between the third and the fourth image found in a directory of DICOM files." );
 
+	app.addExample( "-in1 result.nii -in2 reference.nii -abseps 1e-5 -releps 1e-6",
+					"Check if the voxel values of a computed result match a reference within floating point tolerances." );
+
 	if ( ! app.init( argc, argv ) ) return 1;
 
 	std::pair<std::string, int > in1, in2;
@@ -196,6 +218,7 @@ int main( int argc, char *argv[] )
 	size_t ret = 0;
 	std::list<data::Image> images1, images2;
 	util::slist ignore = app.parameters["ignore"];
+	const double abs_eps = app.parameters["abseps"], rel_eps = app.parameters["releps"];
 	ignore.push_back( "source" );
 	auto feedback = std::make_shared<util::ConsoleProgressBar>();
 
@@ -214,7 +237,7 @@ int main( int argc, char *argv[] )
 
 		LOG( DiffLog, info ) << "Comparing single images " << first.identify() << " and " << second.identify();
 
-		if( diff( first, second, ignore ) )
+		if( diff( first, second, ignore, abs_eps, rel_eps ) )
 			ret = 1;
 
 	} else if( in1.second <= 0 && in2.second <= 0 ) {
@@ -240,7 +263,7 @@ int main( int argc, char *argv[] )
 					<< ". " << candidates.size() << " where found";
 
 			for( const data::Image & second :  candidates ) {
-				if( diff( *first, second, ignore ) )
+				if( diff( *first, second, ignore, abs_eps, rel_eps ) )
 					ret++;
 			}
 
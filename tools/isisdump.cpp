@@ -27,6 +27,7 @@ int main( int argc, char *argv[] )
 	std::cout.fill( '0' );
 	for( const data::Image & ref :  app.images ) {
 		std::cout << "======Image #" << std::setw( imageDigits )  << ++count1 << std::setw( 0 ) << " " << ref.getSizeAsString() << " (" << ref.identify( false ) << ") ======" << std::endl;
+		std::cout << "content hash: " << ref.contentHash() << ", metadata hash: " << ref.propertyHash() << std::endl;
 		ref.print( std::cout, true );
 		int count2 = 0;
 
@@ -38,6 +39,7 @@ int main( int argc, char *argv[] )
 						<< "======Image #" << std::setw( imageDigits )  << count1 << std::setw( 0 )
 						<< "==Chunk #" << std::setw( chunkDigits )  << ++count2 << std::setw( 0 ) << " "
 						<< c.getSizeAsString() << "(" << c.typeName() << ")" << "======Metadata======" << std::endl;
+				std::cout << "content hash: " << c.hash() << ", metadata hash: " << c.propertyHash() << std::endl;
 				c.print( std::cout, true );
 			}
 		}
@@ -4,34 +4,6 @@
 
 using namespace isis;
 
-bool swapProperties( data::Image &image, const unsigned short dim )
-{
-	const util::vector4<size_t> size = image.getSizeAsVector();
-	std::vector<data::Chunk> chunks = image.copyChunksToVector( true );
-
-	if( chunks.front().getRelevantDims() < 2 && dim >= chunks.front().getRelevantDims() ) {
-		LOG( data::Runtime, error ) << "Your data is spliced at dimension " << chunks.front().getRelevantDims()
-									<< " and you trying to flip at dimenstion " << dim << ". Sorry but this has not yet been impleneted.";
-		return false;
-	}
-
-	std::vector<data::Chunk> buffer = chunks;
-	std::vector<data::Chunk> swapped_chunks;
-
-	for( util::ivector4::value_type one_above_dim = 0; one_above_dim < size[dim + 1]; one_above_dim++ ) {
-		util::ivector4::value_type reverse_count = size[dim] - 1;
-
-		for( util::ivector4::value_type count = 0; count < size[dim]; count++, reverse_count-- ) {
-			static_cast<util::PropertyMap &>( chunks[count] ) = static_cast<util::PropertyMap &>( buffer[reverse_count] );
-		}
-	}
-
-	std::list<data::Chunk> chunk_list( chunks.begin(), chunks.end() );
-	image = data::Image( chunk_list );
-	return true;
-}
-
-
 int main( int argc, char **argv )
 {
 	ENABLE_LOG( data::Runtime, util::DefaultMsgPrint, error );
@@ -55,9 +27,6 @@ int main( int argc, char **argv )
 	unsigned int dim = alongMap[app.parameters["along"].toString()];
 	//go through every image
 	for( data::Image & refImage :  app.images ) {
-		std::vector< data::Chunk > delme = refImage.copyChunksToVector( true );
-		isis::data::Image dummy( delme );
-
 		//make an identity matrix
 		auto T = util::identityMatrix<float,3>();
 
@@ -69,18 +38,7 @@ int main( int argc, char **argv )
 		data::Image newImage = refImage;
 
 		if ( app.parameters["flip"].toString() == "image" || app.parameters["flip"].toString() == "both" ) {
-			if( refImage.getChunkAt(0).getRelevantDims() > dim ) {
-				refImage.foreachChunk( 
-					[dim]( data::Chunk &ch, util::vector4<size_t> /*posInImage*/ ) {
-						ch.flipAlong( (data::dimensions)dim );
-						return true;
-					}
-				);
-			} else {
-				if( !swapProperties( refImage, dim ) ) {
-					return EXIT_FAILURE;
-				}
-			}
+			refImage.flipAlong( static_cast<data::dimensions>( dim ) );
 		}
 
 		if ( app.parameters["flip"].toString() == "both" || app.parameters["flip"].toString() == "space" ) {
@@ -1,12 +1,11 @@
-#include <data/io_application.hpp>
-#include <Filter/BasicFilter/GaussianFilter.hpp>
-#include <Filter/BasicFilter/common.hpp>
+#include <isis/core/io_application.hpp>
+#include <isis/math/filter.hpp>
 
 using namespace isis;
 
 int main( int argc, char **argv )
 {
-	data::IOApplication app( "isis gaussian kernel", true, true );
+	data::IOApplication app( "isis gaussian kernel" );
 	app.addExample( "-in myFile.nii -out myFileFiltered.nii -sigma 1.5", "Simple gaussian filter with sigma 1.5 applied to an image." );
 	app.addExample( "-in myFile.nii -out myFileFiltered.nii -fwhm 5.25", "Simple gaussian filter with fwhm 5.25 applied to an image." );
 
@@ -22,17 +21,32 @@ int main( int argc, char **argv )
 	app.parameters["physicalSpace"].setNeeded(false);
 	app.parameters["physicalSpace"].setDescription( "Specifies whether the parameters \"sigma\" or \"fwhm\" are interpreted as mm or voxels." );
 
-	app.init( argc, argv );
+	// must be in the order of math::gauss_method
+	app.parameters["method"] = util::Selection( {"auto", "fir", "recursive"}, "auto" );
+	app.parameters["method"].setNeeded(false);
+	app.parameters["method"].setDescription( "Use a sampled kernel (fir) or the recursive approximation, auto uses the later for sigma above 3 voxels." );
 
-	filter::GaussianFilter gaussFilter;
-	gaussFilter.setParameters( app.parameters );
-	data::Image image = app.fetchImage();
+	app.addLogging<math::Runtime>("Math");
+	app.addLogging<math::Debug>("Math");
 
+	app.init( argc, argv );
 
-	if( gaussFilter.run( image ) ) {
-		app.autowrite( image );
-		return EXIT_SUCCESS;
-	} else {
+	const float sigma = app.parameters["sigma"], fwhm = app.parameters["fwhm"];
+	if( std::isnan( sigma ) == std::isnan( fwhm ) ) {
+		std::cerr << "Exactly one of the parameters \"sigma\" and \"fwhm\" must be given" << std::endl;
 		return EXIT_FAILURE;
 	}
-}
\ No newline at end of file
+
+	const double s = std::isnan( sigma ) ? math::fwhm2sigma( fwhm ) : sigma;
+	const auto method = static_cast<math::gauss_method>( static_cast<unsigned short>( util::Selection( app.parameters["method"] ) ) );
+	std::list<data::Image> output;
+
+	while( app.images.size() ) {
+		data::Image image = app.fetchImage();
+		math::gaussian( image, {s, s, s}, app.parameters["physicalSpace"], method );
+		output.push_back( image );
+	}
+
+	app.autowrite( output );
+	return EXIT_SUCCESS;
+}
@@ -1,60 +1,48 @@
 #include <isis/core/io_application.hpp>
-#include <boost/accumulators/statistics/variance.hpp>
-#include <boost/accumulators/accumulators.hpp>
-#include <boost/accumulators/statistics.hpp>
-#include <boost/progress.hpp>
+#include <isis/math/reduce.hpp>
 
 
 struct StatLog   {static constexpr char name[]="Stat";      static constexpr bool use = _ENABLE_LOG;};
 struct StatDebug {static constexpr char name[]="StatDebug"; static constexpr bool use = _ENABLE_DEBUG;};
 
-using namespace boost::accumulators;
 using namespace isis;
 
 int main( int argc, char *argv[] )
 {
 	data::IOApplication app("isisstat");
-	
+
 	app.parameters["dim"]=util::Selection({"row","column","slice","time"},"time");
+	app.parameters["dim"].setDescription( "dimension along which the statistic is computed" );
+
+	// must be in the order of math::reduction
+	app.parameters["stat"]=util::Selection({"sum","mean","variance","stddev","min","max","median","percentile","tsnr"},"stddev");
+	app.parameters["stat"].setDescription( "statistic to compute" );
+
+	app.parameters["percentile"]=50.;
+	app.parameters["percentile"].setNeeded(false);
+	app.parameters["percentile"].setDescription( "percentile to compute if stat is \"percentile\"" );
 
-	app.addExample( "-in my_file.nii -out /tmp/raw.file -repn u8bit", "Write the image data of a nifti file in a u8bit raw file" );
-	app.addExample( "-in raw.file -read_repn s16bit -out new_image.nii -rawdims 384 384 12 -offset 500", "Read 384*384*12 s16bit blocks from a raw file skipping 500 bytes and store them as a nifti image." );
+	app.addLogging<StatLog>("");
+	app.addLogging<StatDebug>("");
+	app.addLogging<math::Runtime>("Math");
+	app.addLogging<math::Debug>("Math");
+
+	app.addExample( "-in fmri.nii -out tstd.nii", "Compute the temporal standard deviation of each voxel of an fMRI run." );
+	app.addExample( "-in fmri.nii -out tsnr.nii -stat tsnr", "Compute the temporal signal to noise ratio of each voxel of an fMRI run." );
+	app.addExample( "-in anatomy.nii -out mip.nii -dim slice -stat max", "Compute the maximum intensity projection across the slices of an image." );
 
 	app.init( argc, argv, true ); // if there is a problem, we just get no images and exit cleanly
 	std::list<data::Image> output;
 
+	const util::Selection dim_sel = app.parameters["dim"], stat_sel = app.parameters["stat"];
+	const auto dim = static_cast<data::dimensions>( static_cast<unsigned short>( dim_sel ) );
+	const auto stat = static_cast<math::reduction>( static_cast<unsigned short>( stat_sel ) );
+	const double percentile = app.parameters["percentile"];
+
 	while(app.images.size()){
-		//extract image
-		auto img=app.fetchImageAs<float>(false);
-		auto size = img.getSizeAsVector();
-		data::MemChunk<float> dest(size[0],size[1],size[2]);
-		static_cast<util::PropertyMap&>(dest)=img;
-		
-		boost::progress_display progress(size[0]*size[1]*size[2],std::clog << "Computing sum of squares for " << img.identify());
-		
-		//set up all the dimensions to traverse trough (aka. all dims except the one we do the statistics accross)
-		std::vector<unsigned short> traverse_dims={0,1,2,3};
-		unsigned short stat_dim=app.parameters["dim"].as<unsigned short>()-1;
-		traverse_dims.erase(traverse_dims.begin()+stat_dim);
-		
-		for(size_t x=0;x<size[traverse_dims[0]];x++)
-			for(size_t y=0;y<size[traverse_dims[1]];y++)
-				for(size_t z=0;z<size[traverse_dims[2]];z++)
-				{
-					accumulator_set<float, stats<tag::variance> > acc;
-					for(size_t t=0;t<size[stat_dim];t++){
-						std::array<size_t,4> pos;
-						pos[traverse_dims[0]]=x;
-						pos[traverse_dims[1]]=y;
-						pos[traverse_dims[2]]=z;
-						pos[stat_dim]=t;
-						acc(img.voxel<float>(pos[0],pos[1],pos[2],pos[3]));
-					}
-					dest.voxel<float>(x,y,z)=std::sqrt(variance(acc));
-					++progress;
-				}
-					
-		output.push_back(data::Image(dest));
+		const data::Image img=app.fetchImage();
+		LOG( StatLog, notice ) << "Computing the " << std::string( stat_sel ) << " of " << img.identify() << " along its " << std::string( dim_sel ) << "s";
+		output.push_back( math::reduce( img, dim, stat, percentile ) );
 	}
 	app.autowrite(output);
 
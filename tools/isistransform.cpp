@@ -1,12 +1,11 @@
 #include <isis/core/io_application.hpp>
 #include <isis/core/io_factory.hpp>
 #include <isis/math/transform.hpp>
+#include <isis/math/resample.hpp>
 #include <isis/core/common.hpp>
 #include <regex>
 #include <cctype>
 
-#include <isis/adapter/itk4/common.hpp>
-
 #include <map>
 #include <boost/assign.hpp>
 
@@ -15,16 +14,6 @@ using namespace isis;
 struct TransformLog   {static constexpr char name[]="Transform";      static constexpr bool use = _ENABLE_LOG;};
 struct TransformDebug {static constexpr char name[]="TransformDebug"; static constexpr bool use = _ENABLE_DEBUG;};
 
-class : public data::ChunkOp
-{
-public:
-	data::dimensions dim;
-	bool operator()( data::Chunk &ch, util::vector4<size_t> /*posInImage*/ ) {
-		ch.flipAlong( dim );
-		return true;
-	}
-} flifu;
-
 int getDimFromStr(std::string s){
 	int ret;
 	if(std::tolower(s[0])=='t')
@@ -65,8 +54,7 @@ bool swapProperties( data::Image &image, const unsigned short dim )
 void flipDim(data::Image &refImage, int dim){
 	if(refImage.getChunkAt(0).getRelevantDims() > dim ) {//dimension to flip is inside the chunks (so flip them)
 		LOG(TransformLog,notice) << "flipping voxels along dim " << std::string(1,'x'+dim)  << " in " << refImage.identify();
-		flifu.dim = static_cast<data::dimensions>( dim );
-		refImage.foreachChunk( flifu );
+		refImage.foreachChunk( [dim]( data::Chunk &ch ) {ch.flipAlong( static_cast<data::dimensions>( dim ) );} );
 	} else { // otherwhise just flip the Chunks positions
 		LOG(TransformLog,notice) << "flipping chunk order along dim " << std::string(1,'x'+dim)  << " in " << refImage.identify();
 		if( !swapProperties( refImage, dim ) ) {
@@ -95,12 +83,16 @@ int main( int argc, char **argv )
 	
 	app.parameters["pix_center"]=false;
 	app.parameters["pix_center"].setNeeded(false);
+
+	app.parameters["interpolation"]=util::Selection({"nearest","linear","bspline","sinc"},"linear");
+	app.parameters["interpolation"].setNeeded(false);
+	app.parameters["interpolation"].setDescription("interpolation used for resample, rotate and translate");
 	
 	app.addLogging<TransformLog>("");
 	app.addLogging<TransformDebug>("");
 	
-	app.addLogging<ITKLog>("ITK");
-	app.addLogging<ITKDebug>("ITK");
+	app.addLogging<math::Runtime>("Math");
+	app.addLogging<math::Debug>("Math");
 	
 	app.init( argc, argv );
 	
@@ -146,6 +138,8 @@ int main( int argc, char **argv )
 		}
 	}
 
+	const auto interpolation = static_cast<math::interpolation>(static_cast<unsigned short>(app.parameters["interpolation"].as<util::Selection>()));
+
 	std::list<std::pair<std::string,std::string>> swapper;
 	for(std::string cmd:app.parameters["swapdim"].as<util::slist>()){
 		static const std::regex cmd_regex("([xyzt]-?)(:([xyzt]-?))?",std::regex_constants::icase);
@@ -179,7 +173,7 @@ int main( int argc, char **argv )
 			}
 		}
 		if(app.parameters["translate"].isParsed()){
-			refImage=itk4::translate(refImage,app.parameters["translate"]);
+			refImage=math::translate(refImage,app.parameters["translate"],interpolation);
 		}
 		if(app.parameters["resample"].isParsed()){
 			util::vector4<size_t> oldsize=refImage.getSizeAsVector(),newsize;
@@ -188,10 +182,10 @@ int main( int argc, char **argv )
 				newsize[i]=(reqsize[i]!=-1)?
 					reqsize[i]:oldsize[i];
 			}
-			refImage=itk4::resample(refImage,newsize);
+			refImage=math::resample(refImage,newsize,interpolation);
 		}
 		if(rotate_angle){
-			refImage=itk4::rotate(refImage,rotate_plane,rotate_angle, app.parameters["pix_center"]);
+			refImage=math::rotate(refImage,rotate_plane,rotate_angle, app.parameters["pix_center"],interpolation);
 		}
 	}
 	app.autowrite( app.images );
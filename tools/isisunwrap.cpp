@@ -7,38 +7,18 @@ int main( int argc, char **argv )
 	data::IOApplication app( "isis unwrap");
 	
 	app.parameters["dim"]=util::Selection({"row", "column", "slice", "time"},"time");
-// 	app.parameters["pos"]=0;
-// 	app.parameters["pos"].setNeeded(false);
+	app.parameters["dim"].setDescription( "dimension to unwrap along" );
+	app.parameters["shift"]=0;
+	app.parameters["shift"].setNeeded(false);
+	app.parameters["shift"].setDescription( "amount of voxels to shift the data along dim (half of its size if 0)" );
 
 	app.init( argc, argv ); // will exit if there is a problem
-	
-	//set up all the dimensions to traverse trough (aka. all dims except the one we do the statistics accross)
-	std::vector<unsigned short> traverse_dims={0,1,2,3};
-	auto wrap_dim=static_cast<unsigned short>(app.parameters["dim"].as<util::Selection>());
-	traverse_dims.erase(traverse_dims.begin()+wrap_dim);
 
+	const auto wrap_dim=static_cast<data::dimensions>(static_cast<unsigned short>(app.parameters["dim"].as<util::Selection>()));
+	const int shift=app.parameters["shift"];
 
 	for(data::Image &i:app.images){
-		auto size = i.getSizeAsVector();
-
-		for(size_t x=0;x<size[traverse_dims[0]];x++)
-			for(size_t y=0;y<size[traverse_dims[1]];y++)
-				for(size_t z=0;z<size[traverse_dims[2]];z++)
-				{
-					for(size_t t=0;t<size[wrap_dim]/2;t++){
-						std::array<size_t,4> pos,swap;
-						pos[traverse_dims[0]]=x;
-						pos[traverse_dims[1]]=y;
-						pos[traverse_dims[2]]=z;
-						pos[wrap_dim]=t;
-						swap=pos;
-						swap[wrap_dim]=t+size[wrap_dim]/2;
-						std::swap(
-							i.voxel<int16_t>(pos[0],pos[1],pos[2],pos[3]),
-							i.voxel<int16_t>(swap[0],swap[1],swap[2],swap[3])
-						);
-					}
-				}
+		i.rollAlong( wrap_dim, shift ? shift : i.getDimSize( wrap_dim ) / 2 );
 	}
 
 // 	app.addExample( "-in myFile.nii -out myFile.v", "Simple conversion from a nifti file to a vista file." );